@@ -0,0 +1,35 @@
+#!/bin/sh
+#
+# Run avdeccbench over a veth pair for a range of fleet sizes and print one CSV line per run.
+# Needs root for the veth pair and the raw sockets.
+#
+# Usage: run_bench.sh [path/to/avdeccbench] [extra avdeccbench options]
+
+set -e
+
+BENCH=${1:-./avdeccbench}
+[ $# -gt 0 ] && shift
+SIZES=${SIZES:-"1 10 100 500 1000 2000"}
+
+if [ "$(id -u)" -ne 0 ]; then
+    echo "run_bench.sh must be run as root" >&2
+    exit 1
+fi
+
+cleanup()
+{
+    ip link del avbbench0 2>/dev/null || true
+}
+trap cleanup EXIT
+
+cleanup
+ip link add avbbench0 type veth peer name avbbench1
+ip link set avbbench0 up
+ip link set avbbench1 up
+# The controller only lists interfaces with an IPv4 address
+ip addr add 169.254.222.1/30 dev avbbench0
+
+echo "entities,streams,clusters,enumeration_ms,aecp_cmds_per_sec,aecp_p50_us,aecp_p99_us,aecp_timeouts,acmp_cmds_per_sec,acmp_p50_us,acmp_p99_us,acmp_timeouts,rss_kb,peak_rss_kb"
+for n in $SIZES; do
+    "$BENCH" -i avbbench0 -p avbbench1 -n "$n" "$@" | sed -n 's/^csv: //p'
+done
@@ -0,0 +1,458 @@
+/*
+ * Licensed under the MIT License (MIT)
+ *
+ * Copyright (c) 2014 AudioScience Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * bench_main.cpp
+ *
+ * Controller benchmark. Starts a simulated entity fleet on one end of a veth pair, runs the
+ * controller on the other end and reports enumeration time, AECP and ACMP command throughput
+ * and latency, and memory use.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <inttypes.h>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <algorithm>
+#include <set>
+#include <vector>
+
+#include "enumeration.h"
+#include "net_interface.h"
+#include "system.h"
+#include "controller.h"
+#include "end_station.h"
+#include "entity_descriptor.h"
+#include "configuration_descriptor.h"
+#include "stream_input_descriptor.h"
+#include "fake_entity_fleet.h"
+
+#define STALL_TIMEOUT_MS 10000
+
+enum bench_phase
+{
+    PHASE_AECP,
+    PHASE_ACMP
+};
+
+struct phase_result
+{
+    uint32_t issued;
+    uint32_t completed;
+    uint32_t timeouts;
+    double cmds_per_sec;
+    double p50_us;
+    double p99_us;
+};
+
+static struct
+{
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    uint32_t entity_count;
+    std::set<uint64_t> enumerated;
+    uint64_t enumerated_ns;
+
+    uintptr_t id_base; // Notification id of the first command in the current phase
+    std::vector<uint64_t> sent_ns;
+    std::vector<uint64_t> latency_ns;
+    std::vector<bool> timed_out;
+    uint32_t outstanding;
+    uint32_t completed;
+    uint32_t timeouts;
+} bench;
+
+static uint64_t monotonic_ns()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+static void deadline_after_ms(struct timespec &ts, uint32_t ms)
+{
+    clock_gettime(CLOCK_REALTIME, &ts);
+    ts.tv_sec += ms / 1000;
+    ts.tv_nsec += (long)(ms % 1000) * 1000000;
+    if (ts.tv_nsec >= 1000000000)
+    {
+        ts.tv_sec++;
+        ts.tv_nsec -= 1000000000;
+    }
+}
+
+extern "C" void notification_callback(void *user_obj, int32_t notification_type, uint64_t entity_id, uint16_t cmd_type,
+                                      uint16_t desc_type, uint16_t desc_index, uint32_t cmd_status, void *notification_id)
+{
+    pthread_mutex_lock(&bench.lock);
+
+    if (notification_type == avdecc_lib::END_STATION_READ_COMPLETED)
+    {
+        if (bench.enumerated.insert(entity_id).second && (bench.enumerated.size() == bench.entity_count))
+        {
+            bench.enumerated_ns = monotonic_ns();
+            pthread_cond_broadcast(&bench.cond);
+        }
+    }
+    else if ((notification_type == avdecc_lib::RESPONSE_RECEIVED) || (notification_type == avdecc_lib::COMMAND_TIMEOUT))
+    {
+        uintptr_t id = (uintptr_t)notification_id;
+
+        if ((id >= bench.id_base) && (id - bench.id_base < bench.sent_ns.size()))
+        {
+            size_t i = id - bench.id_base;
+
+            if (bench.sent_ns[i] && !bench.latency_ns[i] && !bench.timed_out[i])
+            {
+                if (notification_type == avdecc_lib::COMMAND_TIMEOUT)
+                {
+                    bench.timed_out[i] = true;
+                    bench.timeouts++;
+                }
+                else
+                {
+                    bench.latency_ns[i] = std::max<uint64_t>(monotonic_ns() - bench.sent_ns[i], 1);
+                }
+                bench.outstanding--;
+                bench.completed++;
+                pthread_cond_broadcast(&bench.cond);
+            }
+        }
+    }
+
+    pthread_mutex_unlock(&bench.lock);
+}
+
+extern "C" void log_callback(void *user_obj, int32_t log_level, const char *log_msg, int32_t time_stamp_ms)
+{
+    fprintf(stderr, "[LOG] %s\n", log_msg);
+}
+
+static long read_proc_status_kb(const char *field)
+{
+    FILE *f = fopen("/proc/self/status", "r");
+    char line[256];
+    long value = -1;
+    size_t field_len = strlen(field);
+
+    if (!f)
+        return -1;
+
+    while (fgets(line, sizeof(line), f))
+    {
+        if ((strncmp(line, field, field_len) == 0) && (line[field_len] == ':'))
+        {
+            value = strtol(line + field_len + 1, NULL, 10);
+            break;
+        }
+    }
+
+    fclose(f);
+    return value;
+}
+
+static int select_interface(avdecc_lib::net_interface *netif, const char *ifname)
+{
+    size_t ifname_len = strlen(ifname);
+
+    for (uint32_t i = 0; i < netif->devs_count(); i++)
+    {
+        const char *desc = netif->get_dev_desc_by_index(i);
+
+        // Linux device descriptions are "<name>, address: ..."
+        if (desc && (strncmp(desc, ifname, ifname_len) == 0) && ((desc[ifname_len] == ',') || (desc[ifname_len] == '\0')))
+        {
+            return netif->select_interface_by_num(i + 1);
+        }
+    }
+
+    fprintf(stderr, "Interface %s not found (it needs an IPv4 address to be listed)\n", ifname);
+    return -1;
+}
+
+static bool wait_for_enumeration(uint32_t timeout_ms)
+{
+    struct timespec deadline;
+    bool done;
+
+    deadline_after_ms(deadline, timeout_ms);
+    pthread_mutex_lock(&bench.lock);
+    while ((bench.enumerated.size() < bench.entity_count) &&
+           (pthread_cond_timedwait(&bench.cond, &bench.lock, &deadline) != ETIMEDOUT))
+    {
+    }
+    done = (bench.enumerated.size() == bench.entity_count);
+    pthread_mutex_unlock(&bench.lock);
+
+    return done;
+}
+
+static int issue_command(bench_phase phase, avdecc_lib::controller *controller_obj, fake_entity_fleet &fleet,
+                         uint32_t cmd_index, void *notification_id)
+{
+    uint32_t entity_index = cmd_index % bench.entity_count;
+    avdecc_lib::end_station *end_station = controller_obj->get_end_station_by_entity_id(fleet.entity_id(entity_index));
+
+    if (!end_station)
+        return -1;
+
+    if (phase == PHASE_AECP)
+    {
+        return end_station->send_read_desc_cmd(notification_id, avdecc_lib::AEM_DESC_ENTITY, 0);
+    }
+
+    avdecc_lib::entity_descriptor *entity = end_station->get_entity_desc_by_index(0);
+    avdecc_lib::configuration_descriptor *configuration = entity ? entity->get_config_desc_by_index(0) : NULL;
+    avdecc_lib::stream_input_descriptor *stream_input = configuration ? configuration->get_stream_input_desc_by_index(0) : NULL;
+
+    if (!stream_input)
+        return -1;
+
+    uint64_t talker_id = fleet.entity_id((entity_index + 1) % bench.entity_count);
+    return stream_input->send_connect_rx_cmd(notification_id, talker_id, 0, 0);
+}
+
+static double percentile_us(std::vector<uint64_t> &sorted_ns, double p)
+{
+    if (sorted_ns.empty())
+        return 0.0;
+
+    size_t i = std::min(sorted_ns.size() - 1, (size_t)(p * sorted_ns.size()));
+    return sorted_ns[i] / 1000.0;
+}
+
+/**
+ * Issue cmd_count commands round robin across the fleet, keeping at most window commands
+ * outstanding, and wait for every response or timeout.
+ */
+static phase_result run_phase(bench_phase phase, avdecc_lib::controller *controller_obj, fake_entity_fleet &fleet,
+                              uint32_t cmd_count, uint32_t window)
+{
+    phase_result result;
+    struct timespec deadline;
+    bool stalled = false;
+
+    memset(&result, 0, sizeof(result));
+
+    pthread_mutex_lock(&bench.lock);
+    bench.id_base += bench.sent_ns.size();
+    bench.sent_ns.assign(cmd_count, 0);
+    bench.latency_ns.assign(cmd_count, 0);
+    bench.timed_out.assign(cmd_count, false);
+    bench.outstanding = 0;
+    bench.completed = 0;
+    bench.timeouts = 0;
+    pthread_mutex_unlock(&bench.lock);
+
+    uint64_t start_ns = monotonic_ns();
+
+    for (uint32_t i = 0; (i < cmd_count) && !stalled; i++)
+    {
+        pthread_mutex_lock(&bench.lock);
+        deadline_after_ms(deadline, STALL_TIMEOUT_MS);
+        while ((bench.outstanding >= window) && !stalled)
+        {
+            stalled = (pthread_cond_timedwait(&bench.cond, &bench.lock, &deadline) == ETIMEDOUT);
+        }
+        if (!stalled)
+        {
+            bench.outstanding++;
+            bench.sent_ns[i] = monotonic_ns();
+        }
+        pthread_mutex_unlock(&bench.lock);
+
+        if (stalled)
+            break;
+
+        if (issue_command(phase, controller_obj, fleet, i, (void *)(bench.id_base + i)) < 0)
+        {
+            pthread_mutex_lock(&bench.lock);
+            bench.outstanding--;
+            bench.sent_ns[i] = 0;
+            pthread_mutex_unlock(&bench.lock);
+            continue;
+        }
+        result.issued++;
+    }
+
+    pthread_mutex_lock(&bench.lock);
+    deadline_after_ms(deadline, STALL_TIMEOUT_MS);
+    while ((bench.outstanding > 0) && (pthread_cond_timedwait(&bench.cond, &bench.lock, &deadline) != ETIMEDOUT))
+    {
+    }
+    uint64_t elapsed_ns = monotonic_ns() - start_ns;
+
+    std::vector<uint64_t> sorted_ns;
+    for (size_t i = 0; i < bench.latency_ns.size(); i++)
+    {
+        if (bench.latency_ns[i])
+            sorted_ns.push_back(bench.latency_ns[i]);
+    }
+    result.completed = bench.completed;
+    result.timeouts = bench.timeouts;
+    pthread_mutex_unlock(&bench.lock);
+
+    std::sort(sorted_ns.begin(), sorted_ns.end());
+    result.cmds_per_sec = elapsed_ns ? (sorted_ns.size() * 1e9 / elapsed_ns) : 0.0;
+    result.p50_us = percentile_us(sorted_ns, 0.50);
+    result.p99_us = percentile_us(sorted_ns, 0.99);
+
+    if (stalled || (result.completed < result.issued))
+    {
+        fprintf(stderr, "%s phase stalled: %u of %u commands completed\n",
+                (phase == PHASE_AECP) ? "AECP" : "ACMP", result.completed, result.issued);
+    }
+
+    return result;
+}
+
+static void print_phase(const char *name, const phase_result &r)
+{
+    printf("%s: %u commands, %.0f cmds/sec, p50 %.1f us, p99 %.1f us, %u timeouts\n",
+           name, r.issued, r.cmds_per_sec, r.p50_us, r.p99_us, r.timeouts);
+}
+
+static void usage(const char *argv0)
+{
+    fprintf(stderr,
+            "Usage: %s [options]\n"
+            "  -i <iface>   controller interface (default avbbench0)\n"
+            "  -p <iface>   simulated fleet interface (default avbbench1)\n"
+            "  -n <count>   number of simulated entities (default 10)\n"
+            "  -s <count>   streams per direction per entity (default 2)\n"
+            "  -k <count>   audio clusters per stream port (default 8)\n"
+            "  -m <count>   commands per phase (default 10000)\n"
+            "  -w <count>   outstanding commands per phase (default 32)\n"
+            "  -d <us>      fleet response delay in microseconds (default 0)\n"
+            "  -t <sec>     enumeration timeout in seconds (default 120)\n",
+            argv0);
+}
+
+int main(int argc, char *argv[])
+{
+    const char *controller_ifname = "avbbench0";
+    const char *fleet_ifname = "avbbench1";
+    fake_entity_fleet::config cfg = {10, 2, 8, 0};
+    uint32_t cmd_count = 10000;
+    uint32_t window = 32;
+    uint32_t enumeration_timeout_s = 120;
+    int c;
+
+    while ((c = getopt(argc, argv, "i:p:n:s:k:m:w:d:t:h")) != -1)
+    {
+        switch (c)
+        {
+            case 'i': controller_ifname = optarg; break;
+            case 'p': fleet_ifname = optarg; break;
+            case 'n': cfg.entity_count = strtoul(optarg, NULL, 0); break;
+            case 's': cfg.stream_count = strtoul(optarg, NULL, 0); break;
+            case 'k': cfg.cluster_count = strtoul(optarg, NULL, 0); break;
+            case 'm': cmd_count = strtoul(optarg, NULL, 0); break;
+            case 'w': window = strtoul(optarg, NULL, 0); break;
+            case 'd': cfg.response_delay_us = strtoul(optarg, NULL, 0); break;
+            case 't': enumeration_timeout_s = strtoul(optarg, NULL, 0); break;
+            default:
+                usage(argv[0]);
+                return 1;
+        }
+    }
+
+    // An AUDIO_MAP with one mapping per cluster has to fit in a single frame
+    if ((cfg.entity_count == 0) || (window == 0) || (cfg.cluster_count > 128))
+    {
+        usage(argv[0]);
+        return 1;
+    }
+
+    pthread_mutex_init(&bench.lock, NULL);
+    pthread_cond_init(&bench.cond, NULL);
+    bench.entity_count = cfg.entity_count;
+    bench.id_base = 1;
+
+    fake_entity_fleet fleet(cfg);
+    if (fleet.start(fleet_ifname) < 0)
+        return 1;
+
+    avdecc_lib::net_interface *netif = avdecc_lib::create_net_interface();
+    if (select_interface(netif, controller_ifname) < 0)
+    {
+        netif->destroy();
+        return 1;
+    }
+
+    avdecc_lib::controller *controller_obj = avdecc_lib::create_controller(netif, notification_callback, log_callback,
+                                                                           avdecc_lib::LOGGING_LEVEL_ERROR);
+    avdecc_lib::system *sys = avdecc_lib::create_system(avdecc_lib::system::LAYER2_MULTITHREADED_CALLBACK, netif, controller_obj);
+
+    uint64_t start_ns = monotonic_ns();
+    sys->process_start();
+
+    bool enumerated = wait_for_enumeration(enumeration_timeout_s * 1000);
+    double enumeration_ms = enumerated ? (bench.enumerated_ns - start_ns) / 1e6 : -1.0;
+    long enumeration_rss_kb = read_proc_status_kb("VmRSS");
+
+    printf("entities: %u, streams: %u, clusters: %u\n", cfg.entity_count, cfg.stream_count, cfg.cluster_count);
+    if (enumerated)
+        printf("enumeration: %.1f ms, rss %ld kB\n", enumeration_ms, enumeration_rss_kb);
+    else
+        printf("enumeration: timed out with %zu of %u entities read\n", bench.enumerated.size(), cfg.entity_count);
+
+    phase_result aecp;
+    phase_result acmp;
+    memset(&aecp, 0, sizeof(aecp));
+    memset(&acmp, 0, sizeof(acmp));
+
+    if (enumerated)
+    {
+        aecp = run_phase(PHASE_AECP, controller_obj, fleet, cmd_count, window);
+        print_phase("aecp read_descriptor", aecp);
+
+        acmp = run_phase(PHASE_ACMP, controller_obj, fleet, cmd_count, window);
+        print_phase("acmp connect_rx", acmp);
+    }
+
+    long rss_kb = read_proc_status_kb("VmRSS");
+    long peak_rss_kb = read_proc_status_kb("VmHWM");
+    printf("memory: rss %ld kB, peak %ld kB\n", rss_kb, peak_rss_kb);
+    printf("frames: fleet rx %" PRIu64 ", fleet tx %" PRIu64 ", missed notifications %u\n",
+           fleet.rx_frame_count(), fleet.tx_frame_count(), controller_obj->missed_notification_count());
+
+    printf("csv: %u,%u,%u,%.1f,%.0f,%.1f,%.1f,%u,%.0f,%.1f,%.1f,%u,%ld,%ld\n",
+           cfg.entity_count, cfg.stream_count, cfg.cluster_count, enumeration_ms,
+           aecp.cmds_per_sec, aecp.p50_us, aecp.p99_us, aecp.timeouts,
+           acmp.cmds_per_sec, acmp.p50_us, acmp.p99_us, acmp.timeouts,
+           rss_kb, peak_rss_kb);
+
+    sys->process_close();
+    fleet.stop();
+    sys->destroy();
+    controller_obj->destroy();
+    netif->destroy();
+
+    return enumerated ? 0 : 2;
+}
@@ -0,0 +1,597 @@
+/*
+ * Licensed under the MIT License (MIT)
+ *
+ * Copyright (c) 2014 AudioScience Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * fake_entity_fleet.cpp
+ *
+ * Simulated AVDECC entity fleet implementation. Every entity has the same entity model:
+ * one configuration with an AUDIO_UNIT, stream_count STREAM_INPUTs and STREAM_OUTPUTs, one
+ * STREAM_PORT of each direction with cluster_count AUDIO_CLUSTERs and an AUDIO_MAP each, and
+ * the usual AVB_INTERFACE, CLOCK_SOURCE, CLOCK_DOMAIN, LOCALE and STRINGS descriptors.
+ * Descriptors are laid out as in IEEE 1722.1-2013 clause 7.2.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <poll.h>
+#include <net/if.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+#include <netpacket/packet.h>
+
+#include "enumeration.h"
+#include "jdksavdecc.h"
+#include "fake_entity_fleet.h"
+
+#define ENTITY_ID_BASE UINT64_C(0x0001f2fffe000000)
+#define ENTITY_MAC_BASE UINT64_C(0x020000000000) // Locally administered
+#define ENTITY_MODEL_ID UINT64_C(0x0001f20000bec400)
+#define STREAM_FORMAT UINT64_C(0x00a0020240000800) // IEC 61883-6 AM824, 48 kHz, 8 channels
+
+static uint64_t monotonic_ms()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+static void set_mac(uint8_t *p, uint64_t mac)
+{
+    for (int i = 0; i < 6; i++)
+    {
+        p[i] = (uint8_t)(mac >> (40 - 8 * i));
+    }
+}
+
+fake_entity_fleet::fake_entity_fleet(const config &c)
+{
+    cfg = c;
+    sock = -1;
+    running = false;
+    available_index = 0;
+    rx_frames = 0;
+    tx_frames = 0;
+}
+
+fake_entity_fleet::~fake_entity_fleet()
+{
+    stop();
+}
+
+int fake_entity_fleet::start(const char *ifname)
+{
+    struct sockaddr_ll sll;
+    struct packet_mreq mreq;
+    int ifindex = if_nametoindex(ifname);
+
+    if (ifindex == 0)
+    {
+        fprintf(stderr, "Unknown interface %s\n", ifname);
+        return -1;
+    }
+
+    sock = socket(AF_PACKET, SOCK_RAW, htons(JDKSAVDECC_AVTP_ETHERTYPE));
+    if (sock < 0)
+    {
+        fprintf(stderr, "Socket open failed! %s\nuse sudo?\n", strerror(errno));
+        return -1;
+    }
+
+    memset(&sll, 0, sizeof(sll));
+    sll.sll_family = AF_PACKET;
+    sll.sll_protocol = htons(JDKSAVDECC_AVTP_ETHERTYPE);
+    sll.sll_ifindex = ifindex;
+    if (bind(sock, (struct sockaddr *)&sll, sizeof(sll)) < 0)
+    {
+        fprintf(stderr, "Socket bind failed! %s\n", strerror(errno));
+        close(sock);
+        sock = -1;
+        return -1;
+    }
+
+    // Receive frames for every simulated entity MAC
+    memset(&mreq, 0, sizeof(mreq));
+    mreq.mr_ifindex = ifindex;
+    mreq.mr_type = PACKET_MR_PROMISC;
+    setsockopt(sock, SOL_PACKET, PACKET_ADD_MEMBERSHIP, &mreq, sizeof(mreq));
+
+    running = true;
+    if (pthread_create(&thread, NULL, &thread_fn, this) != 0)
+    {
+        running = false;
+        close(sock);
+        sock = -1;
+        return -1;
+    }
+
+    return 0;
+}
+
+void fake_entity_fleet::stop()
+{
+    if (running)
+    {
+        running = false;
+        pthread_join(thread, NULL);
+    }
+
+    if (sock >= 0)
+    {
+        close(sock);
+        sock = -1;
+    }
+}
+
+uint64_t fake_entity_fleet::entity_id(uint32_t entity_index) const
+{
+    return ENTITY_ID_BASE + entity_index + 1;
+}
+
+uint64_t fake_entity_fleet::entity_model_id() const
+{
+    return ENTITY_MODEL_ID;
+}
+
+uint64_t fake_entity_fleet::entity_mac(uint32_t entity_index) const
+{
+    return ENTITY_MAC_BASE + entity_index + 1;
+}
+
+bool fake_entity_fleet::entity_index_from_id(uint64_t id, uint32_t &entity_index) const
+{
+    if ((id <= ENTITY_ID_BASE) || (id > ENTITY_ID_BASE + cfg.entity_count))
+    {
+        return false;
+    }
+
+    entity_index = (uint32_t)(id - ENTITY_ID_BASE - 1);
+    return true;
+}
+
+void *fake_entity_fleet::thread_fn(void *p)
+{
+    ((fake_entity_fleet *)p)->run();
+    return NULL;
+}
+
+void fake_entity_fleet::run()
+{
+    uint8_t frame[FRAME_SIZE];
+    struct pollfd pfd;
+    uint64_t next_advertise_ms = 0;
+
+    pfd.fd = sock;
+    pfd.events = POLLIN;
+
+    while (running)
+    {
+        uint64_t now_ms = monotonic_ms();
+
+        if (now_ms >= next_advertise_ms)
+        {
+            advertise_all();
+            next_advertise_ms = now_ms + ADVERTISE_INTERVAL_MS;
+        }
+
+        if (poll(&pfd, 1, 100) <= 0)
+        {
+            continue;
+        }
+
+        for (;;)
+        {
+            struct sockaddr_ll from;
+            socklen_t from_len = sizeof(from);
+            ssize_t frame_len = recvfrom(sock, frame, sizeof(frame), MSG_DONTWAIT, (struct sockaddr *)&from, &from_len);
+
+            if (frame_len <= 0)
+            {
+                break;
+            }
+
+            if ((from.sll_pkttype == PACKET_OUTGOING) || (frame_len < avdecc_lib::ETHER_HDR_SIZE + JDKSAVDECC_COMMON_CONTROL_HEADER_LEN))
+            {
+                continue;
+            }
+
+            rx_frames++;
+            handle_frame(frame, frame_len);
+        }
+    }
+}
+
+void fake_entity_fleet::handle_frame(const uint8_t *frame, size_t frame_len)
+{
+    switch (jdksavdecc_common_control_header_get_subtype(frame, avdecc_lib::ETHER_HDR_SIZE))
+    {
+        case JDKSAVDECC_SUBTYPE_ADP:
+            handle_adp(frame, frame_len);
+            break;
+
+        case JDKSAVDECC_SUBTYPE_AECP:
+            handle_aecp(frame, frame_len);
+            break;
+
+        case JDKSAVDECC_SUBTYPE_ACMP:
+            handle_acmp(frame, frame_len);
+            break;
+    }
+}
+
+void fake_entity_fleet::advertise(uint32_t entity_index)
+{
+    uint8_t frame[FRAME_SIZE];
+    struct jdksavdecc_adpdu adpdu;
+
+    memset(frame, 0, sizeof(frame));
+    memcpy(&frame[0], jdksavdecc_multicast_adp_acmp.value, 6);
+    set_mac(&frame[6], entity_mac(entity_index));
+    jdksavdecc_uint16_set(JDKSAVDECC_AVTP_ETHERTYPE, frame, 12);
+
+    memset(&adpdu, 0, sizeof(adpdu));
+    adpdu.header.cd = 1;
+    adpdu.header.subtype = JDKSAVDECC_SUBTYPE_ADP;
+    adpdu.header.message_type = JDKSAVDECC_ADP_MESSAGE_TYPE_ENTITY_AVAILABLE;
+    adpdu.header.valid_time = VALID_TIME;
+    adpdu.header.control_data_length = JDKSAVDECC_ADPDU_LEN - JDKSAVDECC_COMMON_CONTROL_HEADER_LEN;
+    jdksavdecc_uint64_write(entity_id(entity_index), &adpdu.header.entity_id, 0, sizeof(uint64_t));
+    jdksavdecc_uint64_write(entity_model_id(), &adpdu.entity_model_id, 0, sizeof(uint64_t));
+    adpdu.entity_capabilities = JDKSAVDECC_ADP_ENTITY_CAPABILITY_AEM_SUPPORTED;
+    adpdu.talker_stream_sources = cfg.stream_count;
+    adpdu.talker_capabilities = JDKSAVDECC_ADP_TALKER_CAPABILITY_IMPLEMENTED | JDKSAVDECC_ADP_TALKER_CAPABILITY_AUDIO_SOURCE;
+    adpdu.listener_stream_sinks = cfg.stream_count;
+    adpdu.listener_capabilities = JDKSAVDECC_ADP_LISTENER_CAPABILITY_IMPLEMENTED | JDKSAVDECC_ADP_LISTENER_CAPABILITY_AUDIO_SINK;
+    adpdu.available_index = available_index;
+    jdksavdecc_adpdu_write(&adpdu, frame, avdecc_lib::ETHER_HDR_SIZE, sizeof(frame));
+
+    send_frame(frame, avdecc_lib::ETHER_HDR_SIZE + JDKSAVDECC_ADPDU_LEN);
+}
+
+void fake_entity_fleet::advertise_all()
+{
+    for (uint32_t i = 0; i < cfg.entity_count; i++)
+    {
+        advertise(i);
+    }
+
+    available_index++;
+}
+
+void fake_entity_fleet::handle_adp(const uint8_t *frame, size_t frame_len)
+{
+    uint32_t entity_index;
+
+    if (jdksavdecc_common_control_header_get_control_data(frame, avdecc_lib::ETHER_HDR_SIZE) != JDKSAVDECC_ADP_MESSAGE_TYPE_ENTITY_DISCOVER)
+    {
+        return;
+    }
+
+    struct jdksavdecc_eui64 id = jdksavdecc_common_control_header_get_stream_id(frame, avdecc_lib::ETHER_HDR_SIZE);
+    uint64_t target = jdksavdecc_eui64_convert_to_uint64(&id);
+
+    if (target == 0)
+    {
+        advertise_all();
+    }
+    else if (entity_index_from_id(target, entity_index))
+    {
+        advertise(entity_index);
+    }
+}
+
+void fake_entity_fleet::handle_aecp(const uint8_t *frame, size_t frame_len)
+{
+    uint8_t rsp[FRAME_SIZE];
+    size_t rsp_len = frame_len;
+    uint8_t status = JDKSAVDECC_AEM_STATUS_SUCCESS;
+    uint32_t entity_index;
+
+    if ((frame_len < avdecc_lib::ETHER_HDR_SIZE + JDKSAVDECC_AECPDU_AEM_LEN) || (frame_len > sizeof(rsp)) ||
+        (jdksavdecc_common_control_header_get_control_data(frame, avdecc_lib::ETHER_HDR_SIZE) != JDKSAVDECC_AECP_MESSAGE_TYPE_AEM_COMMAND))
+    {
+        return;
+    }
+
+    struct jdksavdecc_eui64 id = jdksavdecc_common_control_header_get_stream_id(frame, avdecc_lib::ETHER_HDR_SIZE);
+    if (!entity_index_from_id(jdksavdecc_eui64_convert_to_uint64(&id), entity_index))
+    {
+        return;
+    }
+
+    // Answer the controller from the entity MAC address
+    memcpy(rsp, frame, frame_len);
+    memcpy(&rsp[0], &frame[6], 6);
+    set_mac(&rsp[6], entity_mac(entity_index));
+
+    uint16_t cmd_type = jdksavdecc_aecpdu_aem_get_command_type(frame, avdecc_lib::ETHER_HDR_SIZE) & 0x7FFF;
+    if ((cmd_type == JDKSAVDECC_AEM_COMMAND_READ_DESCRIPTOR) &&
+        (frame_len >= avdecc_lib::ETHER_HDR_SIZE + JDKSAVDECC_AEM_COMMAND_READ_DESCRIPTOR_COMMAND_LEN))
+    {
+        uint16_t desc_type = jdksavdecc_uint16_get(frame, avdecc_lib::ETHER_HDR_SIZE + JDKSAVDECC_AEM_COMMAND_READ_DESCRIPTOR_COMMAND_OFFSET_DESCRIPTOR_TYPE);
+        uint16_t desc_index = jdksavdecc_uint16_get(frame, avdecc_lib::ETHER_HDR_SIZE + JDKSAVDECC_AEM_COMMAND_READ_DESCRIPTOR_COMMAND_OFFSET_DESCRIPTOR_INDEX);
+        size_t pos = avdecc_lib::ETHER_HDR_SIZE + JDKSAVDECC_AEM_COMMAND_READ_DESCRIPTOR_RESPONSE_LEN;
+        ssize_t desc_len = write_descriptor(entity_index, desc_type, desc_index, rsp, pos);
+
+        if (desc_len < 0)
+        {
+            status = JDKSAVDECC_AEM_STATUS_NO_SUCH_DESCRIPTOR;
+        }
+        else
+        {
+            rsp_len = pos + desc_len;
+        }
+    }
+
+    jdksavdecc_common_control_header_set_control_data(JDKSAVDECC_AECP_MESSAGE_TYPE_AEM_RESPONSE, rsp, avdecc_lib::ETHER_HDR_SIZE);
+    jdksavdecc_common_control_header_set_status(status, rsp, avdecc_lib::ETHER_HDR_SIZE);
+    jdksavdecc_common_control_header_set_control_data_length(rsp_len - avdecc_lib::ETHER_HDR_SIZE - JDKSAVDECC_COMMON_CONTROL_HEADER_LEN,
+                                                             rsp, avdecc_lib::ETHER_HDR_SIZE);
+
+    if (cfg.response_delay_us)
+    {
+        usleep(cfg.response_delay_us);
+    }
+    send_frame(rsp, rsp_len);
+}
+
+void fake_entity_fleet::handle_acmp(const uint8_t *frame, size_t frame_len)
+{
+    uint8_t rsp[FRAME_SIZE];
+    struct jdksavdecc_eui64 id;
+    uint32_t entity_index;
+
+    if ((frame_len < avdecc_lib::ETHER_HDR_SIZE + JDKSAVDECC_ACMPDU_LEN) || (frame_len > sizeof(rsp)))
+    {
+        return;
+    }
+
+    uint8_t msg_type = jdksavdecc_common_control_header_get_control_data(frame, avdecc_lib::ETHER_HDR_SIZE);
+    switch (msg_type)
+    {
+        case JDKSAVDECC_ACMP_MESSAGE_TYPE_CONNECT_TX_COMMAND:
+        case JDKSAVDECC_ACMP_MESSAGE_TYPE_DISCONNECT_TX_COMMAND:
+        case JDKSAVDECC_ACMP_MESSAGE_TYPE_GET_TX_STATE_COMMAND:
+        case JDKSAVDECC_ACMP_MESSAGE_TYPE_GET_TX_CONNECTION_COMMAND:
+            id = jdksavdecc_acmpdu_get_talker_entity_id(frame, avdecc_lib::ETHER_HDR_SIZE);
+            break;
+
+        case JDKSAVDECC_ACMP_MESSAGE_TYPE_CONNECT_RX_COMMAND:
+        case JDKSAVDECC_ACMP_MESSAGE_TYPE_DISCONNECT_RX_COMMAND:
+        case JDKSAVDECC_ACMP_MESSAGE_TYPE_GET_RX_STATE_COMMAND:
+            id = jdksavdecc_acmpdu_get_listener_entity_id(frame, avdecc_lib::ETHER_HDR_SIZE);
+            break;
+
+        default:
+            return;
+    }
+
+    if (!entity_index_from_id(jdksavdecc_eui64_convert_to_uint64(&id), entity_index))
+    {
+        return;
+    }
+
+    // ACMP responses go to the same multicast address as the commands
+    memcpy(rsp, frame, frame_len);
+    set_mac(&rsp[6], entity_mac(entity_index));
+    jdksavdecc_common_control_header_set_control_data(msg_type + 1, rsp, avdecc_lib::ETHER_HDR_SIZE);
+    jdksavdecc_common_control_header_set_status(JDKSAVDECC_ACMP_STATUS_SUCCESS, rsp, avdecc_lib::ETHER_HDR_SIZE);
+
+    if (cfg.response_delay_us)
+    {
+        usleep(cfg.response_delay_us);
+    }
+    send_frame(rsp, frame_len);
+}
+
+ssize_t fake_entity_fleet::write_descriptor(uint32_t entity_index, uint16_t desc_type, uint16_t desc_index, uint8_t *buf, size_t pos)
+{
+    uint8_t *d = buf + pos;
+    uint16_t streams = cfg.stream_count;
+    uint16_t clusters = cfg.cluster_count;
+    ssize_t len;
+
+    switch (desc_type)
+    {
+        case JDKSAVDECC_DESCRIPTOR_ENTITY:
+            if (desc_index != 0)
+                return -1;
+            len = 312;
+            memset(d, 0, len);
+            jdksavdecc_uint64_set(entity_id(entity_index), d, 4);
+            jdksavdecc_uint64_set(entity_model_id(), d, 12);
+            jdksavdecc_uint32_set(JDKSAVDECC_ADP_ENTITY_CAPABILITY_AEM_SUPPORTED, d, 20);
+            jdksavdecc_uint16_set(streams, d, 24); // talker_stream_sources
+            jdksavdecc_uint16_set(streams, d, 28); // listener_stream_sinks
+            jdksavdecc_uint32_set(available_index, d, 36);
+            snprintf((char *)d + 48, 64, "bench entity %u", entity_index);
+            snprintf((char *)d + 116, 64, "1.0");
+            jdksavdecc_uint16_set(1, d, 308); // configurations_count
+            break;
+
+        case JDKSAVDECC_DESCRIPTOR_CONFIGURATION:
+        {
+            const uint16_t counts[][2] =
+            {
+                {JDKSAVDECC_DESCRIPTOR_AUDIO_UNIT, 1},
+                {JDKSAVDECC_DESCRIPTOR_STREAM_INPUT, streams},
+                {JDKSAVDECC_DESCRIPTOR_STREAM_OUTPUT, streams},
+                {JDKSAVDECC_DESCRIPTOR_AVB_INTERFACE, 1},
+                {JDKSAVDECC_DESCRIPTOR_CLOCK_SOURCE, 1},
+                {JDKSAVDECC_DESCRIPTOR_LOCALE, 1},
+                {JDKSAVDECC_DESCRIPTOR_STRINGS, 1},
+                {JDKSAVDECC_DESCRIPTOR_STREAM_PORT_INPUT, 1},
+                {JDKSAVDECC_DESCRIPTOR_STREAM_PORT_OUTPUT, 1},
+                {JDKSAVDECC_DESCRIPTOR_AUDIO_CLUSTER, (uint16_t)(2 * clusters)},
+                {JDKSAVDECC_DESCRIPTOR_AUDIO_MAP, 2},
+                {JDKSAVDECC_DESCRIPTOR_CLOCK_DOMAIN, 1}
+            };
+            uint16_t count = 0;
+
+            if (desc_index != 0)
+                return -1;
+            memset(d, 0, 74);
+            snprintf((char *)d + 4, 64, "bench configuration");
+            for (size_t i = 0; i < sizeof(counts) / sizeof(counts[0]); i++)
+            {
+                if (counts[i][1])
+                {
+                    jdksavdecc_uint16_set(counts[i][0], d, 74 + 4 * count);
+                    jdksavdecc_uint16_set(counts[i][1], d, 74 + 4 * count + 2);
+                    count++;
+                }
+            }
+            jdksavdecc_uint16_set(count, d, 70); // descriptor_counts_count
+            jdksavdecc_uint16_set(74, d, 72); // descriptor_counts_offset
+            len = 74 + 4 * count;
+            break;
+        }
+
+        case JDKSAVDECC_DESCRIPTOR_AUDIO_UNIT:
+            if (desc_index != 0)
+                return -1;
+            len = 148;
+            memset(d, 0, len);
+            jdksavdecc_uint16_set(1, d, 72); // number_of_stream_input_ports
+            jdksavdecc_uint16_set(1, d, 76); // number_of_stream_output_ports
+            jdksavdecc_uint32_set(48000, d, 136); // current_sampling_rate
+            jdksavdecc_uint16_set(144, d, 140); // sampling_rates_offset
+            jdksavdecc_uint16_set(1, d, 142); // sampling_rates_count
+            jdksavdecc_uint32_set(48000, d, 144);
+            break;
+
+        case JDKSAVDECC_DESCRIPTOR_STREAM_INPUT:
+        case JDKSAVDECC_DESCRIPTOR_STREAM_OUTPUT:
+            if (desc_index >= streams)
+                return -1;
+            len = 140;
+            memset(d, 0, len);
+            snprintf((char *)d + 4, 64, "bench stream %u", desc_index);
+            jdksavdecc_uint64_set(STREAM_FORMAT, d, 74); // current_format
+            jdksavdecc_uint16_set(132, d, 82); // formats_offset
+            jdksavdecc_uint16_set(1, d, 84); // number_of_formats
+            jdksavdecc_uint64_set(STREAM_FORMAT, d, 132);
+            break;
+
+        case JDKSAVDECC_DESCRIPTOR_AVB_INTERFACE:
+            if (desc_index != 0)
+                return -1;
+            len = 98;
+            memset(d, 0, len);
+            set_mac(d + 70, entity_mac(entity_index));
+            jdksavdecc_uint64_set(entity_id(entity_index), d, 78); // clock_identity
+            break;
+
+        case JDKSAVDECC_DESCRIPTOR_CLOCK_SOURCE:
+            if (desc_index != 0)
+                return -1;
+            len = 86;
+            memset(d, 0, len);
+            jdksavdecc_uint64_set(entity_id(entity_index), d, 74); // clock_source_identifier
+            break;
+
+        case JDKSAVDECC_DESCRIPTOR_LOCALE:
+            if (desc_index != 0)
+                return -1;
+            len = 72;
+            memset(d, 0, len);
+            snprintf((char *)d + 4, 64, "en-US");
+            jdksavdecc_uint16_set(1, d, 68); // number_of_strings
+            break;
+
+        case JDKSAVDECC_DESCRIPTOR_STRINGS:
+            if (desc_index != 0)
+                return -1;
+            len = 452;
+            memset(d, 0, len);
+            snprintf((char *)d + 4, 64, "AVDECC bench");
+            break;
+
+        case JDKSAVDECC_DESCRIPTOR_STREAM_PORT_INPUT:
+        case JDKSAVDECC_DESCRIPTOR_STREAM_PORT_OUTPUT:
+        {
+            uint16_t port = (desc_type == JDKSAVDECC_DESCRIPTOR_STREAM_PORT_INPUT) ? 0 : 1;
+
+            if (desc_index != 0)
+                return -1;
+            len = 20;
+            memset(d, 0, len);
+            jdksavdecc_uint16_set(clusters, d, 12); // number_of_clusters
+            jdksavdecc_uint16_set(port * clusters, d, 14); // base_cluster
+            jdksavdecc_uint16_set(1, d, 16); // number_of_maps
+            jdksavdecc_uint16_set(port, d, 18); // base_map
+            break;
+        }
+
+        case JDKSAVDECC_DESCRIPTOR_AUDIO_CLUSTER:
+            if (desc_index >= 2 * clusters)
+                return -1;
+            len = 87;
+            memset(d, 0, len);
+            snprintf((char *)d + 4, 64, "bench cluster %u", desc_index);
+            jdksavdecc_uint16_set(1, d, 84); // channel_count
+            d[86] = 0x40; // MBLA
+            break;
+
+        case JDKSAVDECC_DESCRIPTOR_AUDIO_MAP:
+            if (desc_index >= 2)
+                return -1;
+            len = 8 + 8 * clusters;
+            memset(d, 0, len);
+            jdksavdecc_uint16_set(8, d, 4); // mappings_offset
+            jdksavdecc_uint16_set(clusters, d, 6); // number_of_mappings
+            for (uint16_t i = 0; i < clusters; i++)
+            {
+                jdksavdecc_uint16_set(i, d, 8 + 8 * i + 2); // stream_channel
+                jdksavdecc_uint16_set(i, d, 8 + 8 * i + 4); // cluster_offset
+            }
+            break;
+
+        case JDKSAVDECC_DESCRIPTOR_CLOCK_DOMAIN:
+            if (desc_index != 0)
+                return -1;
+            len = 78;
+            memset(d, 0, len);
+            jdksavdecc_uint16_set(76, d, 72); // clock_sources_offset
+            jdksavdecc_uint16_set(1, d, 74); // clock_sources_count
+            break;
+
+        default:
+            return -1;
+    }
+
+    jdksavdecc_uint16_set(desc_type, d, 0);
+    jdksavdecc_uint16_set(desc_index, d, 2);
+
+    return len;
+}
+
+void fake_entity_fleet::send_frame(const uint8_t *frame, size_t frame_len)
+{
+    if (send(sock, frame, frame_len, 0) == (ssize_t)frame_len)
+    {
+        tx_frames++;
+    }
+}
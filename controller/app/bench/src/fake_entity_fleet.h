@@ -0,0 +1,107 @@
+/*
+ * Licensed under the MIT License (MIT)
+ *
+ * Copyright (c) 2014 AudioScience Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * fake_entity_fleet.h
+ *
+ * A fleet of simulated AVDECC entities answering ADP, AECP and ACMP on a raw socket.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <sys/types.h>
+#include <pthread.h>
+
+class fake_entity_fleet
+{
+public:
+    struct config
+    {
+        uint32_t entity_count; // Number of entities to simulate
+        uint16_t stream_count; // STREAM_INPUT and STREAM_OUTPUT descriptors per entity
+        uint16_t cluster_count; // AUDIO_CLUSTER descriptors per stream port
+        uint32_t response_delay_us; // Added before each AECP and ACMP response
+    };
+
+    fake_entity_fleet(const config &cfg);
+    ~fake_entity_fleet();
+
+    /**
+     * Open a raw socket on the interface and start answering in a thread.
+     *
+     * \return 0 on success, -1 on failure.
+     */
+    int start(const char *ifname);
+
+    /**
+     * Stop the responder thread and close the socket.
+     */
+    void stop();
+
+    uint64_t entity_id(uint32_t entity_index) const;
+    uint64_t entity_model_id() const;
+
+    uint64_t rx_frame_count() const { return rx_frames; }
+    uint64_t tx_frame_count() const { return tx_frames; }
+
+private:
+    enum
+    {
+        FRAME_SIZE = 1536,
+        ADVERTISE_INTERVAL_MS = 10000,
+        VALID_TIME = 31 // In units of 2 seconds
+    };
+
+    config cfg;
+    int sock;
+    pthread_t thread;
+    volatile bool running;
+    uint32_t available_index;
+    uint64_t rx_frames;
+    uint64_t tx_frames;
+
+    static void *thread_fn(void *p);
+    void run();
+
+    bool entity_index_from_id(uint64_t id, uint32_t &entity_index) const;
+    uint64_t entity_mac(uint32_t entity_index) const;
+
+    void advertise(uint32_t entity_index);
+    void advertise_all();
+
+    void handle_frame(const uint8_t *frame, size_t frame_len);
+    void handle_adp(const uint8_t *frame, size_t frame_len);
+    void handle_aecp(const uint8_t *frame, size_t frame_len);
+    void handle_acmp(const uint8_t *frame, size_t frame_len);
+
+    /**
+     * Write a descriptor of the simulated entity model at pos.
+     *
+     * \return The descriptor length, or -1 if the entity has no such descriptor.
+     */
+    ssize_t write_descriptor(uint32_t entity_index, uint16_t desc_type, uint16_t desc_index, uint8_t *buf, size_t pos);
+
+    void send_frame(const uint8_t *frame, size_t frame_len);
+};
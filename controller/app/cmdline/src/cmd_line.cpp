@@ -47,6 +47,7 @@
 #include "avb_interface_descriptor.h"
 #include "clock_source_descriptor.h"
 #include "memory_object_descriptor.h"
+#include "memory_object_image.h"
 #include "locale_descriptor.h"
 #include "strings_descriptor.h"
 #include "stream_port_input_descriptor.h"
@@ -82,14 +83,17 @@ const char *const log_level_help =
 std::string cmd_line::log_path = "."; // Log to a file in the current working directory
 
 cmd_line::cmd_line()
-    : test_mode(false)
+    : secondary_netif(NULL)
+    , test_mode(false)
     , output_redirected(false)
 {}
 
 cmd_line::cmd_line(void (*notification_callback) (void *, int32_t, uint64_t, uint16_t, uint16_t, uint16_t, uint32_t, void *),
                    void (*log_callback) (void *, int32_t, const char *, int32_t),
-                   bool test_mode, char *interface, int32_t log_level)
-    : test_mode(test_mode)
+                   bool test_mode, char *interface, int32_t log_level, char *secondary_interface,
+                   uint32_t engine_shards)
+    : secondary_netif(NULL)
+    , test_mode(test_mode)
     , output_redirected(false)
 {
     cout_buf = std::cout.rdbuf();
@@ -106,6 +110,10 @@ cmd_line::cmd_line(void (*notification_callback) (void *, int32_t, uint64_t, uin
 
     atomic_cout << "AVDECC Controller version: " << controller_obj->get_version() << std::endl;
     print_interfaces_and_select(interface);
+    if (secondary_interface)
+        add_secondary_interface(secondary_interface);
+    if ((engine_shards > 1) && (sys->set_engine_shard_count(engine_shards) < 0))
+        atomic_cout << "Error: Unable to run " << engine_shards << " engine threads" << std::endl;
     sys->process_start();
 }
 
@@ -115,6 +123,8 @@ cmd_line::~cmd_line()
     sys->destroy();
     controller_obj->destroy();
     netif->destroy();
+    if (secondary_netif)
+        secondary_netif->destroy();
     ofstream_ref.close();
 }
 
@@ -173,6 +183,27 @@ int cmd_line::print_interfaces_and_select(char *interface)
     return 0;
 }
 
+int cmd_line::add_secondary_interface(char *interface)
+{
+    secondary_netif = avdecc_lib::create_net_interface();
+
+    for(uint32_t i = 1; i < secondary_netif->devs_count() + 1; i++)
+    {
+        if (strcmp(secondary_netif->get_dev_desc_by_index(i - 1), interface) == 0)
+        {
+            if ((secondary_netif->select_interface_by_num(i) == 0) &&
+                (controller_obj->add_net_interface(secondary_netif) >= 0))
+            {
+                return 0;
+            }
+            break;
+        }
+    }
+
+    atomic_cout << "Error: Unable to use " << interface << " as the secondary interface" << std::endl;
+    return 1;
+}
+
 int cmd_line::get_current_end_station(avdecc_lib::end_station **end_station) const
 {
     if (current_end_station >= controller_obj->get_end_station_count())
@@ -830,6 +861,17 @@ void cmd_line::cmd_line_commands_init()
         &cmd_line::cmd_firmware_upgrade);
     upgrade_cmd_fmt->add_argument(new cli_argument_string(this, "upgrade_image_path", "the path to the upgrade image file"));
     upgrade_cmd->add_format(upgrade_cmd_fmt);
+
+    // download
+    cli_command *download_cmd = new cli_command();
+    commands.add_sub_command("download", download_cmd);
+
+    cli_command_format *download_cmd_fmt = new cli_command_format(
+        "Read a memory object of the current end station into a file",
+        &cmd_line::cmd_memory_object_download);
+    download_cmd_fmt->add_argument(new cli_argument_int(this, "d_i", "the MEMORY_OBJECT descriptor index"));
+    download_cmd_fmt->add_argument(new cli_argument_string(this, "file_path", "the path to the file to write"));
+    download_cmd->add_format(download_cmd_fmt);
 }
 
 int cmd_line::cmd_help_all(int total_matched, std::vector<cli_argument*> args)
@@ -2364,8 +2406,9 @@ int cmd_line::cmd_disconnect_rx(int total_matched, std::vector<cli_argument*> ar
 
 int cmd_line::cmd_show_connections(int total_matched, std::vector<cli_argument*> args)
 {
-    // Use the same notification ID for all the read commands
+    // Refresh the connection graph with the state of every listener stream on the network as a single batch
     intptr_t cmd_notification_id = get_next_notification_id();
+    std::vector<avdecc_lib::bulk_cmd> cmds;
 
     for(uint32_t i = 0; i < controller_obj->get_end_station_count(); i++)
     {
@@ -2375,69 +2418,45 @@ int cmd_line::cmd_show_connections(int total_matched, std::vector<cli_argument*>
         if (get_current_entity_and_descriptor(end_station, &entity, &configuration))
             continue;
 
-        size_t stream_input_desc_count = configuration->stream_input_desc_count();
-        for(uint32_t j = 0; j < stream_input_desc_count; j++)
-        {
-            avdecc_lib::stream_input_descriptor *instream = configuration->get_stream_input_desc_by_index(j);
-            instream->send_get_rx_state_cmd((void *)cmd_notification_id);
-        }
-
-        size_t stream_output_desc_count = configuration->stream_output_desc_count();
+        avdecc_lib::bulk_cmd cmd;
+        cmd.entity_id = end_station->entity_id();
+        cmd.desc_type = 0;
 
-        for(uint32_t j = 0; j < stream_output_desc_count; j++)
+        cmd.cmd_type = avdecc_lib::bulk_cmd::BULK_CMD_GET_RX_STATE;
+        for(uint32_t j = 0; j < configuration->stream_input_desc_count(); j++)
         {
-            // Only wait when issuing the last packet
-            const bool last_command = (i == controller_obj->get_end_station_count() - 1) &&
-                                      (j == stream_output_desc_count - 1);
-            if (last_command)
-                sys->set_wait_for_next_cmd((void *)cmd_notification_id);
-            avdecc_lib::stream_output_descriptor *outstream = configuration->get_stream_output_desc_by_index(j);
-            outstream->send_get_tx_state_cmd((void *)cmd_notification_id);
-            if (last_command)
-                sys->get_last_resp_status();
+            cmd.desc_index = (uint16_t)j;
+            cmds.push_back(cmd);
         }
     }
 
-    for(uint32_t in_index = 0; in_index < controller_obj->get_end_station_count(); in_index++)
+    if(!cmds.empty())
     {
-        avdecc_lib::end_station *in_end_station = controller_obj->get_end_station_by_index(in_index);
-        avdecc_lib::entity_descriptor *in_entity;
-        avdecc_lib::configuration_descriptor *in_descriptor;
-        if (get_current_entity_and_descriptor(in_end_station, &in_entity, &in_descriptor))
-            continue;
-
-        size_t stream_input_desc_count = in_descriptor->stream_input_desc_count();
-        for(uint32_t in_stream_index = 0; in_stream_index < stream_input_desc_count; in_stream_index++)
+        sys->set_wait_for_next_cmd((void *)cmd_notification_id);
+        if(controller_obj->send_bulk_cmds((void *)cmd_notification_id, &cmds[0], cmds.size(), 1) < 0)
+        {
+            atomic_cout << "Error: Unable to send the GET_RX_STATE commands" << std::endl;
+        }
+        else
         {
-            avdecc_lib::stream_input_descriptor *instream = in_descriptor->get_stream_input_desc_by_index(in_stream_index);
-            if (!instream->get_rx_state_connection_count())
-                continue;
+            int status = sys->get_last_resp_status();
 
-            for(uint32_t out_index = 0; out_index < controller_obj->get_end_station_count(); out_index++)
-            {
-                avdecc_lib::end_station *out_end_station = controller_obj->get_end_station_by_index(out_index);
-                avdecc_lib::entity_descriptor *out_entity;
-                avdecc_lib::configuration_descriptor *out_descriptor;
-                if (get_current_entity_and_descriptor(out_end_station, &out_entity, &out_descriptor))
-                    continue;
+            // The connections learned from the other responses are still listed
+            if(status != avdecc_lib::ACMP_STATUS_SUCCESS)
+                atomic_cout << "Error: Refreshing the connections failed with status " << status << std::endl;
+        }
+    }
 
-                size_t stream_output_desc_count = out_descriptor->stream_output_desc_count();
-                for(uint32_t out_stream_index = 0; out_stream_index < stream_output_desc_count; out_stream_index++)
-                {
-                    avdecc_lib::stream_output_descriptor *outstream = out_descriptor->get_stream_output_desc_by_index(out_stream_index);
-                    if (!outstream->get_tx_state_connection_count() ||
-                        (instream->get_rx_state_stream_id() != outstream->get_tx_state_stream_id()))
-                    {
-                        continue;
-                    }
+    for(size_t i = 0; i < controller_obj->get_connection_count(); i++)
+    {
+        avdecc_lib::stream_connection connection;
+        if (controller_obj->get_connection_by_index(i, connection))
+            break;
 
-                    atomic_cout << "0x" << std::setw(16) << std::hex << std::setfill('0') << out_end_station->entity_id()
-                                << "[" << in_stream_index << "] -> "
-                                << "0x" << std::setw(16) << std::hex << std::setfill('0') << in_end_station->entity_id()
-                                << "[" << out_stream_index << "]" << std::endl;
-                }
-            }
-        }
+        atomic_cout << "0x" << std::setw(16) << std::hex << std::setfill('0') << connection.talker_entity_id
+                    << "[" << std::dec << connection.talker_unique_id << "] -> "
+                    << "0x" << std::setw(16) << std::hex << std::setfill('0') << connection.listener_entity_id
+                    << "[" << std::dec << connection.listener_unique_id << "]" << std::endl;
     }
     return 0;
 }
@@ -3198,15 +3217,18 @@ int cmd_line::cmd_stop_streaming(int total_matched, std::vector<cli_argument*> a
 int cmd_line::cmd_firmware_upgrade(int total_matched, std::vector<cli_argument*> args)
 {
     std::string image_file_path = args[0]->get_value_str();
-    std::ifstream is(image_file_path, std::ios::in|std::ios::binary);
+    avdecc_lib::memory_object_image *image = avdecc_lib::map_memory_object_image(image_file_path.c_str());
 
-    if (is.is_open())
+    if (image)
     {
         avdecc_lib::end_station *end_station;
         avdecc_lib::entity_descriptor *entity;
         avdecc_lib::configuration_descriptor *configuration;
         if (get_current_end_station_entity_and_descriptor(&end_station, &entity, &configuration))
+        {
+            image->release();
             return 0;
+        }
 
         intptr_t cmd_notification_id = get_next_notification_id();
         sys->set_wait_for_next_cmd((void *)cmd_notification_id);
@@ -3218,6 +3240,7 @@ int cmd_line::cmd_firmware_upgrade(int total_matched, std::vector<cli_argument*>
         if (status)
         {
             atomic_cout << "Error: Erase failed." << std::endl;
+            image->release();
             return 0;
         }
         else
@@ -3225,31 +3248,22 @@ int cmd_line::cmd_firmware_upgrade(int total_matched, std::vector<cli_argument*>
             atomic_cout << "Succesfully erased." << std::endl;
         }
 
-        std::streampos current = 0;
-        char buffer[256];
-        is.seekg(0, std::ios::beg);
-
-        is.read(buffer, 256);
-
-        while (is.gcount())
+        atomic_cout << "Writing " << image->length() << " bytes..." << std::endl;
+        sys->set_wait_for_next_cmd((void *)cmd_notification_id);
+        int upload_ret = memory_object_desc_ref->upload_image((void *)cmd_notification_id, image, 0);
+        image->release();
+        if (upload_ret < 0)
         {
-            sys->set_wait_for_next_cmd((void *)cmd_notification_id);
-            end_station->send_aecp_address_access_cmd((void *)cmd_notification_id,
-                                                      1,
-                                                      is.gcount(),
-                                                      int(current),
-                                                      (uint8_t *)buffer);
-            status = sys->get_last_resp_status();
-            if (status)
-            {
-                atomic_cout << "Error: Could not write TLV at address " << current << std::endl;
-                return 0;
-            }
-            current += 256;
-            is.read(buffer, 256);
+            atomic_cout << "Error: Image does not fit the memory object." << std::endl;
+            return 0;
         }
 
-        is.close();
+        status = sys->get_last_resp_status();
+        if (status)
+        {
+            atomic_cout << "Error: Upload failed with status " << status << std::endl;
+            return 0;
+        }
 
         atomic_cout << "Successfully upgraded image." << std::endl;
 
@@ -3286,6 +3300,43 @@ int cmd_line::cmd_firmware_upgrade(int total_matched, std::vector<cli_argument*>
     return 0;
 }
 
+int cmd_line::cmd_memory_object_download(int total_matched, std::vector<cli_argument*> args)
+{
+    uint16_t desc_index = args[0]->get_value_int();
+    std::string file_path = args[1]->get_value_str();
+
+    avdecc_lib::end_station *end_station;
+    avdecc_lib::entity_descriptor *entity;
+    avdecc_lib::configuration_descriptor *configuration;
+    if (get_current_end_station_entity_and_descriptor(&end_station, &entity, &configuration))
+        return 0;
+
+    avdecc_lib::memory_object_descriptor *memory_object_desc_ref = configuration->get_memory_object_desc_by_index(desc_index);
+    if (!memory_object_desc_ref)
+    {
+        atomic_cout << "Error: No MEMORY_OBJECT descriptor " << desc_index << std::endl;
+        return 0;
+    }
+
+    intptr_t cmd_notification_id = get_next_notification_id();
+    sys->set_wait_for_next_cmd((void *)cmd_notification_id);
+    if (memory_object_desc_ref->download_to_file((void *)cmd_notification_id, file_path.c_str(), 0, NULL, 0) < 0)
+    {
+        atomic_cout << "Error: Unable to download the memory object to " << file_path << std::endl;
+        return 0;
+    }
+
+    int status = sys->get_last_resp_status();
+    if (status)
+    {
+        atomic_cout << "Error: Download failed with status " << status << std::endl;
+        return 0;
+    }
+
+    atomic_cout << "Successfully downloaded " << memory_object_desc_ref->length() << " bytes to " << file_path << std::endl;
+    return 0;
+}
+
 int cmd_line::cmd_identify_on(int total_matched, std::vector<cli_argument*> args)
 {
     uint32_t end_station_index = args[0]->get_value_uint();
@@ -71,6 +71,7 @@ class cmd_line
 {
 private:
     avdecc_lib::net_interface *netif;
+    avdecc_lib::net_interface *secondary_netif; // A second network served by the same controller, or NULL
     avdecc_lib::system *sys;
     avdecc_lib::controller *controller_obj;
     
@@ -95,12 +96,18 @@ public:
      */
     cmd_line(void (*notification_callback) (void *, int32_t, uint64_t, uint16_t, uint16_t, uint16_t, uint32_t, void *),
              void (*log_callback) (void *, int32_t, const char *, int32_t),
-             bool test_mode, char *interface, int32_t log_level);
+             bool test_mode, char *interface, int32_t log_level, char *secondary_interface = NULL,
+             uint32_t engine_shards = 1);
 
     ~cmd_line();
 
 private:
     int print_interfaces_and_select(char *interface);
+
+    /**
+     * Select the interface with the name on a second network interface and add it to the controller.
+     */
+    int add_secondary_interface(char *interface);
     int get_current_end_station(avdecc_lib::end_station **end_station) const;
     int get_current_entity_and_descriptor(avdecc_lib::end_station *end_station,
         avdecc_lib::entity_descriptor **entity, avdecc_lib::configuration_descriptor **descriptor);
@@ -342,6 +349,11 @@ private:
 
     int cmd_firmware_upgrade(int total_matched, std::vector<cli_argument*> args);
 
+    /**
+     * Read a memory object of the current End Station into a file with AECP Address Access READ commands.
+     */
+    int cmd_memory_object_download(int total_matched, std::vector<cli_argument*> args);
+
     /**
      * Send a IDENTIFY command to enable identification.
      */
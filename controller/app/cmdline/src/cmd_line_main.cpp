@@ -210,9 +210,11 @@ char *null_completer(const char *text, int state)
 
 static void usage(char *argv[])
 {
-    std::cerr << "Usage: " << argv[0] << " [-d] [-i interface]" << std::endl;
+    std::cerr << "Usage: " << argv[0] << " [-d] [-i interface] [-s interface] [-e threads]" << std::endl;
     std::cerr << "  -t           :  Sets test mode which disables checks" << std::endl;
     std::cerr << "  -i interface :  Sets the name of the interface to use" << std::endl;
+    std::cerr << "  -s interface :  Sets the name of a secondary interface to also use" << std::endl;
+    std::cerr << "  -e threads   :  Sets the number of engine threads End Stations are shared across" << std::endl;
     std::cerr << "  -l log_level :  Sets the log level to use." << std::endl;
     std::cerr << log_level_help << std::endl;
     exit(1);
@@ -223,10 +225,12 @@ int main(int argc, char *argv[])
     bool test_mode = false;
     int error = 0;
     char *interface = NULL;
+    char *secondary_interface = NULL;
+    uint32_t engine_shards = 1;
     int c = 0;
     int32_t log_level = avdecc_lib::LOGGING_LEVEL_ERROR;
 
-    while ((c = getopt(argc, argv, "ti:l:")) != -1) {
+    while ((c = getopt(argc, argv, "ti:s:e:l:")) != -1) {
         switch (c) {
             case 't':
                 test_mode = true;
@@ -234,6 +238,12 @@ int main(int argc, char *argv[])
             case 'i':
                 interface = optarg;
                 break;
+            case 's':
+                secondary_interface = optarg;
+                break;
+            case 'e':
+                engine_shards = (uint32_t)atoi(optarg);
+                break;
             case 'l':
                 log_level = atoi(optarg);
                 break;
@@ -264,7 +274,7 @@ int main(int argc, char *argv[])
     }
 
     cmd_line avdecc_cmd_line_ref(notification_callback, log_callback,
-            test_mode, interface, log_level);
+            test_mode, interface, log_level, secondary_interface, engine_shards);
 
     std::vector<std::string> input_argv;
     size_t pos = 0;
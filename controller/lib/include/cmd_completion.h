@@ -0,0 +1,78 @@
+/*
+ * Licensed under the MIT License (MIT)
+ *
+ * Copyright (c) 2014 AudioScience Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * cmd_completion.h
+ *
+ * Public command completion interface class
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include "build.h"
+
+namespace avdecc_lib
+{
+    /**
+     * A completion token for one command, created with system::create_cmd_completion before the command
+     * is sent. Any number of application threads may wait on the same token.
+     */
+    class cmd_completion
+    {
+    public:
+        /**
+         * \return The notification id of the command.
+         */
+        AVDECC_CONTROLLER_LIB32_API virtual void * STDCALL notification_id() = 0;
+
+        /**
+         * \return True once the response has been received, the command has timed out or it could not be sent.
+         */
+        AVDECC_CONTROLLER_LIB32_API virtual bool STDCALL is_complete() = 0;
+
+        /**
+         * Block the calling thread until the command completes.
+         *
+         * \param timeout_ms The maximum time to wait in milliseconds, or a negative value to wait until the
+         *                   library completes the command, which it always does once the command is sent.
+         *                   If the command could not be sent, waiting on the thread that created the token
+         *                   completes it with AVDECC_LIB_STATUS_INVALID.
+         *
+         * \return 0 if the command completed, -1 if the wait timed out first.
+         */
+        AVDECC_CONTROLLER_LIB32_API virtual int STDCALL wait(int32_t timeout_ms) = 0;
+
+        /**
+         * \return The response status of the command, AVDECC_LIB_STATUS_TICK_TIMEOUT if no response was
+         *         received, or AVDECC_LIB_STATUS_INVALID if the command was not sent. Only valid once the
+         *         command is complete.
+         */
+        AVDECC_CONTROLLER_LIB32_API virtual int STDCALL get_status() = 0;
+
+        /**
+         * Release the token. Must be called exactly once, after which the token must not be used.
+         */
+        AVDECC_CONTROLLER_LIB32_API virtual void STDCALL release() = 0;
+    };
+}
@@ -40,6 +40,77 @@ namespace avdecc_lib
     class end_station;
     class configuration_descriptor;
 
+    /**
+     * A notification message as delivered to a batch notification callback. The fields match the
+     * arguments of the notification callback passed to create_controller.
+     */
+    struct notification_msg
+    {
+        int32_t notification_type;
+        uint64_t entity_id;
+        uint16_t cmd_type;
+        uint16_t desc_type;
+        uint16_t desc_index;
+        uint32_t cmd_status;
+        void *notification_id;
+    };
+
+    /**
+     * An argument of a log message as delivered to a log record callback, in the order of the
+     * conversion specifications of the message format.
+     */
+    struct log_arg
+    {
+        enum log_arg_type
+        {
+            LOG_ARG_INT,
+            LOG_ARG_UINT,
+            LOG_ARG_DOUBLE,
+            LOG_ARG_STRING,
+            LOG_ARG_POINTER
+        } type;
+
+        union
+        {
+            int64_t i;
+            uint64_t u;
+            double d;
+            const char *s;
+            const void *p;
+        } value;
+    };
+
+    /**
+     * A command submitted with controller::send_bulk_cmds.
+     */
+    struct bulk_cmd
+    {
+        enum bulk_cmd_type
+        {
+            BULK_CMD_READ_DESCRIPTOR, ///< AEM READ_DESCRIPTOR of desc_type and desc_index
+            BULK_CMD_GET_STREAM_INFO, ///< AEM GET_STREAM_INFO of the stream desc_type and desc_index
+            BULK_CMD_GET_RX_STATE, ///< ACMP GET_RX_STATE of the STREAM_INPUT desc_index
+            BULK_CMD_GET_TX_STATE ///< ACMP GET_TX_STATE of the STREAM_OUTPUT desc_index
+        } cmd_type;
+
+        uint64_t entity_id; ///< The End Station the command is sent to
+        uint16_t desc_type;
+        uint16_t desc_index;
+    };
+
+    /**
+     * A connection between a talker stream and a listener stream, as seen in ACMP responses.
+     * Streams are identified by the Entity ID and the STREAM_OUTPUT or STREAM_INPUT descriptor index.
+     */
+    struct stream_connection
+    {
+        uint64_t talker_entity_id;
+        uint16_t talker_unique_id;
+        uint64_t listener_entity_id;
+        uint16_t listener_unique_id;
+        uint64_t stream_id;
+    };
+
     class controller
     {
     public:
@@ -63,6 +134,11 @@ namespace avdecc_lib
          */
         AVDECC_CONTROLLER_LIB32_API virtual end_station * STDCALL get_end_station_by_index(size_t end_station_index) = 0;
 
+        /**
+         * \return The corresponding End Station by Entity ID, or NULL if not found.
+         */
+        AVDECC_CONTROLLER_LIB32_API virtual end_station * STDCALL get_end_station_by_entity_id(uint64_t entity_entity_id) = 0;
+
         /**
          * \return Find a endstation's index by Entity ID.
          */
@@ -88,15 +164,160 @@ namespace avdecc_lib
          */
         AVDECC_CONTROLLER_LIB32_API virtual uint32_t STDCALL missed_notification_count() = 0;
 
+        /**
+         * Set the number of notifications that may be queued for the notification callback before further
+         * ones are counted as missed. Call before starting the system layer.
+         *
+         * \return 0 on success, -1 if the system layer has already been started.
+         */
+        AVDECC_CONTROLLER_LIB32_API virtual int STDCALL set_notification_capacity(uint32_t count) = 0;
+
+        /**
+         * Deliver notifications through a callback that receives every notification queued since the previous
+         * call as one array, instead of calling the notification callback once per notification. The array is
+         * only valid for the duration of the callback. Pass NULL to restore the notification callback.
+         */
+        AVDECC_CONTROLLER_LIB32_API virtual void STDCALL set_notification_batch_callback(void (*batch_callback) (void *batch_user_obj, const struct notification_msg *msgs, uint32_t count),
+                                                                                          void *batch_user_obj) = 0;
+
         /**
          * \return The number of missed logs that exceeds the log buffer count.
          */
         AVDECC_CONTROLLER_LIB32_API virtual uint32_t STDCALL missed_log_count() = 0;
 
+        /**
+         * Receive log messages as a format string and its raw arguments. Log messages are only formatted
+         * into text when the log callback passed to create_controller is set, so an application that only
+         * wants structured records can pass a NULL log callback. The format string has static storage
+         * duration and can be used as a message identifier. The arguments are only valid for the duration
+         * of the callback. Pass NULL to stop receiving records.
+         */
+        AVDECC_CONTROLLER_LIB32_API virtual void STDCALL set_log_record_callback(void (*record_callback) (void *record_user_obj, int32_t log_level, const char *fmt,
+                                                                                                          const struct log_arg *args, uint32_t arg_count, int32_t time_stamp_ms),
+                                                                                  void *record_user_obj) = 0;
+
+        /**
+         * Set how many background READ_DESCRIPTOR commands may be outstanding while End Stations are enumerated.
+         *
+         * \param end_station_limit The maximum number of reads inflight to one End Station. The window shrinks
+         *                          below this when an End Station times out or reports NO_RESOURCES.
+         * \param total_limit The maximum number of reads inflight across all End Stations, or across the End
+         *                    Stations of each engine shard when system::set_engine_shard_count is used.
+         */
+        AVDECC_CONTROLLER_LIB32_API virtual void STDCALL set_background_read_limits(uint16_t end_station_limit, uint16_t total_limit) = 0;
+
+        /**
+         * Serve static descriptors of already known entity models from a cache file instead of reading them
+         * from each End Station, and add newly read ones to it. Call before starting the system layer.
+         * Only LOCALE, STRINGS, STREAM_PORT, EXTERNAL_PORT and AUDIO_MAP descriptors are cached. Descriptors
+         * that carry per-entity identifiers, names or current settings, such as ENTITY, CONFIGURATION,
+         * STREAM_INPUT and CLOCK_DOMAIN, are still read from every End Station.
+         *
+         * \param path The cache file, created if it does not exist.
+         *
+         * \return 0 on success, -1 if the cache file cannot be used.
+         */
+        AVDECC_CONTROLLER_LIB32_API virtual int STDCALL enable_descriptor_cache(const char *path) = 0;
+
+        /**
+         * Register every End Station for unsolicited notifications once it has been enumerated, which is
+         * the default. Unsolicited responses are applied to the descriptors of the End Station and notified
+         * as UNSOLICITED_RESPONSE_RECEIVED, so stream formats, sampling rates, clock sources and names stay
+         * current without polling. A registration that is lost or rejected because the End Station is busy
+         * is resent a few times with a growing delay, one rejected with any other status is not resent.
+         */
+        AVDECC_CONTROLLER_LIB32_API virtual void STDCALL enable_unsolicited_notifications(bool enable) = 0;
+
+        /**
+         * Serve another network, such as the secondary network of a redundant pair, from the same
+         * controller. Call with an interface selected with select_interface_by_num before starting the
+         * system layer, which then receives on every interface. Only the Linux system layer receives on
+         * more than one interface.
+         *
+         * End Stations seen on several networks are merged by Entity ID. Commands to an End Station are
+         * sent on the interface it was first discovered on, and move to another interface once it has
+         * stopped advertising on its own for its valid time. ENTITY_DISCOVER is sent on every interface.
+         *
+         * \return The index of the interface, the one the controller was created with being 0, or -1 if
+         *         the interface is not usable or has already been added.
+         */
+        AVDECC_CONTROLLER_LIB32_API virtual int STDCALL add_net_interface(net_interface *netif) = 0;
+
+        /**
+         * \return The index of the network interface commands to the End Station are sent on, or -1 if the
+         *         End Station has not been discovered.
+         */
+        AVDECC_CONTROLLER_LIB32_API virtual int STDCALL get_end_station_net_interface(uint64_t entity_entity_id) = 0;
+
         /**
          * Send a CONTROLLER_AVAILABLE command to verify that the AVDECC Controller is still there.
          */
         AVDECC_CONTROLLER_LIB32_API virtual int STDCALL send_controller_avail_cmd(void *notification_id, uint32_t end_station_index) = 0;
+
+        /**
+         * Send a batch of commands to any number of End Stations in a single hand-off to the system layer.
+         * The commands to each End Station are sent in order, with at most entity_limit of them inflight
+         * to it at a time, while commands to different End Stations go out in parallel. Each response is
+         * processed and notified as if the command had been sent on its own.
+         *
+         * The batch counts as one command with the notification id, so set_wait_for_next_cmd and
+         * create_cmd_completion on the system complete once every command of the batch has a response
+         * or has timed out, with the status of the first command that did not succeed, or
+         * AEM_STATUS_SUCCESS if they all did.
+         *
+         * \param notification_id The notification id of every command in the batch.
+         * \param cmds The commands, copied before the call returns.
+         * \param count The number of commands.
+         * \param entity_limit The maximum number of commands of the batch inflight to one End Station.
+         *
+         * \return 0 on success, -1 if a command names an unknown End Station or is not supported.
+         */
+        AVDECC_CONTROLLER_LIB32_API virtual int STDCALL send_bulk_cmds(void *notification_id, const struct bulk_cmd *cmds, size_t count,
+                                                                       uint16_t entity_limit) = 0;
+
+        /**
+         * The connection graph is kept up to date from every successful CONNECT_RX, DISCONNECT_RX,
+         * GET_RX_STATE and GET_TX_STATE response on the network, including responses to other controllers.
+         * Connections made before the controller started are learned by sending GET_RX_STATE commands.
+         *
+         * \return The number of connections in the graph.
+         */
+        AVDECC_CONTROLLER_LIB32_API virtual size_t STDCALL get_connection_count() = 0;
+
+        /**
+         * Copy a connection of the graph. The order changes as connections are added and removed.
+         *
+         * \return 0 on success, -1 if the index is out of range.
+         */
+        AVDECC_CONTROLLER_LIB32_API virtual int STDCALL get_connection_by_index(size_t index, struct stream_connection &connection) = 0;
+
+        /**
+         * \return The number of listener streams connected to the talker stream.
+         */
+        AVDECC_CONTROLLER_LIB32_API virtual size_t STDCALL get_listener_count(uint64_t talker_entity_id, uint16_t talker_unique_id) = 0;
+
+        /**
+         * Copy the connection of a listener stream connected to the talker stream.
+         *
+         * \return 0 on success, -1 if the index is out of range.
+         */
+        AVDECC_CONTROLLER_LIB32_API virtual int STDCALL get_listener_by_index(uint64_t talker_entity_id, uint16_t talker_unique_id, size_t index,
+                                                                              struct stream_connection &connection) = 0;
+
+        /**
+         * Copy the connection of the listener stream to its talker stream.
+         *
+         * \return 0 on success, -1 if the listener stream is not connected.
+         */
+        AVDECC_CONTROLLER_LIB32_API virtual int STDCALL get_talker_connection(uint64_t listener_entity_id, uint16_t listener_unique_id,
+                                                                              struct stream_connection &connection) = 0;
+
+        /**
+         * Find the talker stream that sources a stream id.
+         *
+         * \return 0 on success, -1 if the stream id has not been seen.
+         */
+        AVDECC_CONTROLLER_LIB32_API virtual int STDCALL get_talker_by_stream_id(uint64_t stream_id, uint64_t &talker_entity_id, uint16_t &talker_unique_id) = 0;
     };
 
     /**
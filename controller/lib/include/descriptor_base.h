@@ -55,7 +55,8 @@ namespace avdecc_lib
         AVDECC_CONTROLLER_LIB32_API virtual size_t STDCALL field_count() const = 0;
 
         /**
-        * \return The indicated field in the descriptor.
+        * \return The indicated field in the descriptor. The returned object stays valid for the lifetime
+        *         of the descriptor.
         */
         AVDECC_CONTROLLER_LIB32_API virtual descriptor_field * STDCALL field(size_t index) const = 0;
 
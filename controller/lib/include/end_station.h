@@ -99,6 +99,22 @@ namespace avdecc_lib
          */
         AVDECC_CONTROLLER_LIB32_API virtual int STDCALL send_identify(void *notification_id, bool turn_on) = 0;
 
+        /**
+         * Send a REGISTER_UNSOLICITED_NOTIFICATION command, after which the AVDECC Entity sends an unsolicited
+         * response whenever its state is changed by another controller or locally. End Stations are registered
+         * once they have been enumerated unless that is turned off with controller::enable_unsolicited_notifications.
+         *
+         * \param notification_id A void pointer to the unique identifier associated with the command.
+         */
+        AVDECC_CONTROLLER_LIB32_API virtual int STDCALL send_register_unsolicited_cmd(void *notification_id) = 0;
+
+        /**
+         * Send a DEREGISTER_UNSOLICITED_NOTIFICATION command to stop unsolicited responses from the AVDECC Entity.
+         *
+         * \param notification_id A void pointer to the unique identifier associated with the command.
+         */
+        AVDECC_CONTROLLER_LIB32_API virtual int STDCALL send_deregister_unsolicited_cmd(void *notification_id) = 0;
+
         /**
          * \param entity_index The index of the entity to set as current selected.
          */
@@ -174,8 +174,10 @@ namespace avdecc_lib
         TOTAL_NUM_OF_AEM_CMDS_STATUS = 13,  ///< The total number of AEM commands status currently supported in the 1722.1 specification
         AVDECC_LIB_STATUS_INVALID = 1023, ///< AVDECC library specific status, not part of the 1722.1 specification
                                           ///< The response received has a subtype different from the subtype of the command sent
-        AVDECC_LIB_STATUS_TICK_TIMEOUT = 1024 ///< AVDECC library specific status, not part of the 1722.1 specification
-                                              ///< The response is not received within the timeout period after re-sending a command
+        AVDECC_LIB_STATUS_TICK_TIMEOUT = 1024, ///< AVDECC library specific status, not part of the 1722.1 specification
+                                               ///< The response is not received within the timeout period after re-sending a command
+        AVDECC_LIB_STATUS_CRC_MISMATCH = 1025 ///< AVDECC library specific status, not part of the 1722.1 specification
+                                              ///< The CRC-32 of the memory object read does not match the one expected
     };
 
     enum acmp_cmds_values /// The command codes values for ACMP commands
@@ -227,6 +229,8 @@ namespace avdecc_lib
     {
         CMD_WITHOUT_NOTIFICATION = 0, ///< All internal commands are sent without notification ids
         CMD_WITH_NOTIFICATION = 1, ///< All user commands are sent with unique notification ids
+        CMD_BATCH_WITH_NOTIFICATION = 2, ///< A batch of user commands handed to the system layer at once
+        CMD_TRANSFER_WITH_NOTIFICATION = 3, ///< A memory object transfer handed to the system layer at once
     };
 
     enum ether_hdr_info
@@ -275,7 +279,10 @@ namespace avdecc_lib
         COMMAND_TIMEOUT = 3, ///< A command is sent, but the response is not received within a timeout period
         RESPONSE_RECEIVED = 4, ///< A response is received after sending a command
         END_STATION_READ_COMPLETED = 5, ///< An AVDECC End Station has finished internal READ_DESCRIPTOR processing for all top level descriptors
-        TOTAL_NUM_OF_NOTIFICATIONS = 6
+        UNSOLICITED_RESPONSE_RECEIVED = 6, ///< An AVDECC End Station has reported a change of its state, which has been applied to its descriptors
+        MEMORY_OBJECT_TRANSFER_PROGRESS = 7, ///< A memory object transfer has moved on, the status is the percent complete in tenths of a percent
+        MEMORY_OBJECT_TRANSFER_COMPLETED = 8, ///< A memory object transfer has ended, the status is that of the transfer
+        TOTAL_NUM_OF_NOTIFICATIONS = 9
     };
 
     enum logging_levels
@@ -33,6 +33,7 @@
 #include <stdint.h>
 #include "build.h"
 #include "descriptor_base.h"
+#include "memory_object_image.h"
 
 namespace avdecc_lib
 {
@@ -85,6 +86,68 @@ namespace avdecc_lib
          * \param operation_tyoe    An integer representation the operation type to perform on the object
          */
         AVDECC_CONTROLLER_LIB32_API virtual int STDCALL start_operation_cmd(void *notification_id, uint16_t operation_type) = 0;
+
+        /**
+         * Write an image to the memory object, starting at start_address(), with AECP Address Access WRITE
+         * commands. The image is split into TLVs of the largest size an AECPDU can carry and up to window
+         * of the commands are inflight at a time. Only the TLVs whose commands time out are resent.
+         * Uploads to different memory objects or End Stations run in parallel.
+         *
+         * Progress is notified as MEMORY_OBJECT_TRANSFER_PROGRESS with the percent complete in tenths of
+         * a percent as the status, as in an OPERATION_STATUS response, and the end of the upload as
+         * MEMORY_OBJECT_TRANSFER_COMPLETED with the status of the upload. The upload counts as one command
+         * with the notification id, so set_wait_for_next_cmd and create_cmd_completion on the system
+         * complete once the whole image has been written or the upload has failed.
+         *
+         * \param notification_id A void pointer to the unique identifier associated with the upload.
+         * \param data The image, copied before the call returns.
+         * \param length The length of the image in bytes.
+         * \param window The maximum number of WRITE commands inflight, 0 for the default of 8.
+         *
+         * \return 0 on success, -1 if the image is empty or larger than the memory object.
+         */
+        AVDECC_CONTROLLER_LIB32_API virtual int STDCALL upload(void *notification_id, const uint8_t *data, size_t length, uint16_t window) = 0;
+
+        /**
+         * Write an image created with map_memory_object_image or create_memory_object_image to the memory
+         * object, as upload does, without copying the image. The bytes of each TLV are read from the image
+         * straight into the command sent, so one image can be uploaded to many memory objects at once.
+         *
+         * \param notification_id A void pointer to the unique identifier associated with the upload.
+         * \param image The image, which may be released once the call returns.
+         * \param window The maximum number of WRITE commands inflight, 0 for the default of 8.
+         *
+         * \return 0 on success, -1 if the image is larger than the memory object.
+         */
+        AVDECC_CONTROLLER_LIB32_API virtual int STDCALL upload_image(void *notification_id, memory_object_image *image, uint16_t window) = 0;
+
+        /**
+         * Read the memory object, starting at start_address(), into a buffer with AECP Address Access READ
+         * commands. Up to window of the commands are inflight at a time and the responses are stored at
+         * their own offsets in whatever order they arrive. Only the commands that time out are resent.
+         *
+         * Progress and the end of the download are notified as for upload. If crc32 is given, the bytes
+         * read are checked against it once all have arrived, and the download ends with the status
+         * AVDECC_LIB_STATUS_CRC_MISMATCH if they differ. The number of bytes read, the time taken and the
+         * throughput are logged when the download ends.
+         *
+         * \param notification_id A void pointer to the unique identifier associated with the download.
+         * \param buffer Where the bytes read are stored. Must stay valid until the download has ended.
+         * \param length The number of bytes to read, 0 for the current length() of the memory object.
+         * \param crc32 The expected IEEE 802.3 CRC-32 of the bytes read (see utility::crc32), or NULL.
+         * \param window The maximum number of READ commands inflight, 0 for the default of 8.
+         *
+         * \return 0 on success, -1 if there is nothing to read or length is larger than the memory object.
+         */
+        AVDECC_CONTROLLER_LIB32_API virtual int STDCALL download(void *notification_id, uint8_t *buffer, uint64_t length, const uint32_t *crc32, uint16_t window) = 0;
+
+        /**
+         * Read the memory object into a file, created or truncated first, as download does.
+         *
+         * \return 0 on success, -1 if there is nothing to read, length is larger than the memory object or
+         *         the file cannot be created.
+         */
+        AVDECC_CONTROLLER_LIB32_API virtual int STDCALL download_to_file(void *notification_id, const char *path, uint64_t length, const uint32_t *crc32, uint16_t window) = 0;
     };
 }
 
@@ -0,0 +1,83 @@
+/*
+ * Licensed under the MIT License (MIT)
+ *
+ * Copyright (c) 2014 AudioScience Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * memory_object_image.h
+ *
+ * Public memory object image interface class
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include "build.h"
+
+namespace avdecc_lib
+{
+    /**
+     * An image written to memory objects with memory_object_descriptor::upload_image. The same image can be
+     * uploaded to any number of memory objects at once; its bytes are read straight into the commands sent.
+     */
+    class memory_object_image
+    {
+    public:
+        /**
+         * \return The length of the image in bytes.
+         */
+        AVDECC_CONTROLLER_LIB32_API virtual uint64_t STDCALL length() = 0;
+
+        /**
+         * Release the image. Uploads already submitted keep the image until they end, so it may be
+         * released as soon as the last upload_image call has returned.
+         */
+        AVDECC_CONTROLLER_LIB32_API virtual void STDCALL release() = 0;
+
+    protected:
+        /**
+         * Images are freed with release(), never deleted through this interface.
+         */
+        virtual ~memory_object_image() {}
+    };
+
+    /**
+     * Map a file as an image. The file must not change until the uploads of the image have ended.
+     *
+     * \return The image, or NULL if the file cannot be opened, is empty or cannot be mapped.
+     */
+    extern "C" AVDECC_CONTROLLER_LIB32_API memory_object_image * STDCALL map_memory_object_image(const char *path);
+
+    /**
+     * Create an image whose bytes are supplied by the application as they are sent.
+     *
+     * \param length The length of the image in bytes.
+     * \param read_callback Called on the library thread to copy len bytes of the image starting at offset
+     *                      into buf. Returns 0 on success or a negative value to fail the uploads.
+     * \param user_obj Passed to read_callback, and must stay valid until the uploads of the image have ended.
+     *
+     * \return The image, or NULL if length is 0 or read_callback is NULL.
+     */
+    extern "C" AVDECC_CONTROLLER_LIB32_API memory_object_image * STDCALL create_memory_object_image(uint64_t length,
+            int (*read_callback)(void *user_obj, uint64_t offset, uint8_t *buf, size_t len),
+            void *user_obj);
+}
@@ -36,6 +36,7 @@ namespace avdecc_lib
 {
     class net_interface;
     class controller;
+    class cmd_completion;
 
     class system
     {
@@ -61,6 +62,30 @@ namespace avdecc_lib
          */
         AVDECC_CONTROLLER_LIB32_API virtual int STDCALL get_last_resp_status() = 0;
 
+        /**
+         * Create a completion token for the next command sent with the notification id. Unlike
+         * set_wait_for_next_cmd, sending the command does not block, and several commands may be
+         * waited on at once from any number of threads. The notification id must be unique among
+         * the commands that have tokens.
+         *
+         * \return The token, or NULL if the notification id already has one.
+         */
+        AVDECC_CONTROLLER_LIB32_API virtual cmd_completion * STDCALL create_cmd_completion(void *notification_id) = 0;
+
+        /**
+         * Run the protocol engine on count threads instead of one, for networks with so many End Stations
+         * that a single thread cannot keep up with receiving, enumerating and timing them out. End Stations
+         * are partitioned across the threads by Entity ID, each thread having its own inflight commands,
+         * timers and background read limits. The first thread receives on the network interfaces and
+         * hands the frames for the End Stations of the other threads over to them.
+         *
+         * Must be called before process_start. Only supported on Linux.
+         *
+         * \param count The number of engine threads, 1 by default.
+         * \return 0 on success, -1 if the count cannot be used.
+         */
+        AVDECC_CONTROLLER_LIB32_API virtual int STDCALL set_engine_shard_count(uint32_t count) = 0;
+
         /**
          * Start point of the system process, which calls the thread initialization function.
          */
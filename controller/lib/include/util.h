@@ -31,6 +31,7 @@
 
 #include "build.h"
 #include <stdint.h>
+#include <stddef.h>
 
 namespace avdecc_lib
 {
@@ -115,5 +116,12 @@ namespace avdecc_lib
          * Convert an eui48 value to uint64_t.
          */
         AVDECC_CONTROLLER_LIB32_API void convert_eui48_to_uint64(const uint8_t value[6], uint64_t &new_value);
+
+        /**
+         * Update the IEEE 802.3 CRC-32 of a block of data, as used to verify memory object downloads.
+         *
+         * \param crc The CRC-32 of the data before this block, 0 for the first block.
+         */
+        AVDECC_CONTROLLER_LIB32_API uint32_t STDCALL crc32(uint32_t crc, const uint8_t *data, size_t len);
     }
 }
\ No newline at end of file
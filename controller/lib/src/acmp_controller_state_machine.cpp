@@ -31,6 +31,7 @@
 #include <vector>
 #include "jdksavdecc_acmp.h"
 #include "net_interface_imp.h"
+#include "net_interface_set.h"
 #include "util.h"
 #include "enumeration.h"
 #include "notification_imp.h"
@@ -41,8 +42,6 @@
 
 namespace avdecc_lib
 {
-    acmp_controller_state_machine * acmp_controller_state_machine_ref = new acmp_controller_state_machine();
-
     acmp_controller_state_machine::acmp_controller_state_machine()
     {
         acmp_seq_id = 0;
@@ -110,10 +109,10 @@ namespace avdecc_lib
         return proc_resp(notification_id, cmd_frame);
     }
 
-    void acmp_controller_state_machine::state_timeout(uint32_t inflight_cmd_index)
+    void acmp_controller_state_machine::state_timeout(inflight *cmd)
     {
-        struct jdksavdecc_frame frame = inflight_cmds.at(inflight_cmd_index).frame();
-        bool is_retried = inflight_cmds.at(inflight_cmd_index).retried();
+        struct jdksavdecc_frame frame = cmd->frame();
+        bool is_retried = cmd->retried();
 
         if(is_retried)
         {
@@ -127,7 +126,7 @@ namespace avdecc_lib
                                                         0,
                                                         0,
                                                         UINT_MAX,
-                                                        inflight_cmds.at(inflight_cmd_index).cmd_notification_id);
+                                                        cmd->cmd_notification_id);
 
             log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR,
                                       "Command Timeout, 0x%llx, %s, %s, %s, %d",
@@ -135,18 +134,18 @@ namespace avdecc_lib
                                       utility::acmp_cmd_value_to_name(msg_type),
                                       "NULL",
                                       "NULL",
-                                      inflight_cmds.at(inflight_cmd_index).cmd_seq_id);
+                                      cmd->cmd_seq_id);
 
-            inflight_cmds.erase(inflight_cmds.begin() + inflight_cmd_index);
+            inflight_cmds.erase(cmd);
         }
         else
         {
             log_imp_ref->post_log_msg(LOGGING_LEVEL_DEBUG,
                                       "Resend the command with sequence id = %d",
-                                      inflight_cmds.at(inflight_cmd_index).cmd_seq_id);
+                                      cmd->cmd_seq_id);
            
-            tx_cmd(inflight_cmds.at(inflight_cmd_index).cmd_notification_id,
-                   inflight_cmds.at(inflight_cmd_index).notification_flag(),
+            tx_cmd(cmd->cmd_notification_id,
+                   cmd->notification_flag(),
                    &frame,
                    true);
         }
@@ -169,22 +168,20 @@ namespace avdecc_lib
                                           notification_flag,
                                           timeout_ms);
 
-            in_flight.start_timer();
-            inflight_cmds.push_back(in_flight);
+            inflight_cmds.insert(in_flight)->start_timer(&inflight_timeout_cb);
         }
         else
         {
             uint16_t resend_with_seq_id = jdksavdecc_acmpdu_get_sequence_id(cmd_frame->payload, ETHER_HDR_SIZE);
-            std::vector<inflight>::iterator j =
-                std::find_if(inflight_cmds.begin(), inflight_cmds.end(), SeqIdComp(resend_with_seq_id));
+            inflight *j = inflight_cmds.find(resend_with_seq_id);
 
-            if(j != inflight_cmds.end()) // found?
+            if(j) // found?
             {
-                (*j).start_timer();
+                j->start_timer(&inflight_timeout_cb);
             }
         }
 
-        send_frame_returned = net_interface_ref->send_frame(cmd_frame->payload, cmd_frame->length);
+        send_frame_returned = net_interface_set_ref->send_frame(cmd_frame->payload, cmd_frame->length);
         if(send_frame_returned < 0)
         {
             log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "netif_send_frame error");
@@ -201,13 +198,12 @@ namespace avdecc_lib
         uint16_t seq_id = jdksavdecc_acmpdu_get_sequence_id(cmd_frame->payload, ETHER_HDR_SIZE);
         uint32_t notification_flag = 0;
 
-         std::vector<inflight>::iterator j =
-            std::find_if(inflight_cmds.begin(), inflight_cmds.end(), SeqIdComp(seq_id));
+        inflight *j = inflight_cmds.find(seq_id);
 
-        if(j != inflight_cmds.end()) // found?
+        if(j) // found?
         {
-            notification_id = (*j).cmd_notification_id;
-            notification_flag = (*j).notification_flag();
+            notification_id = j->cmd_notification_id;
+            notification_flag = j->notification_flag();
             callback(notification_id, notification_flag, cmd_frame->payload);
             inflight_cmds.erase(j);
             return 1;
@@ -216,28 +212,14 @@ namespace avdecc_lib
         return -1;
     }
 
-    void acmp_controller_state_machine::tick()
+    void acmp_controller_state_machine::inflight_timeout_cb(void *context)
     {
-        for(uint32_t i = 0; i < inflight_cmds.size(); i++)
-        {
-            if(inflight_cmds.at(i).timeout())
-            {
-                state_timeout(i);
-            }
-        }
+        acmp_controller_state_machine_ref->state_timeout((inflight *)context);
     }
 
     bool acmp_controller_state_machine::is_inflight_cmd_with_notification_id(void *notification_id)
     {
-         std::vector<inflight>::iterator j =
-            std::find_if(inflight_cmds.begin(), inflight_cmds.end(), NotificationComp(notification_id));
-
-        if(j != inflight_cmds.end()) // found?
-        {
-            return true;
-        }
-
-        return false;
+        return inflight_cmds.has_notification_id(notification_id);
     }
 
     int acmp_controller_state_machine::callback(void *notification_id, uint32_t notification_flag, uint8_t *frame)
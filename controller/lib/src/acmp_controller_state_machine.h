@@ -29,6 +29,8 @@
 
 #pragma once
 
+#include "inflight_table.h"
+
 namespace avdecc_lib
 {
     class inflight;
@@ -37,7 +39,7 @@ namespace avdecc_lib
     {
     private:
         uint16_t acmp_seq_id; // The sequence id used for identifying the ACMP command that a response is for
-        std::vector<inflight> inflight_cmds;
+        inflight_table inflight_cmds;
 
     public:
         acmp_controller_state_machine();
@@ -65,20 +67,28 @@ namespace avdecc_lib
         int state_resp(void *&notification_id, struct jdksavdecc_frame *cmd_frame);
 
         /**
-         * Check timeout for the inflight commands.
+         * Check if the command with the corresponding notification id is already in the inflight command vector.
          */
-        void tick();
+        bool is_inflight_cmd_with_notification_id(void *notification_id);
 
         /**
-         * Check if the command with the corresponding notification id is already in the inflight command vector.
+         * Check if the command sent with the sequence id is still waiting for its response.
          */
-        bool is_inflight_cmd_with_notification_id(void *notification_id);
+        inline bool is_inflight_seq_id(uint16_t seq_id)
+        {
+            return inflight_cmds.find(seq_id) != NULL;
+        }
 
     private:
         /**
          * Process the Timeout state of the ACMP Controller State Machine.
          */
-        void state_timeout(uint32_t inflight_cmd_index);
+        void state_timeout(inflight *cmd);
+
+        /**
+         * Timer wheel handler for an inflight command timeout.
+         */
+        static void inflight_timeout_cb(void *context);
 
         /**
          * Transmit an ACMP Command.
@@ -96,6 +106,6 @@ namespace avdecc_lib
         int callback(void *notification_id, uint32_t notification_flag, uint8_t *frame);
     };
 
-    extern acmp_controller_state_machine *acmp_controller_state_machine_ref;
+    extern thread_local acmp_controller_state_machine *acmp_controller_state_machine_ref; // One per engine shard
 }
 
@@ -32,6 +32,7 @@
 #include <inttypes.h>
 
 #include "net_interface_imp.h"
+#include "net_interface_set.h"
 #include "enumeration.h"
 #include "notification_imp.h"
 #include "log_imp.h"
@@ -41,14 +42,18 @@
 
 namespace avdecc_lib
 {
-    adp_discovery_state_machine *adp_discovery_state_machine_ref = new adp_discovery_state_machine(); // To have one ADP Discovery State Machine for all end stations
-
-    adp_discovery_state_machine::adp_discovery_state_machine()
+    adp_discovery_state_machine::adp_discovery_state_machine(bool discover_on_first_tick)
     {
-        first_tick = true;
+        first_tick = discover_on_first_tick;
     }
 
-    adp_discovery_state_machine::~adp_discovery_state_machine() {}
+    adp_discovery_state_machine::~adp_discovery_state_machine()
+    {
+        for(std::unordered_map<uint64_t, struct entities *>::iterator it = entities_map.begin(); it != entities_map.end(); ++it)
+        {
+            delete it->second;
+        }
+    }
 
     int adp_discovery_state_machine::ether_frame_init(struct jdksavdecc_frame *cmd_frame)
     {
@@ -104,7 +109,7 @@ namespace avdecc_lib
     int adp_discovery_state_machine::tx_discover(struct jdksavdecc_frame *cmd_frame)
     {
         int send_frame_returned;
-        send_frame_returned = net_interface_ref->send_frame(cmd_frame->payload, cmd_frame->length); // Send the frame with message information
+        send_frame_returned = net_interface_set_ref->send_frame(cmd_frame->payload, cmd_frame->length); // Send the frame with message information
 
         if(send_frame_returned < 0)
         {
@@ -115,35 +120,37 @@ namespace avdecc_lib
         return 0;
     }
 
-    bool adp_discovery_state_machine::have_entity(uint64_t entity_id, uint32_t *entity_index)
+    struct adp_discovery_state_machine::entities * adp_discovery_state_machine::have_entity(uint64_t entity_id)
     {
-        for(uint32_t i = 0; i < entities_vec.size(); i++)
+        std::unordered_map<uint64_t, struct entities *>::iterator it = entities_map.find(entity_id);
+
+        if(it != entities_map.end())
         {
-            if(entities_vec.at(i).entity_id == entity_id)
-            {
-                *entity_index = i;
-                return true;
-            }
+            return it->second;
         }
 
-        return false;
+        return NULL;
     }
 
-    int adp_discovery_state_machine::update_entity_timeout(uint32_t entity_index, uint32_t timeout_ms)
+    int adp_discovery_state_machine::update_entity_timeout(struct entities *entity, uint32_t timeout_ms)
     {
-        entities_vec.at(entity_index).inflight_timer.start(timeout_ms);
+        timer_wheel_ref->schedule(&entity->inflight_timer, timeout_ms, &entity_timeout_cb, entity);
         return 0;
     }
 
-    int adp_discovery_state_machine::add_entity(struct entities new_entity)
+    struct adp_discovery_state_machine::entities * adp_discovery_state_machine::add_entity(uint64_t entity_id)
     {
-        entities_vec.push_back(new_entity);
-        return 0;
+        struct entities *entity = new entities;
+
+        entity->entity_id = entity_id;
+        entities_map[entity_id] = entity;
+        return entity;
     }
 
-    int adp_discovery_state_machine::remove_entity(uint32_t entity_index)
+    int adp_discovery_state_machine::remove_entity(struct entities *entity)
     {
-        entities_vec.erase(entities_vec.begin() + entity_index);
+        entities_map.erase(entity->entity_id);
+        delete entity;
         return 0;
     }
 
@@ -161,21 +168,20 @@ namespace avdecc_lib
     {
         struct jdksavdecc_adpdu_common_control_header adp_hdr;
         uint64_t entity_entity_id;
-        uint32_t entity_index;
+        struct entities *entity;
 
         entity_entity_id = jdksavdecc_uint64_get(frame, ETHER_HDR_SIZE + PROTOCOL_HDR_SIZE);
         jdksavdecc_adpdu_common_control_header_read(&adp_hdr, frame, ETHER_HDR_SIZE, frame_len);
 
-        if(have_entity(entity_entity_id, &entity_index))
+        entity = have_entity(entity_entity_id);
+        if(entity)
         {
-            update_entity_timeout(entity_index, adp_hdr.valid_time * 2 * 1000); // Valid time period is between 2 and 62 seconds
+            update_entity_timeout(entity, adp_hdr.valid_time * 2 * 1000); // Valid time period is between 2 and 62 seconds
         }
         else
         {
-            struct entities entity;
-            entity.entity_id = entity_entity_id;
-            entity.inflight_timer.start(adp_hdr.valid_time * 2 * 1000); // Valid time period is between 2 and 62 seconds
-            add_entity(entity);
+            entity = add_entity(entity_entity_id);
+            update_entity_timeout(entity, adp_hdr.valid_time * 2 * 1000); // Valid time period is between 2 and 62 seconds
             notification_imp_ref->post_notification_msg(END_STATION_CONNECTED, entity_entity_id, 0, 0, 0, 0, 0);
         }
 
@@ -188,12 +194,21 @@ namespace avdecc_lib
         return 0;
     }
 
-    int adp_discovery_state_machine::state_timeout(uint32_t entity_index)
+    int adp_discovery_state_machine::state_timeout(struct entities *entity)
     {
-        remove_entity(entity_index);
+        uint64_t end_station_entity_id = entity->entity_id;
+
+        remove_entity(entity);
+        departed_entities.push_back(end_station_entity_id);
+        notification_imp_ref->post_notification_msg(END_STATION_DISCONNECTED, end_station_entity_id, 0, 0, 0, 0, 0);
         return 0;
     }
 
+    void adp_discovery_state_machine::entity_timeout_cb(void *context)
+    {
+        adp_discovery_state_machine_ref->state_timeout((struct entities *)context);
+    }
+
     bool adp_discovery_state_machine::tick(uint64_t &end_station_entity_id)
     {
         if (first_tick)
@@ -202,15 +217,11 @@ namespace avdecc_lib
             first_tick = false;
         }
 
-        for(uint32_t i = 0; i < entities_vec.size(); i++)
+        if (!departed_entities.empty())
         {
-            if(entities_vec.at(i).inflight_timer.timeout())
-            {
-                end_station_entity_id = entities_vec.at(i).entity_id;
-                state_timeout(i);
-                notification_imp_ref->post_notification_msg(END_STATION_DISCONNECTED, end_station_entity_id, 0, 0, 0, 0, 0);
-                return true;
-            }
+            end_station_entity_id = departed_entities.front();
+            departed_entities.pop_front();
+            return true;
         }
 
         return false;
@@ -29,7 +29,10 @@
 
 #pragma once
 
-#include "timer.h"
+#include <deque>
+#include <unordered_map>
+
+#include "timer_wheel.h"
 
 namespace avdecc_lib
 {
@@ -39,14 +42,18 @@ namespace avdecc_lib
         struct entities
         {
             uint64_t entity_id;
-            timer inflight_timer;
+            timer_wheel_entry inflight_timer;
         };
 
         bool first_tick;
-        std::vector<struct entities> entities_vec;
+        std::unordered_map<uint64_t, struct entities *> entities_map; // Entities by entity id
+        std::deque<uint64_t> departed_entities; // Timed out entities not yet reported by tick()
 
     public:
-        adp_discovery_state_machine();
+        /**
+         * \param discover_on_first_tick Send an ENTITY_DISCOVER for all entities on the first tick.
+         */
+        adp_discovery_state_machine(bool discover_on_first_tick = true);
 
         ~adp_discovery_state_machine();
 
@@ -76,7 +83,9 @@ namespace avdecc_lib
         int state_departing();
 
         /**
-         * Check timeout for the end stations.
+         * Report an end station that has timed out since the last call.
+         *
+         * \return True if end_station_entity_id was set to a timed out end station.
          */
         bool tick(uint64_t &end_station_entity_id);
 
@@ -95,29 +104,34 @@ namespace avdecc_lib
         /**
          * Check if an AVDECC Entity is present in the entities variable.
          */
-        bool have_entity(uint64_t entity_id, uint32_t *entity_index);
+        struct entities * have_entity(uint64_t entity_id);
 
         /**
          * Update the AVDECC Entity record timeout information.
          */
-        int update_entity_timeout(uint32_t entity_index, uint32_t timeout_ms);
+        int update_entity_timeout(struct entities *entity, uint32_t timeout_ms);
 
         /**
          * Add a new Entity record to the entities variable.
          */
-        int add_entity(struct entities new_entity);
+        struct entities * add_entity(uint64_t entity_id);
 
         /**
          * Remove an Entity record form the entities variable.
          */
-        int remove_entity(uint32_t entity_index);
+        int remove_entity(struct entities *entity);
 
         /**
          * Process the Timeout state of the ADP Discovery State Machine.
          */
-        int state_timeout(uint32_t entity_index);
+        int state_timeout(struct entities *entity);
+
+        /**
+         * Timer wheel handler for an entity timeout.
+         */
+        static void entity_timeout_cb(void *context);
     };
 
-    extern adp_discovery_state_machine *adp_discovery_state_machine_ref;
+    extern thread_local adp_discovery_state_machine *adp_discovery_state_machine_ref; // One per engine shard
 }
 
@@ -31,6 +31,7 @@
 #include <vector>
 #include "jdksavdecc_aem_command.h"
 #include "net_interface_imp.h"
+#include "net_interface_set.h"
 #include "util.h"
 #include "enumeration.h"
 #include "notification_imp.h"
@@ -41,8 +42,6 @@
 
 namespace avdecc_lib
 {
-    aecp_controller_state_machine *aecp_controller_state_machine_ref = new aecp_controller_state_machine(); // To have one Controller State Machine for all end stations
-
     aecp_controller_state_machine::aecp_controller_state_machine()
     {
         aecp_seq_id = 0;
@@ -110,22 +109,20 @@ namespace avdecc_lib
                                           notification_id,
                                           notification_flag,
                                           AVDECC_MSG_TIMEOUT_MS);
-            in_flight.start_timer();
-            inflight_cmds.push_back(in_flight);
+            inflight_cmds.insert(in_flight)->start_timer(&inflight_timeout_cb);
         }
         else
         {
             uint16_t resend_with_seq_id = jdksavdecc_aecpdu_common_get_sequence_id(cmd_frame->payload, ETHER_HDR_SIZE);
-            std::vector<inflight>::iterator j =
-            std::find_if(inflight_cmds.begin(), inflight_cmds.end(), SeqIdComp(resend_with_seq_id));
+            inflight *j = inflight_cmds.find(resend_with_seq_id);
 
-            if(j != inflight_cmds.end()) // found?
+            if(j) // found?
             {
-                j->start_timer();
+                j->start_timer(&inflight_timeout_cb);
             }
         }
 
-        send_frame_returned = net_interface_ref->send_frame(cmd_frame->payload, cmd_frame->length);
+        send_frame_returned = net_interface_set_ref->send_frame(cmd_frame->payload, cmd_frame->length);
         if(send_frame_returned < 0)
         {
             log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "netif_send_frame error");
@@ -139,7 +136,32 @@ namespace avdecc_lib
 
     int aecp_controller_state_machine::proc_unsolicited(void *&notification_id, struct jdksavdecc_frame *cmd_frame)
     {
-        log_imp_ref->post_log_msg(LOGGING_LEVEL_DEBUG, "proc_unsolicited is not implemented.");
+        uint8_t *frame = cmd_frame->payload;
+        uint16_t cmd_type = jdksavdecc_aecpdu_aem_get_command_type(frame, ETHER_HDR_SIZE);
+        cmd_type &= 0x7FFF;
+        uint32_t status = jdksavdecc_common_control_header_get_status(frame, ETHER_HDR_SIZE);
+        uint16_t desc_type = 0;
+        uint16_t desc_index = 0;
+        jdksavdecc_eui64 id = jdksavdecc_common_control_header_get_stream_id(frame, ETHER_HDR_SIZE);
+
+        aem_resp_desc(cmd_type, frame, desc_type, desc_index);
+
+        // Not a response to any command of ours, so there is no notification id to match
+        notification_id = NULL;
+        notification_imp_ref->post_notification_msg(UNSOLICITED_RESPONSE_RECEIVED,
+                                                    jdksavdecc_uint64_get(&id, 0),
+                                                    cmd_type,
+                                                    desc_type,
+                                                    desc_index,
+                                                    status,
+                                                    NULL);
+
+        log_imp_ref->post_log_msg(LOGGING_LEVEL_DEBUG,
+                                  "UNSOLICITED_RESPONSE_RECEIVED, 0x%llx, %s, %s, %d",
+                                  jdksavdecc_uint64_get(&id, 0),
+                                  utility::aem_cmd_value_to_name(cmd_type),
+                                  utility::aem_desc_value_to_name(desc_type),
+                                  desc_index);
 
         return 0;
     }
@@ -149,10 +171,9 @@ namespace avdecc_lib
         uint16_t seq_id = jdksavdecc_aecpdu_common_get_sequence_id(cmd_frame->payload, ETHER_HDR_SIZE);
         uint32_t notification_flag = 0;
 
-        std::vector<inflight>::iterator j =
-            std::find_if(inflight_cmds.begin(), inflight_cmds.end(), SeqIdComp(seq_id));
+        inflight *j = inflight_cmds.find(seq_id);
 
-        if(j != inflight_cmds.end()) // found?
+        if(j) // found?
         {
             notification_id = j->cmd_notification_id;
             notification_flag = j->notification_flag();
@@ -179,11 +200,11 @@ namespace avdecc_lib
        return proc_resp(notification_id, cmd_frame);
     }
 
-    void aecp_controller_state_machine::state_timeout(uint32_t inflight_cmd_index)
+    void aecp_controller_state_machine::state_timeout(inflight *cmd)
     {
-        struct jdksavdecc_frame frame = inflight_cmds.at(inflight_cmd_index).frame();
-        bool is_retried = inflight_cmds.at(inflight_cmd_index).retried();
-        uint32_t notification_flag = inflight_cmds.at(inflight_cmd_index).notification_flag();
+        struct jdksavdecc_frame frame = cmd->frame();
+        bool is_retried = cmd->retried();
+        uint32_t notification_flag = cmd->notification_flag();
 
         if(is_retried)
         {
@@ -199,7 +220,7 @@ namespace avdecc_lib
                                                         desc_type,
                                                         desc_index,
                                                         UINT_MAX,
-                                                        inflight_cmds.at(inflight_cmd_index).cmd_notification_id);
+                                                        cmd->cmd_notification_id);
 
             log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR,
                                       "Command Timeout, 0x%llx, %s, %s, %d, %d",
@@ -207,32 +228,26 @@ namespace avdecc_lib
                                       utility::aem_cmd_value_to_name(cmd_type),
                                       utility::aem_desc_value_to_name(desc_type),
                                       desc_index,
-                                      inflight_cmds.at(inflight_cmd_index).cmd_seq_id);
+                                      cmd->cmd_seq_id);
 
-            inflight_cmds.erase(inflight_cmds.begin() + inflight_cmd_index);
+            inflight_cmds.erase(cmd);
         }
         else
         {
             log_imp_ref->post_log_msg(LOGGING_LEVEL_DEBUG,
                                       "Resend the command with sequence id = %d",
-                                      inflight_cmds.at(inflight_cmd_index).cmd_seq_id);
+                                      cmd->cmd_seq_id);
 
-            tx_cmd(inflight_cmds.at(inflight_cmd_index).cmd_notification_id,
+            tx_cmd(cmd->cmd_notification_id,
                    notification_flag,
                    &frame,
                    true);
         }
     }
 
-    void aecp_controller_state_machine::tick()
+    void aecp_controller_state_machine::inflight_timeout_cb(void *context)
     {
-        for(uint32_t i = 0; i < inflight_cmds.size(); i++)
-        {
-            if(inflight_cmds.at(i).timeout())
-            {
-                state_timeout(i);
-            }
-        }
+        aecp_controller_state_machine_ref->state_timeout((inflight *)context);
     }
 
     int aecp_controller_state_machine::update_inflight_for_rcvd_resp(void *&notification_id, uint32_t msg_type, bool u_field, struct jdksavdecc_frame *cmd_frame)
@@ -241,15 +256,12 @@ namespace avdecc_lib
         {
             case JDKSAVDECC_AECP_MESSAGE_TYPE_AEM_RESPONSE:
             case JDKSAVDECC_AECP_MESSAGE_TYPE_ADDRESS_ACCESS_RESPONSE: // Fallthrough intentional
-                if (u_field)
-                {
-                    state_rcvd_unsolicited(notification_id, cmd_frame);
-                    state_rcvd_resp(notification_id, cmd_frame);
-                }
-                else
+                if (!u_field)
                 {
                     state_rcvd_resp(notification_id, cmd_frame);
                 }
+                // An unsolicited response carries the sequence id of the entity and not of a command of ours,
+                // it is notified by state_rcvd_unsolicited once the End Station has applied it.
                 break;
             default:
                 log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "Invalid message type");
@@ -312,15 +324,10 @@ namespace avdecc_lib
         return false;
     }
 
-    int aecp_controller_state_machine::callback(void *notification_id, uint32_t notification_flag, uint8_t *frame)
+    void aecp_controller_state_machine::aem_resp_desc(uint16_t cmd_type, const uint8_t *frame, uint16_t &desc_type, uint16_t &desc_index)
     {
-        uint32_t msg_type = jdksavdecc_common_control_header_get_control_data(frame, ETHER_HDR_SIZE);
-
-        uint16_t cmd_type = jdksavdecc_aecpdu_aem_get_command_type(frame, ETHER_HDR_SIZE);
-        cmd_type &= 0x7FFF;
-        uint32_t status = jdksavdecc_common_control_header_get_status(frame, ETHER_HDR_SIZE);
-        uint16_t desc_type = 0;
-        uint16_t desc_index = 0;
+        desc_type = 0;
+        desc_index = 0;
 
         switch(cmd_type)
         {
@@ -340,6 +347,10 @@ namespace avdecc_lib
         case JDKSAVDECC_AEM_COMMAND_CONTROLLER_AVAILABLE:
             break;
 
+        case JDKSAVDECC_AEM_COMMAND_REGISTER_UNSOLICITED_NOTIFICATION:
+        case JDKSAVDECC_AEM_COMMAND_DEREGISTER_UNSOLICITED_NOTIFICATION:
+            break;
+
         case JDKSAVDECC_AEM_COMMAND_READ_DESCRIPTOR:
             desc_type = jdksavdecc_aem_command_read_descriptor_get_descriptor_type(frame, ETHER_HDR_SIZE);
             desc_index = jdksavdecc_aem_command_read_descriptor_get_descriptor_index(frame, ETHER_HDR_SIZE);
@@ -409,6 +420,19 @@ namespace avdecc_lib
             log_imp_ref->post_log_msg(LOGGING_LEVEL_DEBUG, "NO_MATCH_FOUND for %s", utility::aem_cmd_value_to_name(cmd_type));
             break;
         }
+    }
+
+    int aecp_controller_state_machine::callback(void *notification_id, uint32_t notification_flag, uint8_t *frame)
+    {
+        uint32_t msg_type = jdksavdecc_common_control_header_get_control_data(frame, ETHER_HDR_SIZE);
+
+        uint16_t cmd_type = jdksavdecc_aecpdu_aem_get_command_type(frame, ETHER_HDR_SIZE);
+        cmd_type &= 0x7FFF;
+        uint32_t status = jdksavdecc_common_control_header_get_status(frame, ETHER_HDR_SIZE);
+        uint16_t desc_type = 0;
+        uint16_t desc_index = 0;
+
+        aem_resp_desc(cmd_type, frame, desc_type, desc_index);
 
         jdksavdecc_eui64 id = jdksavdecc_common_control_header_get_stream_id(frame, ETHER_HDR_SIZE);
         if((notification_flag == CMD_WITH_NOTIFICATION) &&
@@ -479,14 +503,6 @@ namespace avdecc_lib
 
     bool aecp_controller_state_machine::is_inflight_cmd_with_notification_id(void *notification_id)
     {
-       std::vector<inflight>::iterator j =
-            std::find_if(inflight_cmds.begin(), inflight_cmds.end(), NotificationComp(notification_id));
-
-        if(j != inflight_cmds.end()) // found?
-        {
-            return true;
-        }
-
-        return false;
+        return inflight_cmds.has_notification_id(notification_id);
     }
 }
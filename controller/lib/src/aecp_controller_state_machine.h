@@ -29,7 +29,7 @@
 
 #pragma once
 
-#include "inflight.h"
+#include "inflight_table.h"
 #include "operation.h"
 
 namespace avdecc_lib
@@ -40,7 +40,7 @@ namespace avdecc_lib
     {
     private:
         uint16_t aecp_seq_id; // The sequence id used for identifying the AECP command that a response is for
-        std::vector<inflight> inflight_cmds;
+        inflight_table inflight_cmds;
         std::vector<operation> active_operations;
 
     public:
@@ -73,11 +73,6 @@ namespace avdecc_lib
          */
         int state_rcvd_resp(void *&notification_id, struct jdksavdecc_frame *cmd_frame);
 
-        /**
-        * Check timeout for the inflight commands.
-        */
-        void tick();
-
         /**
          * Update inflight command for the response received.
          */
@@ -93,6 +88,14 @@ namespace avdecc_lib
          */
         bool is_inflight_cmd_with_notification_id(void *notification_id);
 
+        /**
+         * Check if the command sent with the sequence id is still waiting for its response.
+         */
+        inline bool is_inflight_seq_id(uint16_t seq_id)
+        {
+            return inflight_cmds.find(seq_id) != NULL;
+        }
+
     private:
         /**
          * Transmit an AEM Command.
@@ -100,10 +103,16 @@ namespace avdecc_lib
         int tx_cmd(void *notification_id, uint32_t notification_flag, struct jdksavdecc_frame *cmd_frame, bool resend);
 
         /**
-         * Handle the receipt and processing of a received unsolicited response for a command sent.
+         * Notify the application of an unsolicited response, sent by an AVDECC Entity when its state
+         * is changed by another controller or locally.
          */
         int proc_unsolicited(void *&notification_id, struct jdksavdecc_frame *cmd_frame);
 
+        /**
+         * Get the descriptor type and index a response is for, both 0 for commands without a descriptor.
+         */
+        void aem_resp_desc(uint16_t cmd_type, const uint8_t *frame, uint16_t &desc_type, uint16_t &desc_index);
+
         /**
          * Handle the receipt and processing of a received response for a command sent.
          */
@@ -113,7 +122,12 @@ namespace avdecc_lib
          * Notify the application that a command has timed out and the retry has timed out and the
          * inflight command is removed from the inflight list.
          */
-        void state_timeout(uint32_t inflight_cmd_index);
+        void state_timeout(inflight *cmd);
+
+        /**
+         * Timer wheel handler for an inflight command timeout.
+         */
+        static void inflight_timeout_cb(void *context);
 
         /**
          * Call notification or post_log_msg callback function for the command sent or response received.
@@ -121,6 +135,6 @@ namespace avdecc_lib
         int callback(void *notification_id, uint32_t notification_flag, uint8_t *frame);
     };
 
-    extern aecp_controller_state_machine *aecp_controller_state_machine_ref;
+    extern thread_local aecp_controller_state_machine *aecp_controller_state_machine_ref; // One per engine shard
 }
 
@@ -37,57 +37,57 @@ namespace avdecc_lib
 {
     audio_map_descriptor_imp::audio_map_descriptor_imp(end_station_imp *end_station_obj, const uint8_t *frame, ssize_t pos, size_t frame_len) : descriptor_base_imp(end_station_obj)
     {
-        ssize_t ret = jdksavdecc_descriptor_audio_map_read(&audio_map_desc, frame, pos, frame_len);
+        size_t desc_len = frame_len - pos;
 
-        if (ret < 0)
+        if ((pos < 0) || (frame_len < (size_t)pos + JDKSAVDECC_DESCRIPTOR_AUDIO_MAP_LEN) ||
+            (desc_len < (size_t)jdksavdecc_descriptor_audio_map_get_mappings_offset(frame, pos) +
+                        jdksavdecc_descriptor_audio_map_get_number_of_mappings(frame, pos) * sizeof(struct audio_map_mapping)))
         {
             throw avdecc_read_descriptor_error("audio_map_desc_read error");
         }
 
-        ssize_t offset = pos + mappings_offset();
-        for (unsigned int i = 0; i < (unsigned int)number_of_mappings(); i++)
-        {
-            struct audio_map_mapping map;
-
-            map.stream_index = jdksavdecc_uint16_get(frame, offset);
-            map.stream_channel = jdksavdecc_uint16_get(frame, offset + 2);
-            map.cluster_offset = jdksavdecc_uint16_get(frame, offset + 4);
-            map.cluster_channel = jdksavdecc_uint16_get(frame, offset + 6);
-            maps.push_back(map);
-            offset += sizeof(struct audio_map_mapping);
-        }
+        audio_map_desc = end_station_obj->store_payload(frame + pos, desc_len);
+        audio_map_desc_len = desc_len;
     }
 
-    audio_map_descriptor_imp::~audio_map_descriptor_imp() {}
+    audio_map_descriptor_imp::~audio_map_descriptor_imp()
+    {
+        // A payload shared through the entity model is not in the arena and stays where it is
+        base_end_station_imp_ref->arena().unstore(audio_map_desc, audio_map_desc_len);
+    }
 
     uint16_t STDCALL audio_map_descriptor_imp::descriptor_type() const
     {
-        assert(audio_map_desc.descriptor_type == JDKSAVDECC_DESCRIPTOR_AUDIO_MAP);
-        return audio_map_desc.descriptor_type;
+        assert(jdksavdecc_descriptor_audio_map_get_descriptor_type(audio_map_desc, 0) == JDKSAVDECC_DESCRIPTOR_AUDIO_MAP);
+        return jdksavdecc_descriptor_audio_map_get_descriptor_type(audio_map_desc, 0);
     }
 
     uint16_t STDCALL audio_map_descriptor_imp::descriptor_index() const
     {
-        return audio_map_desc.descriptor_index;
+        return jdksavdecc_descriptor_audio_map_get_descriptor_index(audio_map_desc, 0);
     }
 
     uint16_t audio_map_descriptor_imp::mappings_offset()
     {
-        assert(audio_map_desc.mappings_offset == 8);
-        return audio_map_desc.mappings_offset;
+        assert(jdksavdecc_descriptor_audio_map_get_mappings_offset(audio_map_desc, 0) == 8);
+        return jdksavdecc_descriptor_audio_map_get_mappings_offset(audio_map_desc, 0);
     }
 
     uint16_t STDCALL audio_map_descriptor_imp::number_of_mappings()
     {
-        return audio_map_desc.number_of_mappings;
+        return jdksavdecc_descriptor_audio_map_get_number_of_mappings(audio_map_desc, 0);
     }
     
     int STDCALL audio_map_descriptor_imp::mapping(size_t index, struct audio_map_mapping &map)
     {
-        if (index >= audio_map_desc.number_of_mappings)
+        if (index >= number_of_mappings())
             return -1;
 
-        map = maps.at(index);
+        const uint8_t *p = audio_map_desc + mappings_offset() + index * sizeof(struct audio_map_mapping);
+        map.stream_index = jdksavdecc_uint16_get(p, 0);
+        map.stream_channel = jdksavdecc_uint16_get(p, 2);
+        map.cluster_offset = jdksavdecc_uint16_get(p, 4);
+        map.cluster_channel = jdksavdecc_uint16_get(p, 6);
         return 0;
     }
 
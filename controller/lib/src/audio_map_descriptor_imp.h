@@ -38,8 +38,8 @@ namespace avdecc_lib
     {
 
     private:
-        struct jdksavdecc_descriptor_audio_map audio_map_desc; // Structure containing the audio_map_desc fields
-        std::vector<struct audio_map_mapping> maps; // Store maps in a vector
+        const uint8_t *audio_map_desc; // The AUDIO_MAP descriptor payload, shared with End Stations of the same entity model
+        size_t audio_map_desc_len;
 
     public:
         audio_map_descriptor_imp(end_station_imp *end_station_obj, const uint8_t *frame, ssize_t pos, size_t frame_len);
@@ -0,0 +1,250 @@
+/*
+ * Licensed under the MIT License (MIT)
+ *
+ * Copyright (c) 2014 AudioScience Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * bulk_cmd_queue.cpp
+ *
+ * Bulk command queue implementation
+ */
+
+#include "net_interface_imp.h"
+#include "enumeration.h"
+#include "end_station_imp.h"
+#include "acmp_controller_state_machine.h"
+#include "aecp_controller_state_machine.h"
+#include "controller_imp.h"
+#include "bulk_cmd_queue.h"
+
+namespace avdecc_lib
+{
+    bulk_cmd_queue::bulk_cmd_queue() {}
+
+    bulk_cmd_queue::~bulk_cmd_queue()
+    {
+        for (auto it = destinations.begin(); it != destinations.end(); ++it)
+        {
+            for (size_t i = 0; i < it->second.queued.size(); i++)
+            {
+                struct bulk_cmd_batch *batch = it->second.queued[i].batch;
+
+                if (--batch->unsent == 0)
+                    delete batch;
+            }
+        }
+    }
+
+    void bulk_cmd_queue::add(struct bulk_cmd_batch *batch)
+    {
+        for (size_t i = 0; i < batch->frames.size(); i++)
+        {
+            struct queued_cmd cmd;
+            cmd.batch = batch;
+            cmd.frame = &batch->frames[i];
+
+            auto it = destinations.find(cmd.frame->entity_id);
+            if (it == destinations.end())
+            {
+                it = destinations.insert(std::make_pair(cmd.frame->entity_id, destination())).first;
+                it->second.inflight = 0;
+            }
+
+            it->second.queued.push_back(cmd);
+        }
+
+        auto state = batch_states.find(batch->notification_id);
+        if (state == batch_states.end())
+        {
+            struct batch_state new_state = {0, AEM_STATUS_SUCCESS};
+            state = batch_states.insert(std::make_pair(batch->notification_id, new_state)).first;
+        }
+        state->second.remaining += (uint32_t)batch->frames.size();
+
+        // Start every End Station with free slots, the remaining frames go out as earlier ones complete.
+        // The batch may be deleted by the last fill, so collect the End Stations first.
+        released.clear();
+        for (size_t i = 0; i < batch->frames.size(); i++)
+            released.push_back(batch->frames[i].entity_id);
+
+        for (size_t i = 0; i < released.size(); i++)
+            fill(released[i]);
+    }
+
+    bool bulk_cmd_queue::has_notification_id(void *notification_id) const
+    {
+        return batch_states.find(notification_id) != batch_states.end();
+    }
+
+    bool bulk_cmd_queue::tick_status(void *notification_id, int &status) const
+    {
+        auto it = tick_ended.find(notification_id);
+
+        if (it == tick_ended.end())
+            return false;
+
+        status = it->second;
+        return true;
+    }
+
+    bool bulk_cmd_queue::cmd_ended(void *notification_id, int cmd_status)
+    {
+        auto it = batch_states.find(notification_id);
+
+        if (it == batch_states.end())
+            return false;
+
+        // A failure early in the batch is not hidden by later commands that succeed
+        if (it->second.status == AEM_STATUS_SUCCESS)
+            it->second.status = cmd_status;
+
+        return --it->second.remaining == 0;
+    }
+
+    void bulk_cmd_queue::rx_event(const uint8_t *frame, int &status)
+    {
+        if (outstanding.empty())
+            return;
+
+        uint8_t subtype = jdksavdecc_common_control_header_get_subtype(frame, ETHER_HDR_SIZE);
+        uint16_t seq_id;
+
+        if (subtype == JDKSAVDECC_SUBTYPE_AECP)
+            seq_id = jdksavdecc_aecpdu_common_get_sequence_id(frame, ETHER_HDR_SIZE);
+        else if (subtype == JDKSAVDECC_SUBTYPE_ACMP)
+            seq_id = jdksavdecc_acmpdu_get_sequence_id(frame, ETHER_HDR_SIZE);
+        else
+            return;
+
+        uint32_t key = ((uint32_t)subtype << 16) | seq_id;
+        auto it = outstanding.find(key);
+
+        if ((it != outstanding.end()) && !is_inflight(key))
+        {
+            struct sent_cmd cmd = it->second;
+            outstanding.erase(it);
+
+            if (cmd_ended(cmd.notification_id, status))
+            {
+                status = batch_states[cmd.notification_id].status;
+                batch_states.erase(cmd.notification_id);
+            }
+
+            release(cmd.entity_id);
+        }
+    }
+
+    void bulk_cmd_queue::tick_event()
+    {
+        released.clear();
+        tick_ended.clear();
+
+        for (auto it = outstanding.begin(); it != outstanding.end();)
+        {
+            if (is_inflight(it->first))
+            {
+                ++it;
+            }
+            else
+            {
+                cmd_ended(it->second.notification_id, AVDECC_LIB_STATUS_TICK_TIMEOUT);
+                released.push_back(it->second.entity_id);
+                it = outstanding.erase(it);
+            }
+        }
+
+        // Batches that ended without a response are completed by the tick, with the status they ended with
+        for (auto it = batch_states.begin(); it != batch_states.end();)
+        {
+            if (it->second.remaining == 0)
+            {
+                tick_ended[it->first] = it->second.status;
+                it = batch_states.erase(it);
+            }
+            else
+            {
+                ++it;
+            }
+        }
+
+        for (size_t i = 0; i < released.size(); i++)
+            release(released[i]);
+    }
+
+    void bulk_cmd_queue::fill(uint64_t entity_id)
+    {
+        struct destination &dest = destinations[entity_id];
+
+        while (!dest.queued.empty() && (dest.inflight < dest.queued.front().batch->entity_limit))
+        {
+            struct queued_cmd cmd = dest.queued.front();
+            dest.queued.pop_front();
+
+            void *notification_id = cmd.batch->notification_id;
+            controller_imp_ref->tx_packet_event(notification_id, CMD_WITH_NOTIFICATION, cmd.frame->payload, cmd.frame->length);
+
+            // The state machines fill in the sequence id of the frame
+            uint8_t subtype = jdksavdecc_common_control_header_get_subtype(cmd.frame->payload, ETHER_HDR_SIZE);
+            uint16_t seq_id = (subtype == JDKSAVDECC_SUBTYPE_AECP) ?
+                              jdksavdecc_aecpdu_common_get_sequence_id(cmd.frame->payload, ETHER_HDR_SIZE) :
+                              jdksavdecc_acmpdu_get_sequence_id(cmd.frame->payload, ETHER_HDR_SIZE);
+            uint32_t key = ((uint32_t)subtype << 16) | seq_id;
+
+            if (is_inflight(key))
+            {
+                struct sent_cmd sent = {entity_id, notification_id};
+                outstanding[key] = sent;
+                dest.inflight++;
+            }
+            else
+            {
+                // Not sent, the batch is completed by the next tick if this was its last command
+                cmd_ended(notification_id, AVDECC_LIB_STATUS_INVALID);
+            }
+
+            if (--cmd.batch->unsent == 0)
+                delete cmd.batch;
+        }
+    }
+
+    bool bulk_cmd_queue::is_inflight(uint32_t key)
+    {
+        uint16_t seq_id = (uint16_t)(key & 0xFFFF);
+
+        if ((key >> 16) == JDKSAVDECC_SUBTYPE_AECP)
+            return aecp_controller_state_machine_ref->is_inflight_seq_id(seq_id);
+        else
+            return acmp_controller_state_machine_ref->is_inflight_seq_id(seq_id);
+    }
+
+    void bulk_cmd_queue::release(uint64_t entity_id)
+    {
+        auto it = destinations.find(entity_id);
+        if (it == destinations.end())
+            return;
+
+        it->second.inflight--;
+        fill(entity_id);
+
+        if (it->second.queued.empty() && (it->second.inflight == 0))
+            destinations.erase(it);
+    }
+}
@@ -0,0 +1,150 @@
+/*
+ * Licensed under the MIT License (MIT)
+ *
+ * Copyright (c) 2014 AudioScience Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * bulk_cmd_queue.h
+ *
+ * Commands submitted with controller::send_bulk_cmds, sent with a limited number inflight to each End Station.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <deque>
+#include <vector>
+#include <unordered_map>
+
+namespace avdecc_lib
+{
+    /**
+     * A command frame built by the application thread that submitted the batch.
+     */
+    struct bulk_cmd_frame
+    {
+        enum bulk_cmd_frame_consts
+        {
+            FRAME_SIZE = 128
+        };
+
+        uint64_t entity_id; // The End Station the command is sent to
+        uint16_t length;
+        uint8_t payload[FRAME_SIZE];
+    };
+
+    /**
+     * The commands of one send_bulk_cmds call, handed to the system layer as a single queued frame.
+     */
+    struct bulk_cmd_batch
+    {
+        void *notification_id;
+        uint16_t entity_limit; // Commands of the batch inflight to one End Station at a time
+        size_t unsent; // Deleted when every frame has been sent
+        std::vector<struct bulk_cmd_frame> frames;
+    };
+
+    class bulk_cmd_queue
+    {
+    public:
+        bulk_cmd_queue();
+
+        ~bulk_cmd_queue();
+
+        /**
+         * Take ownership of the batch and send as many of its commands as the End Station limits allow.
+         */
+        void add(struct bulk_cmd_batch *batch);
+
+        /**
+         * \return True if a batch with the notification id has commands that have not ended, or has
+         *         ended without a response and waits for the next tick_event to be completed.
+         */
+        bool has_notification_id(void *notification_id) const;
+
+        /**
+         * Release the End Station slot of a command once the received frame has completed it. If the
+         * response ends the batch, status is set to the first status of the batch that was not a success.
+         */
+        void rx_event(const uint8_t *frame, int &status);
+
+        /**
+         * Release the End Station slots of commands that have timed out.
+         */
+        void tick_event();
+
+        /**
+         * \return True if a batch with the notification id was ended by the last tick_event, with status
+         *         set to the first status of the batch that was not a success.
+         */
+        bool tick_status(void *notification_id, int &status) const;
+
+    private:
+        struct queued_cmd
+        {
+            struct bulk_cmd_batch *batch;
+            struct bulk_cmd_frame *frame;
+        };
+
+        struct destination
+        {
+            std::deque<struct queued_cmd> queued;
+            uint16_t inflight;
+        };
+
+        struct sent_cmd
+        {
+            uint64_t entity_id;
+            void *notification_id;
+        };
+
+        struct batch_state
+        {
+            uint32_t remaining; // Commands of the batch that have not ended
+            int status; // First status of the batch that was not a success
+        };
+
+        std::unordered_map<uint64_t, struct destination> destinations; // Indexed by End Station Entity ID
+        std::unordered_map<uint32_t, struct sent_cmd> outstanding; // Each sent command, by subtype and sequence id
+        std::unordered_map<void *, struct batch_state> batch_states; // Batches that have not been completed, by notification id
+        std::unordered_map<void *, int> tick_ended; // Status of the batches ended by the last tick_event, by notification id
+        std::vector<uint64_t> released; // End Stations to fill after sending or timing out commands
+
+        /**
+         * Send queued commands to the End Station while it has free slots.
+         */
+        void fill(uint64_t entity_id);
+
+        /**
+         * \return True if the command sent with the subtype and sequence id is still inflight.
+         */
+        bool is_inflight(uint32_t key);
+
+        /**
+         * Account for the end of one command of the batch.
+         *
+         * \return True if it was the last command of the batch.
+         */
+        bool cmd_ended(void *notification_id, int cmd_status);
+
+        void release(uint64_t entity_id);
+    };
+}
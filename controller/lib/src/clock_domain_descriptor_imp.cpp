@@ -41,72 +41,73 @@ namespace avdecc_lib
 {
     clock_domain_descriptor_imp::clock_domain_descriptor_imp(end_station_imp *end_station_obj, const uint8_t *frame, ssize_t pos, size_t frame_len) : descriptor_base_imp(end_station_obj)
     {
-        ssize_t ret = jdksavdecc_descriptor_clock_domain_read(&clock_domain_desc, frame, pos, frame_len);
+        size_t desc_len = frame_len - pos;
 
-        if (ret < 0)
+        if ((pos < 0) || (frame_len < (size_t)pos + JDKSAVDECC_DESCRIPTOR_CLOCK_DOMAIN_LEN) ||
+            (desc_len < (size_t)jdksavdecc_descriptor_clock_domain_get_clock_sources_offset(frame, pos) +
+                        jdksavdecc_descriptor_clock_domain_get_clock_sources_count(frame, pos) * 2))
         {
             throw avdecc_read_descriptor_error("clock_domain_desc_read error");
         }
 
-        store_clock_sources(frame, pos);
+        clock_domain_desc = end_station_obj->arena().store(frame + pos, desc_len);
+        clock_domain_desc_len = desc_len;
         memset(&aem_cmd_set_clk_src_resp, 0, sizeof(struct jdksavdecc_aem_command_set_clock_source_response));
         memset(&aem_cmd_get_clk_src_resp, 0, sizeof(struct jdksavdecc_aem_command_get_clock_source_response));
     }
 
-    clock_domain_descriptor_imp::~clock_domain_descriptor_imp() {}
+    clock_domain_descriptor_imp::~clock_domain_descriptor_imp()
+    {
+        base_end_station_imp_ref->arena().unstore(clock_domain_desc, clock_domain_desc_len);
+    }
 
     uint16_t STDCALL clock_domain_descriptor_imp::descriptor_type() const
     {
-        assert(clock_domain_desc.descriptor_type == JDKSAVDECC_DESCRIPTOR_CLOCK_DOMAIN);
-        return clock_domain_desc.descriptor_type;
+        assert(jdksavdecc_descriptor_clock_domain_get_descriptor_type(clock_domain_desc, 0) == JDKSAVDECC_DESCRIPTOR_CLOCK_DOMAIN);
+        return jdksavdecc_descriptor_clock_domain_get_descriptor_type(clock_domain_desc, 0);
     }
 
     uint16_t STDCALL clock_domain_descriptor_imp::descriptor_index() const
     {
-        return clock_domain_desc.descriptor_index;
+        return jdksavdecc_descriptor_clock_domain_get_descriptor_index(clock_domain_desc, 0);
     }
 
     uint8_t * STDCALL clock_domain_descriptor_imp::object_name()
     {
-        return clock_domain_desc.object_name.value;
+        return clock_domain_desc + JDKSAVDECC_DESCRIPTOR_CLOCK_DOMAIN_OFFSET_OBJECT_NAME;
     }
 
     uint16_t STDCALL clock_domain_descriptor_imp::localized_description()
     {
-        return clock_domain_desc.localized_description;
+        return jdksavdecc_descriptor_clock_domain_get_localized_description(clock_domain_desc, 0);
     }
 
     uint16_t STDCALL clock_domain_descriptor_imp::clock_source_index()
     {
-        return clock_domain_desc.clock_source_index;
+        return jdksavdecc_descriptor_clock_domain_get_clock_source_index(clock_domain_desc, 0);
     }
 
     uint16_t clock_domain_descriptor_imp::clock_sources_offset()
     {
-        assert(clock_domain_desc.clock_sources_offset == 76);
-        return clock_domain_desc.clock_sources_offset;
+        assert(jdksavdecc_descriptor_clock_domain_get_clock_sources_offset(clock_domain_desc, 0) == 76);
+        return jdksavdecc_descriptor_clock_domain_get_clock_sources_offset(clock_domain_desc, 0);
     }
 
     uint16_t STDCALL clock_domain_descriptor_imp::clock_sources_count()
     {
-        assert(clock_domain_desc.clock_sources_count <= 249);
-        return clock_domain_desc.clock_sources_count;
+        assert(jdksavdecc_descriptor_clock_domain_get_clock_sources_count(clock_domain_desc, 0) <= 249);
+        return jdksavdecc_descriptor_clock_domain_get_clock_sources_count(clock_domain_desc, 0);
     }
 
-    void clock_domain_descriptor_imp::store_clock_sources(const uint8_t *frame, size_t pos)
+    uint16_t STDCALL clock_domain_descriptor_imp::get_clock_source_by_index(size_t clk_src_index)
     {
-        uint16_t offset = 0;
-
-        for(uint32_t i = 0; i < clock_sources_count(); i++)
+        if (clk_src_index >= clock_sources_count())
         {
-            clk_src_vec.push_back(jdksavdecc_uint16_get(frame, clock_sources_offset() + pos + offset));
-            offset += 0x2;
+            log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "get_clock_source_by_index error");
+            return 0xffff;
         }
-    }
 
-    uint16_t STDCALL clock_domain_descriptor_imp::get_clock_source_by_index(size_t clk_src_index)
-    {
-        return clk_src_vec.at(clk_src_index);
+        return jdksavdecc_uint16_get(clock_domain_desc, clock_sources_offset() + clk_src_index * 2);
     }
 
     uint16_t STDCALL clock_domain_descriptor_imp::set_clock_source_clock_source_index()
@@ -116,7 +117,7 @@ namespace avdecc_lib
 
     void clock_domain_descriptor_imp::update_clock_source_index(uint16_t clock_source_index)
     {
-        clock_domain_desc.clock_source_index = clock_source_index;
+        jdksavdecc_descriptor_clock_domain_set_clock_source_index(clock_source_index, clock_domain_desc, 0);
     }
 
     uint16_t STDCALL clock_domain_descriptor_imp::get_clock_source_clock_source_index()
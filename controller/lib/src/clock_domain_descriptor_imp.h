@@ -37,8 +37,8 @@ namespace avdecc_lib
     class clock_domain_descriptor_imp : public clock_domain_descriptor, public virtual descriptor_base_imp
     {
     private:
-        struct jdksavdecc_descriptor_clock_domain clock_domain_desc; // Store the CLOCK DOMAIN Descriptor fields
-        std::vector<uint16_t> clk_src_vec; // Store clock sources in a vector
+        uint8_t *clock_domain_desc; // The CLOCK DOMAIN descriptor payload held in the End Station's arena
+        size_t clock_domain_desc_len;
 
         struct jdksavdecc_aem_command_set_clock_source_response aem_cmd_set_clk_src_resp; // Store the response received after sending a SET_CLOCK_SOURCE command
         struct jdksavdecc_aem_command_get_clock_source_response aem_cmd_get_clk_src_resp; // Store the response received after sending a GET_CLOCK_SOURCE command
@@ -63,11 +63,6 @@ namespace avdecc_lib
         int proc_get_clock_source_resp(void *&notification_id, const uint8_t *frame, size_t frame_len, int &status);
 
     private:
-        /**
-        * Store the Clock Sources of the CLOCK DOMAIN object.
-        */
-        void store_clock_sources(const uint8_t *frame, size_t pos);
-
         /**
          * Update the internal CLOCK DOMAIN's clock source field.
          */
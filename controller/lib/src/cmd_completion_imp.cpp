@@ -0,0 +1,290 @@
+/*
+ * Licensed under the MIT License (MIT)
+ *
+ * Copyright (c) 2014 AudioScience Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * cmd_completion_imp.cpp
+ *
+ * Command completion token implementation
+ */
+
+#include <chrono>
+#include "enumeration.h"
+#include "log_imp.h"
+#include "cmd_completion_imp.h"
+
+namespace avdecc_lib
+{
+    cmd_completion_imp::cmd_completion_imp(void *notification_id, cmd_completion_table *table) :
+        id(notification_id), owner(table), creator(std::this_thread::get_id()), done(false), completion_status(0), refs(2) {}
+
+    cmd_completion_imp::~cmd_completion_imp() {}
+
+    void * STDCALL cmd_completion_imp::notification_id()
+    {
+        return id;
+    }
+
+    bool STDCALL cmd_completion_imp::is_complete()
+    {
+        cancel_if_unsent();
+
+        std::lock_guard<std::mutex> guard(lock);
+        return done;
+    }
+
+    int STDCALL cmd_completion_imp::wait(int32_t timeout_ms)
+    {
+        cancel_if_unsent();
+
+        std::unique_lock<std::mutex> guard(lock);
+
+        if (timeout_ms < 0)
+        {
+            done_cond.wait(guard, [this] { return done; });
+            return 0;
+        }
+
+        return done_cond.wait_for(guard, std::chrono::milliseconds(timeout_ms), [this] { return done; }) ? 0 : -1;
+    }
+
+    int STDCALL cmd_completion_imp::get_status()
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        return completion_status;
+    }
+
+    void STDCALL cmd_completion_imp::release()
+    {
+        bool is_done;
+
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            is_done = done;
+        }
+
+        // Nobody will send the command of a released token any more
+        if (!is_done)
+            owner->cancel_unsent(this);
+
+        unref();
+    }
+
+    void cmd_completion_imp::complete(int status)
+    {
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            completion_status = status;
+            done = true;
+        }
+        done_cond.notify_all();
+    }
+
+    void cmd_completion_imp::unref()
+    {
+        if (refs.fetch_sub(1) == 1)
+            delete this;
+    }
+
+    void cmd_completion_imp::cancel_if_unsent()
+    {
+        // The thread that creates the token sends the command before waiting on it, so by now
+        // the command has been queued unless sending it failed
+        if (std::this_thread::get_id() != creator)
+            return;
+
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            if (done)
+                return;
+        }
+
+        owner->cancel_unsent(this);
+    }
+
+    cmd_completion_table::cmd_completion_table() : active_count(0) {}
+
+    cmd_completion_table::~cmd_completion_table()
+    {
+        // Wake up anybody still waiting, the commands will never complete now
+        for (auto it = entries.begin(); it != entries.end(); ++it)
+        {
+            it->second.completion->complete(AVDECC_LIB_STATUS_TICK_TIMEOUT);
+            it->second.completion->unref();
+        }
+    }
+
+    cmd_completion_imp * cmd_completion_table::create(void *notification_id)
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        struct entry e;
+
+        if (entries.find(notification_id) != entries.end())
+        {
+            log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "Notification id %p already has a command completion", notification_id);
+            return NULL;
+        }
+
+        e.completion = new cmd_completion_imp(notification_id, this);
+        e.active = false;
+        e.pending_parts = 0;
+        e.status = AEM_STATUS_SUCCESS;
+        entries[notification_id] = e;
+
+        return e.completion;
+    }
+
+    int cmd_completion_table::set_wait_for_next_cmd(void *notification_id)
+    {
+        cmd_completion_imp *completion = create(notification_id);
+        cmd_completion_imp *stale = NULL;
+
+        if (!completion)
+            return -1;
+
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            struct thread_wait &w = thread_waits[std::this_thread::get_id()];
+
+            // A previously primed command that was never sent will not be waited on any more
+            if (w.primed)
+            {
+                auto it = entries.find(w.primed->notification_id());
+                if ((it != entries.end()) && !it->second.active)
+                {
+                    stale = w.primed;
+                    entries.erase(it);
+                }
+            }
+            w.primed = completion;
+        }
+
+        if (stale)
+        {
+            stale->unref();
+            stale->release();
+        }
+
+        return 0;
+    }
+
+    int cmd_completion_table::get_last_resp_status()
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        auto it = thread_waits.find(std::this_thread::get_id());
+
+        return (it != thread_waits.end()) ? it->second.last_status : 0;
+    }
+
+    cmd_completion_imp * cmd_completion_table::cmd_queued(void *notification_id, uint32_t notification_flag, uint32_t parts)
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        cmd_completion_imp *primed = NULL;
+
+        if (notification_flag == CMD_WITHOUT_NOTIFICATION)
+            return NULL;
+
+        auto it = entries.find(notification_id);
+        if ((it == entries.end()) || it->second.active)
+            return NULL;
+
+        it->second.active = true;
+        it->second.pending_parts = parts;
+        active_count++;
+
+        auto w = thread_waits.find(std::this_thread::get_id());
+        if ((w != thread_waits.end()) && (w->second.primed == it->second.completion))
+        {
+            primed = w->second.primed;
+            w->second.primed = NULL;
+        }
+
+        return primed;
+    }
+
+    void cmd_completion_table::wait_for_primed(cmd_completion_imp *primed)
+    {
+        primed->wait(-1);
+
+        std::lock_guard<std::mutex> guard(lock);
+        thread_waits[std::this_thread::get_id()].last_status = primed->get_status();
+        primed->release();
+    }
+
+    void cmd_completion_table::get_active_ids(std::vector<void *> &ids)
+    {
+        std::lock_guard<std::mutex> guard(lock);
+
+        ids.clear();
+        for (auto it = entries.begin(); it != entries.end(); ++it)
+        {
+            if (it->second.active)
+                ids.push_back(it->first);
+        }
+    }
+
+    void cmd_completion_table::complete(void *notification_id, int status)
+    {
+        cmd_completion_imp *completion;
+
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            auto it = entries.find(notification_id);
+
+            if ((it == entries.end()) || !it->second.active)
+                return;
+
+            if (it->second.status != AEM_STATUS_SUCCESS)
+                status = it->second.status;
+
+            if (--it->second.pending_parts > 0)
+            {
+                it->second.status = status;
+                return;
+            }
+
+            completion = it->second.completion;
+            entries.erase(it);
+            active_count--;
+        }
+
+        completion->complete(status);
+        completion->unref();
+    }
+
+    void cmd_completion_table::cancel_unsent(cmd_completion_imp *completion)
+    {
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            auto it = entries.find(completion->notification_id());
+
+            if ((it == entries.end()) || (it->second.completion != completion) || it->second.active)
+                return;
+
+            entries.erase(it);
+        }
+
+        log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "Command with notification id %p was not sent", completion->notification_id());
+        completion->complete(AVDECC_LIB_STATUS_INVALID);
+        completion->unref();
+    }
+}
@@ -0,0 +1,178 @@
+/*
+ * Licensed under the MIT License (MIT)
+ *
+ * Copyright (c) 2014 AudioScience Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * cmd_completion_imp.h
+ *
+ * Completion tokens for commands sent from application threads, and the table the system
+ * layer uses to complete them.
+ *
+ * Application threads create tokens and wait on them. The avdecc-lib "lib" thread completes
+ * a token when the response to its command is received (fn_netif) or when the command is
+ * timed out (fn_timer). A token whose command was never sent is completed when the thread
+ * that created it waits on it, and leaves the table when it is released. Each token is
+ * shared by the application and the table, and is freed once the command has completed and
+ * the application has released it.
+ *
+ * The set_wait_for_next_cmd/get_last_resp_status API is built on the same tokens, with one
+ * primed token per application thread instead of one for the whole process.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "build.h"
+#include "cmd_completion.h"
+
+namespace avdecc_lib
+{
+    class cmd_completion_table;
+
+    class cmd_completion_imp : public cmd_completion
+    {
+    public:
+        cmd_completion_imp(void *notification_id, cmd_completion_table *table);
+        virtual ~cmd_completion_imp();
+
+        void * STDCALL notification_id();
+        bool STDCALL is_complete();
+        int STDCALL wait(int32_t timeout_ms);
+        int STDCALL get_status();
+        void STDCALL release();
+
+        /**
+         * Record the completion status and wake up every waiting thread.
+         */
+        void complete(int status);
+
+        /**
+         * Drop one reference, freeing the token when it was the last one.
+         */
+        void unref();
+
+    private:
+        void *id;
+        cmd_completion_table *owner; // Only used while the token is not complete
+        std::thread::id creator; // The thread that sends the command
+        std::mutex lock;
+        std::condition_variable done_cond;
+        bool done;
+        int completion_status;
+        std::atomic<int> refs; // Held by the application and by the completion table
+
+        /**
+         * Complete the token if its command has not been queued for sending.
+         */
+        void cancel_if_unsent();
+    };
+
+    class cmd_completion_table
+    {
+    public:
+        cmd_completion_table();
+        ~cmd_completion_table();
+
+        /**
+         * Create a token for the next command sent with the notification id.
+         *
+         * \return The token, or NULL if the notification id already has one.
+         */
+        cmd_completion_imp * create(void *notification_id);
+
+        /**
+         * Make the calling thread block in cmd_queued() on the next command sent with the notification id.
+         */
+        int set_wait_for_next_cmd(void *notification_id);
+
+        /**
+         * \return The completion status of the last command the calling thread blocked on.
+         */
+        int get_last_resp_status();
+
+        /**
+         * Called before a command is queued for sending. Marks the token of the command active, so that
+         * it can be completed.
+         *
+         * \param parts The number of engine shards the command was split across, each of which completes it.
+         * \return The token if the calling thread primed it with set_wait_for_next_cmd, otherwise NULL.
+         */
+        cmd_completion_imp * cmd_queued(void *notification_id, uint32_t notification_flag, uint32_t parts = 1);
+
+        /**
+         * Block until the command primed with set_wait_for_next_cmd completes and record its status
+         * for get_last_resp_status.
+         */
+        void wait_for_primed(cmd_completion_imp *primed);
+
+        /**
+         * \return True if there are commands with tokens that have been sent and not completed.
+         */
+        inline bool has_active()
+        {
+            return active_count.load(std::memory_order_relaxed) > 0;
+        }
+
+        /**
+         * Get the notification ids of the commands with tokens that have been sent and not completed.
+         */
+        void get_active_ids(std::vector<void *> &ids);
+
+        /**
+         * Complete the token of a sent command, if it has one. A command split across engine shards is
+         * completed by the last of them, with the status of the first part that failed.
+         */
+        void complete(void *notification_id, int status);
+
+        /**
+         * Complete the token with AVDECC_LIB_STATUS_INVALID and remove it from the table if its command
+         * has not been queued for sending.
+         */
+        void cancel_unsent(cmd_completion_imp *completion);
+
+    private:
+        struct entry
+        {
+            cmd_completion_imp *completion;
+            bool active; // The command has been queued for sending
+            uint32_t pending_parts; // Engine shards that have not completed the command yet
+            int status; // Status of the first completed part that failed
+        };
+
+        struct thread_wait
+        {
+            cmd_completion_imp *primed;
+            int last_status;
+        };
+
+        std::mutex lock;
+        std::unordered_map<void *, struct entry> entries;
+        std::atomic<uint32_t> active_count;
+        std::unordered_map<std::thread::id, struct thread_wait> thread_waits;
+    };
+}
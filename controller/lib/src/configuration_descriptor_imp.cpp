@@ -53,30 +53,19 @@ namespace avdecc_lib
         desc_count_vec_init(frame, pos);
     }
 
-    template <typename T>
-    void delete_pointed_to(T* const ptr)
-    {
-        delete ptr;
-    }
-
-    configuration_descriptor_imp::~configuration_descriptor_imp()
-    {
-        std::map<uint16_t, DITEM>::iterator it;
-        for (it = m_all_desc.begin(); it != m_all_desc.end(); ++it)
-            std::for_each(it->second.begin(), it->second.end(), delete_pointed_to<descriptor_base_imp>);
-        m_all_desc.clear();
-    }
+    configuration_descriptor_imp::~configuration_descriptor_imp() {}
 
     size_t configuration_descriptor_imp::desc_count(uint16_t desc_type)
     {
-        if (m_all_desc.find(desc_type) == m_all_desc.end())
+        if (desc_type >= TOTAL_NUM_OF_AEM_DESCS)
             return 0;
         else
             return m_all_desc[desc_type].size();
     }
+
     descriptor_base_imp *configuration_descriptor_imp::lookup_desc(uint16_t desc_type, size_t index)
     {
-        if (desc_count(desc_type) < index)
+        if (index >= desc_count(desc_type))
         {
             log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "0x%llx, lookup_desc(%s,%d) error",
                                       base_end_station_imp_ref->entity_id(),
@@ -86,7 +75,24 @@ namespace avdecc_lib
         }
         else
         {
-            return m_all_desc[desc_type].at(index);
+            return m_all_desc[desc_type][index].base;
+        }
+    }
+
+    template <class T>
+    T *configuration_descriptor_imp::typed_desc(uint16_t desc_type, size_t index)
+    {
+        if (index >= desc_count(desc_type))
+        {
+            log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "0x%llx, lookup_desc(%s,%d) error",
+                                      base_end_station_imp_ref->entity_id(),
+                                      utility::aem_desc_value_to_name(desc_type),
+                                      index);
+            return NULL;
+        }
+        else
+        {
+            return static_cast<T *>(m_all_desc[desc_type][index].imp);
         }
     }
 
@@ -212,107 +218,124 @@ namespace avdecc_lib
     }
     */
 
-    void configuration_descriptor_imp::update_desc_database(descriptor_base_imp *desc)
+    template <class T>
+    void configuration_descriptor_imp::update_desc_database(T *desc)
     {
         uint16_t desc_type = desc->descriptor_type();
         uint16_t desc_index = desc->descriptor_index();
 
-        if (m_all_desc[desc_type].size() <= desc_index)
-            m_all_desc[desc_type].resize(desc_index + 1);
-        if (m_all_desc[desc_type][desc_index])
-            delete m_all_desc[desc_type][desc_index];
-        m_all_desc[desc_type][desc_index] = desc;
-    }
+        if (desc_type >= TOTAL_NUM_OF_AEM_DESCS)
+        {
+            log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "0x%llx, update_desc_database(0x%x,%d) error",
+                                      base_end_station_imp_ref->entity_id(),
+                                      desc_type,
+                                      desc_index);
+            return;
+        }
 
+        DITEM &descs = m_all_desc[desc_type];
+        if (descs.size() <= desc_index)
+        {
+            desc_entry empty = {NULL, NULL};
+            descs.resize(desc_index + 1, empty);
+        }
+        // A descriptor that is read again replaces the old object, whose space the next re-read reuses
+        if (descs[desc_index].imp)
+        {
+            base_end_station_imp_ref->arena().destroy(descs[desc_index].imp);
+        }
+        descs[desc_index].base = desc;
+        descs[desc_index].imp = desc;
+    }
 
     void configuration_descriptor_imp::store_audio_unit_desc(end_station_imp *end_station_obj, const uint8_t *frame, ssize_t pos, size_t frame_len)
     {
-        update_desc_database(new audio_unit_descriptor_imp(end_station_obj, frame, pos, frame_len));
+        update_desc_database(end_station_obj->arena().create<audio_unit_descriptor_imp>(end_station_obj, frame, pos, frame_len));
     }
 
     void configuration_descriptor_imp::store_stream_input_desc(end_station_imp *end_station_obj, const uint8_t *frame, ssize_t pos, size_t frame_len)
     {
-        update_desc_database(new stream_input_descriptor_imp(end_station_obj, frame, pos, frame_len));
+        update_desc_database(end_station_obj->arena().create<stream_input_descriptor_imp>(end_station_obj, frame, pos, frame_len));
     }
 
     void configuration_descriptor_imp::store_stream_output_desc(end_station_imp *end_station_obj, const uint8_t *frame, ssize_t pos, size_t frame_len)
     {
-        update_desc_database(new stream_output_descriptor_imp(end_station_obj, frame, pos, frame_len));
+        update_desc_database(end_station_obj->arena().create<stream_output_descriptor_imp>(end_station_obj, frame, pos, frame_len));
     }
 
     void configuration_descriptor_imp::store_jack_input_desc(end_station_imp *end_station_obj, const uint8_t *frame, ssize_t pos, size_t frame_len)
     {
-        update_desc_database(new jack_input_descriptor_imp(end_station_obj, frame, pos, frame_len));
+        update_desc_database(end_station_obj->arena().create<jack_input_descriptor_imp>(end_station_obj, frame, pos, frame_len));
     }
 
     void configuration_descriptor_imp::store_jack_output_desc(end_station_imp *end_station_obj, const uint8_t *frame, ssize_t pos, size_t frame_len)
     {
-        update_desc_database(new jack_output_descriptor_imp(end_station_obj, frame, pos, frame_len));
+        update_desc_database(end_station_obj->arena().create<jack_output_descriptor_imp>(end_station_obj, frame, pos, frame_len));
     }
 
     void configuration_descriptor_imp::store_avb_interface_desc(end_station_imp *end_station_obj, const uint8_t *frame, ssize_t pos, size_t frame_len)
     {
-        new avb_interface_descriptor_imp(end_station_obj, frame, pos, frame_len);
+        update_desc_database(end_station_obj->arena().create<avb_interface_descriptor_imp>(end_station_obj, frame, pos, frame_len));
     }
 
     void configuration_descriptor_imp::store_clock_source_desc(end_station_imp *end_station_obj, const uint8_t *frame, ssize_t pos, size_t frame_len)
     {
-        update_desc_database(new clock_source_descriptor_imp(end_station_obj, frame, pos, frame_len));
+        update_desc_database(end_station_obj->arena().create<clock_source_descriptor_imp>(end_station_obj, frame, pos, frame_len));
     }
 
     void configuration_descriptor_imp::store_memory_object_desc(end_station_imp *end_station_obj, const uint8_t *frame, ssize_t pos, size_t frame_len)
     {
-        update_desc_database(new memory_object_descriptor_imp(end_station_obj, frame, pos, frame_len));
+        update_desc_database(end_station_obj->arena().create<memory_object_descriptor_imp>(end_station_obj, frame, pos, frame_len));
     }
 
     void configuration_descriptor_imp::store_locale_desc(end_station_imp *end_station_obj, const uint8_t *frame, ssize_t pos, size_t frame_len)
     {
-        update_desc_database(new locale_descriptor_imp(end_station_obj, frame, pos, frame_len));
+        update_desc_database(end_station_obj->arena().create<locale_descriptor_imp>(end_station_obj, frame, pos, frame_len));
     }
 
     void configuration_descriptor_imp::store_strings_desc(end_station_imp *end_station_obj, const uint8_t *frame, ssize_t pos, size_t frame_len)
     {
-        update_desc_database(new strings_descriptor_imp(end_station_obj, frame, pos, frame_len));
+        update_desc_database(end_station_obj->arena().create<strings_descriptor_imp>(end_station_obj, frame, pos, frame_len));
     }
 
     void configuration_descriptor_imp::store_stream_port_input_desc(end_station_imp *end_station_obj, const uint8_t *frame, ssize_t pos, size_t frame_len)
     {
-        update_desc_database(new stream_port_input_descriptor_imp(end_station_obj, frame, pos, frame_len));
+        update_desc_database(end_station_obj->arena().create<stream_port_input_descriptor_imp>(end_station_obj, frame, pos, frame_len));
     }
 
     void configuration_descriptor_imp::store_stream_port_output_desc(end_station_imp *end_station_obj, const uint8_t *frame, ssize_t pos, size_t frame_len)
     {
-        update_desc_database(new stream_port_output_descriptor_imp(end_station_obj, frame, pos, frame_len));
+        update_desc_database(end_station_obj->arena().create<stream_port_output_descriptor_imp>(end_station_obj, frame, pos, frame_len));
     }
 
     void configuration_descriptor_imp::store_audio_cluster_desc(end_station_imp *end_station_obj, const uint8_t *frame, ssize_t pos, size_t frame_len)
     {
-        update_desc_database(new audio_cluster_descriptor_imp(end_station_obj, frame, pos, frame_len));
+        update_desc_database(end_station_obj->arena().create<audio_cluster_descriptor_imp>(end_station_obj, frame, pos, frame_len));
     }
 
     void configuration_descriptor_imp::store_audio_map_desc(end_station_imp *end_station_obj, const uint8_t *frame, ssize_t pos, size_t frame_len)
     {
-        update_desc_database(new audio_map_descriptor_imp(end_station_obj, frame, pos, frame_len));
+        update_desc_database(end_station_obj->arena().create<audio_map_descriptor_imp>(end_station_obj, frame, pos, frame_len));
     }
 
     void configuration_descriptor_imp::store_clock_domain_desc(end_station_imp *end_station_obj, const uint8_t *frame, ssize_t pos, size_t frame_len)
     {
-        update_desc_database(new clock_domain_descriptor_imp(end_station_obj, frame, pos, frame_len));
+        update_desc_database(end_station_obj->arena().create<clock_domain_descriptor_imp>(end_station_obj, frame, pos, frame_len));
     }
 
     void configuration_descriptor_imp::store_control_desc(end_station_imp *end_station_obj, const uint8_t *frame, ssize_t pos, size_t frame_len)
     {
-        update_desc_database(new control_descriptor_imp(end_station_obj, frame, pos, frame_len));
+        update_desc_database(end_station_obj->arena().create<control_descriptor_imp>(end_station_obj, frame, pos, frame_len));
     }
 
     void configuration_descriptor_imp::store_external_port_input_desc(end_station_imp *end_station_obj, const uint8_t *frame, ssize_t pos, size_t frame_len)
     {
-        update_desc_database(new external_port_input_descriptor_imp(end_station_obj, frame, pos, frame_len));
+        update_desc_database(end_station_obj->arena().create<external_port_input_descriptor_imp>(end_station_obj, frame, pos, frame_len));
     }
 
     void configuration_descriptor_imp::store_external_port_output_desc(end_station_imp *end_station_obj, const uint8_t *frame, ssize_t pos, size_t frame_len)
     {
-        update_desc_database(new external_port_output_descriptor_imp(end_station_obj, frame, pos, frame_len));
+        update_desc_database(end_station_obj->arena().create<external_port_output_descriptor_imp>(end_station_obj, frame, pos, frame_len));
     }
 
     size_t STDCALL configuration_descriptor_imp::audio_unit_desc_count()
@@ -406,52 +429,52 @@ namespace avdecc_lib
 
     audio_unit_descriptor * STDCALL configuration_descriptor_imp::get_audio_unit_desc_by_index(size_t audio_unit_desc_index)
     {
-        return dynamic_cast<audio_unit_descriptor *>(lookup_desc(AEM_DESC_AUDIO_UNIT, audio_unit_desc_index));
+        return get_audio_unit_desc_imp_by_index(audio_unit_desc_index);
     }
 
     stream_input_descriptor * STDCALL configuration_descriptor_imp::get_stream_input_desc_by_index(size_t stream_input_desc_index)
     {
-        return dynamic_cast<stream_input_descriptor *>(lookup_desc(AEM_DESC_STREAM_INPUT, stream_input_desc_index));
+        return get_stream_input_desc_imp_by_index(stream_input_desc_index);
     }
 
     stream_output_descriptor * STDCALL configuration_descriptor_imp::get_stream_output_desc_by_index(size_t stream_output_desc_index)
     {
-        return dynamic_cast<stream_output_descriptor *>(lookup_desc(AEM_DESC_STREAM_OUTPUT, stream_output_desc_index));
+        return get_stream_output_desc_imp_by_index(stream_output_desc_index);
     }
 
     jack_input_descriptor * STDCALL configuration_descriptor_imp::get_jack_input_desc_by_index(size_t jack_input_desc_index)
     {
-        return dynamic_cast<jack_input_descriptor *>(lookup_desc(AEM_DESC_JACK_INPUT, jack_input_desc_index));
+        return get_jack_input_desc_imp_by_index(jack_input_desc_index);
     }
 
     jack_output_descriptor * STDCALL configuration_descriptor_imp::get_jack_output_desc_by_index(size_t jack_output_desc_index)
     {
-        return dynamic_cast<jack_output_descriptor *>(lookup_desc(AEM_DESC_JACK_OUTPUT, jack_output_desc_index));
+        return get_jack_output_desc_imp_by_index(jack_output_desc_index);
     }
 
     avb_interface_descriptor * STDCALL configuration_descriptor_imp::get_avb_interface_desc_by_index(size_t avb_interface_desc_index)
     {
-        return dynamic_cast<avb_interface_descriptor *>(lookup_desc(AEM_DESC_AVB_INTERFACE, avb_interface_desc_index));
+        return get_avb_interface_desc_imp_by_index(avb_interface_desc_index);
     }
 
     clock_source_descriptor * STDCALL configuration_descriptor_imp::get_clock_source_desc_by_index(size_t clock_source_desc_index)
     {
-        return dynamic_cast<clock_source_descriptor *>(lookup_desc(AEM_DESC_CLOCK_SOURCE, clock_source_desc_index));
+        return get_clock_source_desc_imp_by_index(clock_source_desc_index);
     }
 
     memory_object_descriptor * STDCALL configuration_descriptor_imp::get_memory_object_desc_by_index(size_t memory_object_desc_index)
     {
-        return dynamic_cast<memory_object_descriptor *>(lookup_desc(AEM_DESC_MEMORY_OBJECT, memory_object_desc_index));
+        return get_memory_object_desc_imp_by_index(memory_object_desc_index);
     }
 
     locale_descriptor * STDCALL configuration_descriptor_imp::get_locale_desc_by_index(size_t locale_desc_index)
     {
-        return dynamic_cast<locale_descriptor *>(lookup_desc(AEM_DESC_LOCALE, locale_desc_index));
+        return get_locale_desc_imp_by_index(locale_desc_index);
     }
 
     strings_descriptor * STDCALL configuration_descriptor_imp::get_strings_desc_by_index(size_t strings_desc_index)
     {
-        return dynamic_cast<strings_descriptor *>(lookup_desc(AEM_DESC_STRINGS, strings_desc_index));
+        return get_strings_desc_imp_by_index(strings_desc_index);
     }
 
     uint8_t * STDCALL configuration_descriptor_imp::get_strings_desc_string_by_reference(size_t reference)
@@ -476,41 +499,131 @@ namespace avdecc_lib
 
     stream_port_input_descriptor * STDCALL configuration_descriptor_imp::get_stream_port_input_desc_by_index(size_t stream_port_input_desc_index)
     {
-        return dynamic_cast<stream_port_input_descriptor *>(lookup_desc(AEM_DESC_STREAM_PORT_INPUT, stream_port_input_desc_index));
+        return get_stream_port_input_desc_imp_by_index(stream_port_input_desc_index);
     }
 
     stream_port_output_descriptor * STDCALL configuration_descriptor_imp::get_stream_port_output_desc_by_index(size_t stream_port_output_desc_index)
     {
-        return dynamic_cast<stream_port_output_descriptor *>(lookup_desc(AEM_DESC_STREAM_PORT_OUTPUT, stream_port_output_desc_index));
+        return get_stream_port_output_desc_imp_by_index(stream_port_output_desc_index);
     }
 
     audio_cluster_descriptor * STDCALL configuration_descriptor_imp::get_audio_cluster_desc_by_index(size_t audio_cluster_desc_index)
     {
-        return dynamic_cast<audio_cluster_descriptor *>(lookup_desc(AEM_DESC_AUDIO_CLUSTER, audio_cluster_desc_index));
+        return get_audio_cluster_desc_imp_by_index(audio_cluster_desc_index);
     }
 
     audio_map_descriptor * STDCALL configuration_descriptor_imp::get_audio_map_desc_by_index(size_t audio_map_desc_index)
     {
-        return dynamic_cast<audio_map_descriptor *>(lookup_desc(AEM_DESC_AUDIO_MAP, audio_map_desc_index));
+        return get_audio_map_desc_imp_by_index(audio_map_desc_index);
     }
 
     clock_domain_descriptor * STDCALL configuration_descriptor_imp::get_clock_domain_desc_by_index(size_t clock_domain_desc_index)
     {
-        return dynamic_cast<clock_domain_descriptor *>(lookup_desc(AEM_DESC_CLOCK_DOMAIN, clock_domain_desc_index));
+        return get_clock_domain_desc_imp_by_index(clock_domain_desc_index);
     }
 
     control_descriptor * STDCALL configuration_descriptor_imp::get_control_desc_by_index(size_t control_desc_index)
     {
-        return dynamic_cast<control_descriptor *>(lookup_desc(AEM_DESC_CONTROL, control_desc_index));
+        return get_control_desc_imp_by_index(control_desc_index);
     }
 
     external_port_input_descriptor * STDCALL configuration_descriptor_imp::get_external_port_input_desc_by_index(size_t index)
     {
-        return dynamic_cast<external_port_input_descriptor *>(lookup_desc(AEM_DESC_EXTERNAL_PORT_INPUT, index));
+        return get_external_port_input_desc_imp_by_index(index);
     }
 
     external_port_output_descriptor * STDCALL configuration_descriptor_imp::get_external_port_output_desc_by_index(size_t index)
     {
-        return dynamic_cast<external_port_output_descriptor *>(lookup_desc(AEM_DESC_EXTERNAL_PORT_OUTPUT, index));
+        return get_external_port_output_desc_imp_by_index(index);
+    }
+
+    audio_unit_descriptor_imp * configuration_descriptor_imp::get_audio_unit_desc_imp_by_index(size_t index)
+    {
+        return typed_desc<audio_unit_descriptor_imp>(AEM_DESC_AUDIO_UNIT, index);
+    }
+
+    stream_input_descriptor_imp * configuration_descriptor_imp::get_stream_input_desc_imp_by_index(size_t index)
+    {
+        return typed_desc<stream_input_descriptor_imp>(AEM_DESC_STREAM_INPUT, index);
+    }
+
+    stream_output_descriptor_imp * configuration_descriptor_imp::get_stream_output_desc_imp_by_index(size_t index)
+    {
+        return typed_desc<stream_output_descriptor_imp>(AEM_DESC_STREAM_OUTPUT, index);
+    }
+
+    jack_input_descriptor_imp * configuration_descriptor_imp::get_jack_input_desc_imp_by_index(size_t index)
+    {
+        return typed_desc<jack_input_descriptor_imp>(AEM_DESC_JACK_INPUT, index);
+    }
+
+    jack_output_descriptor_imp * configuration_descriptor_imp::get_jack_output_desc_imp_by_index(size_t index)
+    {
+        return typed_desc<jack_output_descriptor_imp>(AEM_DESC_JACK_OUTPUT, index);
+    }
+
+    avb_interface_descriptor_imp * configuration_descriptor_imp::get_avb_interface_desc_imp_by_index(size_t index)
+    {
+        return typed_desc<avb_interface_descriptor_imp>(AEM_DESC_AVB_INTERFACE, index);
+    }
+
+    clock_source_descriptor_imp * configuration_descriptor_imp::get_clock_source_desc_imp_by_index(size_t index)
+    {
+        return typed_desc<clock_source_descriptor_imp>(AEM_DESC_CLOCK_SOURCE, index);
+    }
+
+    memory_object_descriptor_imp * configuration_descriptor_imp::get_memory_object_desc_imp_by_index(size_t index)
+    {
+        return typed_desc<memory_object_descriptor_imp>(AEM_DESC_MEMORY_OBJECT, index);
+    }
+
+    locale_descriptor_imp * configuration_descriptor_imp::get_locale_desc_imp_by_index(size_t index)
+    {
+        return typed_desc<locale_descriptor_imp>(AEM_DESC_LOCALE, index);
+    }
+
+    strings_descriptor_imp * configuration_descriptor_imp::get_strings_desc_imp_by_index(size_t index)
+    {
+        return typed_desc<strings_descriptor_imp>(AEM_DESC_STRINGS, index);
+    }
+
+    stream_port_input_descriptor_imp * configuration_descriptor_imp::get_stream_port_input_desc_imp_by_index(size_t index)
+    {
+        return typed_desc<stream_port_input_descriptor_imp>(AEM_DESC_STREAM_PORT_INPUT, index);
+    }
+
+    stream_port_output_descriptor_imp * configuration_descriptor_imp::get_stream_port_output_desc_imp_by_index(size_t index)
+    {
+        return typed_desc<stream_port_output_descriptor_imp>(AEM_DESC_STREAM_PORT_OUTPUT, index);
+    }
+
+    audio_cluster_descriptor_imp * configuration_descriptor_imp::get_audio_cluster_desc_imp_by_index(size_t index)
+    {
+        return typed_desc<audio_cluster_descriptor_imp>(AEM_DESC_AUDIO_CLUSTER, index);
+    }
+
+    audio_map_descriptor_imp * configuration_descriptor_imp::get_audio_map_desc_imp_by_index(size_t index)
+    {
+        return typed_desc<audio_map_descriptor_imp>(AEM_DESC_AUDIO_MAP, index);
+    }
+
+    clock_domain_descriptor_imp * configuration_descriptor_imp::get_clock_domain_desc_imp_by_index(size_t index)
+    {
+        return typed_desc<clock_domain_descriptor_imp>(AEM_DESC_CLOCK_DOMAIN, index);
+    }
+
+    control_descriptor_imp * configuration_descriptor_imp::get_control_desc_imp_by_index(size_t index)
+    {
+        return typed_desc<control_descriptor_imp>(AEM_DESC_CONTROL, index);
+    }
+
+    external_port_input_descriptor_imp * configuration_descriptor_imp::get_external_port_input_desc_imp_by_index(size_t index)
+    {
+        return typed_desc<external_port_input_descriptor_imp>(AEM_DESC_EXTERNAL_PORT_INPUT, index);
+    }
+
+    external_port_output_descriptor_imp * configuration_descriptor_imp::get_external_port_output_desc_imp_by_index(size_t index)
+    {
+        return typed_desc<external_port_output_descriptor_imp>(AEM_DESC_EXTERNAL_PORT_OUTPUT, index);
     }
 }
@@ -55,19 +55,39 @@ namespace avdecc_lib
     class configuration_descriptor_imp : public configuration_descriptor, public virtual descriptor_base_imp
     {
     private:
-        typedef std::vector<descriptor_base_imp *> DITEM;
+        struct desc_entry
+        {
+            descriptor_base_imp *base; // Generic view of the descriptor, used for lookup by type
+            void *imp; // The concrete <type>_descriptor_imp object, recovered with a static_cast by the typed accessors
+        };
+        typedef std::vector<desc_entry> DITEM;
 
         struct jdksavdecc_descriptor_configuration config_desc; // Structure containing the config_desc fields
 
         std::vector<uint16_t> desc_type_vec; // Store descriptor types present in the CONFIGURATION descriptor
         std::vector<uint16_t> desc_count_vec; // Store descriptor counts present in the CONFIGURATION descriptor
-        std::map<uint16_t, DITEM> m_all_desc; // Store all descriptors in a map of vectors
+        DITEM m_all_desc[TOTAL_NUM_OF_AEM_DESCS]; // Store all descriptors, indexed by descriptor type then descriptor index
 
         size_t desc_count(uint16_t type);
-        descriptor_base_imp *lookup_desc(uint16_t desc_type, size_t index);
-        void update_desc_database(descriptor_base_imp *desc);
+
+        /**
+         * Store the descriptor in the slot given by its type and index, replacing any previous descriptor.
+         */
+        template <class T>
+        void update_desc_database(T *desc);
+
+        /**
+         * \return The concrete descriptor of the type and index, or NULL if there is none.
+         */
+        template <class T>
+        T *typed_desc(uint16_t desc_type, size_t index);
 
 	public:
+        /**
+         * \return The descriptor of the type and index in this configuration, or NULL if there is none.
+         */
+        descriptor_base_imp *lookup_desc(uint16_t desc_type, size_t index);
+
         configuration_descriptor_imp(end_station_imp *end_station_obj, const uint8_t *frame, ssize_t pos, size_t frame_len);
 
         virtual ~configuration_descriptor_imp();
@@ -146,6 +166,29 @@ namespace avdecc_lib
         external_port_input_descriptor * STDCALL get_external_port_input_desc_by_index(size_t index);
         external_port_output_descriptor * STDCALL get_external_port_output_desc_by_index(size_t index);
 
+        /**
+         * Typed accessors returning the implementation object directly, for use on the response path.
+         * \return The descriptor of the type and index in this configuration, or NULL if there is none.
+         */
+        audio_unit_descriptor_imp *get_audio_unit_desc_imp_by_index(size_t index);
+        stream_input_descriptor_imp *get_stream_input_desc_imp_by_index(size_t index);
+        stream_output_descriptor_imp *get_stream_output_desc_imp_by_index(size_t index);
+        jack_input_descriptor_imp *get_jack_input_desc_imp_by_index(size_t index);
+        jack_output_descriptor_imp *get_jack_output_desc_imp_by_index(size_t index);
+        avb_interface_descriptor_imp *get_avb_interface_desc_imp_by_index(size_t index);
+        clock_source_descriptor_imp *get_clock_source_desc_imp_by_index(size_t index);
+        memory_object_descriptor_imp *get_memory_object_desc_imp_by_index(size_t index);
+        locale_descriptor_imp *get_locale_desc_imp_by_index(size_t index);
+        strings_descriptor_imp *get_strings_desc_imp_by_index(size_t index);
+        stream_port_input_descriptor_imp *get_stream_port_input_desc_imp_by_index(size_t index);
+        stream_port_output_descriptor_imp *get_stream_port_output_desc_imp_by_index(size_t index);
+        audio_cluster_descriptor_imp *get_audio_cluster_desc_imp_by_index(size_t index);
+        audio_map_descriptor_imp *get_audio_map_desc_imp_by_index(size_t index);
+        clock_domain_descriptor_imp *get_clock_domain_desc_imp_by_index(size_t index);
+        control_descriptor_imp *get_control_desc_imp_by_index(size_t index);
+        external_port_input_descriptor_imp *get_external_port_input_desc_imp_by_index(size_t index);
+        external_port_output_descriptor_imp *get_external_port_output_desc_imp_by_index(size_t index);
+
     private:
         /**
          * Initialize the descriptor type vector with descriptor types present in the current configuration.
@@ -0,0 +1,301 @@
+/*
+ * Licensed under the MIT License (MIT)
+ *
+ * Copyright (c) 2014 AudioScience Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * connection_graph.cpp
+ *
+ * Connection graph implementation
+ */
+
+#include "net_interface_imp.h"
+#include "enumeration.h"
+#include "connection_graph.h"
+
+namespace avdecc_lib
+{
+    connection_graph::connection_graph() {}
+
+    connection_graph::~connection_graph() {}
+
+    void connection_graph::acmp_event(const uint8_t *frame, size_t frame_len)
+    {
+        struct jdksavdecc_acmpdu acmpdu;
+
+        if (jdksavdecc_acmpdu_read(&acmpdu, frame, ETHER_HDR_SIZE, frame_len) < 0)
+            return;
+
+        if (acmpdu.header.status != ACMP_STATUS_SUCCESS)
+            return;
+
+        stream_key talker;
+        talker.entity_id = jdksavdecc_eui64_convert_to_uint64(&acmpdu.talker_entity_id);
+        talker.unique_id = acmpdu.talker_unique_id;
+
+        stream_key listener;
+        listener.entity_id = jdksavdecc_eui64_convert_to_uint64(&acmpdu.listener_entity_id);
+        listener.unique_id = acmpdu.listener_unique_id;
+
+        uint64_t stream_id = jdksavdecc_eui64_convert_to_uint64(&acmpdu.header.stream_id);
+
+        std::lock_guard<std::mutex> guard(lock);
+
+        switch (acmpdu.header.message_type)
+        {
+            case JDKSAVDECC_ACMP_MESSAGE_TYPE_CONNECT_RX_RESPONSE:
+                connect(listener, talker, stream_id);
+                break;
+
+            case JDKSAVDECC_ACMP_MESSAGE_TYPE_DISCONNECT_RX_RESPONSE:
+                disconnect(listener);
+                break;
+
+            case JDKSAVDECC_ACMP_MESSAGE_TYPE_GET_RX_STATE_RESPONSE:
+                if ((acmpdu.connection_count > 0) && (talker.entity_id != 0))
+                    connect(listener, talker, stream_id);
+                else
+                    disconnect(listener);
+                break;
+
+            case JDKSAVDECC_ACMP_MESSAGE_TYPE_CONNECT_TX_RESPONSE:
+                set_talker_stream_id(talker, stream_id);
+                break;
+
+            case JDKSAVDECC_ACMP_MESSAGE_TYPE_GET_TX_STATE_RESPONSE:
+            {
+                set_talker_stream_id(talker, stream_id);
+
+                // A talker stream without connections cannot have listeners, drop any that were missed disconnecting
+                auto it = talkers.find(talker);
+                if ((acmpdu.connection_count == 0) && (it != talkers.end()))
+                {
+                    while (!it->second.listeners.empty())
+                    {
+                        stream_key listener_of_talker = it->second.listeners.back();
+                        disconnect(listener_of_talker);
+                    }
+                }
+            }
+            break;
+
+            default:
+                break;
+        }
+    }
+
+    void connection_graph::remove_entity(uint64_t entity_id)
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        size_t i = 0;
+
+        while (i < connections.size())
+        {
+            if ((connections[i].talker_entity_id == entity_id) || (connections[i].listener_entity_id == entity_id))
+            {
+                stream_key listener;
+                listener.entity_id = connections[i].listener_entity_id;
+                listener.unique_id = connections[i].listener_unique_id;
+                disconnect(listener); // Moves the last connection to i
+            }
+            else
+            {
+                i++;
+            }
+        }
+
+        for (auto it = talkers.begin(); it != talkers.end();)
+        {
+            if (it->first.entity_id == entity_id)
+            {
+                stream_id_index.erase(it->second.stream_id);
+                it = talkers.erase(it);
+            }
+            else
+            {
+                ++it;
+            }
+        }
+    }
+
+    size_t connection_graph::connection_count()
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        return connections.size();
+    }
+
+    int connection_graph::connection_by_index(size_t index, struct stream_connection &connection)
+    {
+        std::lock_guard<std::mutex> guard(lock);
+
+        if (index >= connections.size())
+            return -1;
+
+        connection = connections[index];
+        return 0;
+    }
+
+    size_t connection_graph::listener_count(uint64_t talker_entity_id, uint16_t talker_unique_id)
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        stream_key talker;
+        talker.entity_id = talker_entity_id;
+        talker.unique_id = talker_unique_id;
+
+        auto it = talkers.find(talker);
+        return (it != talkers.end()) ? it->second.listeners.size() : 0;
+    }
+
+    int connection_graph::listener_by_index(uint64_t talker_entity_id, uint16_t talker_unique_id, size_t index, struct stream_connection &connection)
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        stream_key talker;
+        talker.entity_id = talker_entity_id;
+        talker.unique_id = talker_unique_id;
+
+        auto it = talkers.find(talker);
+        if ((it == talkers.end()) || (index >= it->second.listeners.size()))
+            return -1;
+
+        connection = connections[listener_index[it->second.listeners[index]]];
+        return 0;
+    }
+
+    int connection_graph::talker_connection(uint64_t listener_entity_id, uint16_t listener_unique_id, struct stream_connection &connection)
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        stream_key listener;
+        listener.entity_id = listener_entity_id;
+        listener.unique_id = listener_unique_id;
+
+        auto it = listener_index.find(listener);
+        if (it == listener_index.end())
+            return -1;
+
+        connection = connections[it->second];
+        return 0;
+    }
+
+    int connection_graph::talker_by_stream_id(uint64_t stream_id, uint64_t &talker_entity_id, uint16_t &talker_unique_id)
+    {
+        std::lock_guard<std::mutex> guard(lock);
+
+        auto it = stream_id_index.find(stream_id);
+        if (it == stream_id_index.end())
+            return -1;
+
+        talker_entity_id = it->second.entity_id;
+        talker_unique_id = it->second.unique_id;
+        return 0;
+    }
+
+    void connection_graph::connect(const stream_key &listener, const stream_key &talker, uint64_t stream_id)
+    {
+        auto it = listener_index.find(listener);
+
+        if (it != listener_index.end())
+        {
+            struct stream_connection &existing = connections[it->second];
+
+            if ((existing.talker_entity_id == talker.entity_id) && (existing.talker_unique_id == talker.unique_id))
+            {
+                existing.stream_id = stream_id;
+                set_talker_stream_id(talker, stream_id);
+                return;
+            }
+
+            disconnect(listener); // A listener stream has only one talker
+        }
+
+        struct stream_connection connection;
+        connection.talker_entity_id = talker.entity_id;
+        connection.talker_unique_id = talker.unique_id;
+        connection.listener_entity_id = listener.entity_id;
+        connection.listener_unique_id = listener.unique_id;
+        connection.stream_id = stream_id;
+
+        listener_index[listener] = connections.size();
+        connections.push_back(connection);
+        talkers[talker].listeners.push_back(listener);
+        set_talker_stream_id(talker, stream_id);
+    }
+
+    void connection_graph::disconnect(const stream_key &listener)
+    {
+        auto it = listener_index.find(listener);
+        if (it == listener_index.end())
+            return;
+
+        size_t index = it->second;
+        listener_index.erase(it);
+
+        stream_key talker;
+        talker.entity_id = connections[index].talker_entity_id;
+        talker.unique_id = connections[index].talker_unique_id;
+
+        auto t = talkers.find(talker);
+        if (t != talkers.end())
+        {
+            std::vector<stream_key> &listeners = t->second.listeners;
+            for (size_t i = 0; i < listeners.size(); i++)
+            {
+                if (listeners[i] == listener)
+                {
+                    listeners[i] = listeners.back();
+                    listeners.pop_back();
+                    break;
+                }
+            }
+        }
+
+        // Keep the connections packed by moving the last one into the hole
+        if (index != connections.size() - 1)
+        {
+            connections[index] = connections.back();
+
+            stream_key moved;
+            moved.entity_id = connections[index].listener_entity_id;
+            moved.unique_id = connections[index].listener_unique_id;
+            listener_index[moved] = index;
+        }
+        connections.pop_back();
+    }
+
+    void connection_graph::set_talker_stream_id(const stream_key &talker, uint64_t stream_id)
+    {
+        if (talker.entity_id == 0)
+            return;
+
+        struct talker_stream &stream = talkers[talker];
+
+        if (stream.stream_id != stream_id)
+        {
+            auto it = stream_id_index.find(stream.stream_id);
+            if ((it != stream_id_index.end()) && (it->second == talker))
+                stream_id_index.erase(it);
+
+            stream.stream_id = stream_id;
+        }
+
+        if (stream_id != 0)
+            stream_id_index[stream_id] = talker;
+    }
+}
@@ -0,0 +1,103 @@
+/*
+ * Licensed under the MIT License (MIT)
+ *
+ * Copyright (c) 2014 AudioScience Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * connection_graph.h
+ *
+ * The stream connections of the network, kept up to date from the ACMP responses the controller receives.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <vector>
+#include <mutex>
+#include <functional>
+#include <unordered_map>
+
+#include "controller.h"
+
+namespace avdecc_lib
+{
+    class connection_graph
+    {
+    public:
+        connection_graph();
+
+        ~connection_graph();
+
+        /**
+         * Update the graph from an ACMP response. Responses to other controllers are used as well,
+         * since ACMP responses are sent to the multicast address.
+         */
+        void acmp_event(const uint8_t *frame, size_t frame_len);
+
+        /**
+         * Drop every connection to or from an End Station that has left the network.
+         */
+        void remove_entity(uint64_t entity_id);
+
+        size_t connection_count();
+        int connection_by_index(size_t index, struct stream_connection &connection);
+        size_t listener_count(uint64_t talker_entity_id, uint16_t talker_unique_id);
+        int listener_by_index(uint64_t talker_entity_id, uint16_t talker_unique_id, size_t index, struct stream_connection &connection);
+        int talker_connection(uint64_t listener_entity_id, uint16_t listener_unique_id, struct stream_connection &connection);
+        int talker_by_stream_id(uint64_t stream_id, uint64_t &talker_entity_id, uint16_t &talker_unique_id);
+
+    private:
+        struct stream_key
+        {
+            uint64_t entity_id;
+            uint16_t unique_id;
+
+            bool operator==(const stream_key &other) const
+            {
+                return (entity_id == other.entity_id) && (unique_id == other.unique_id);
+            }
+        };
+
+        struct stream_key_hash
+        {
+            size_t operator()(const stream_key &key) const
+            {
+                return std::hash<uint64_t>()(key.entity_id ^ ((uint64_t)key.unique_id << 48));
+            }
+        };
+
+        struct talker_stream
+        {
+            uint64_t stream_id;
+            std::vector<stream_key> listeners;
+        };
+
+        std::mutex lock; // Updated by the poll thread, queried by application threads
+        std::vector<struct stream_connection> connections; // Packed, removed connections are replaced by the last one
+        std::unordered_map<stream_key, size_t, stream_key_hash> listener_index; // Index into connections by listener stream
+        std::unordered_map<stream_key, struct talker_stream, stream_key_hash> talkers; // Listeners of each talker stream
+        std::unordered_map<uint64_t, stream_key> stream_id_index; // Talker stream by stream id
+
+        void connect(const stream_key &listener, const stream_key &talker, uint64_t stream_id);
+        void disconnect(const stream_key &listener);
+        void set_talker_stream_id(const stream_key &talker, uint64_t stream_id);
+    };
+}
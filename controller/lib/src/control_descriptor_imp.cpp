@@ -37,92 +37,94 @@ namespace avdecc_lib
 {
     control_descriptor_imp::control_descriptor_imp(end_station_imp *end_station_obj, const uint8_t *frame, ssize_t pos, size_t frame_len) : descriptor_base_imp(end_station_obj)
     {
-        ssize_t ret = jdksavdecc_descriptor_control_read(&control_desc, frame, pos, frame_len);
-
-        if (ret < 0)
+        if ((pos < 0) || (frame_len < (size_t)pos + JDKSAVDECC_DESCRIPTOR_CONTROL_LEN))
         {
             throw avdecc_read_descriptor_error("control_desc_read error");
         }
+
+        control_desc_len = frame_len - pos;
+        control_desc = end_station_obj->arena().store(frame + pos, control_desc_len);
     }
 
 
     control_descriptor_imp::~control_descriptor_imp()
     {
+        base_end_station_imp_ref->arena().unstore(control_desc, control_desc_len);
     }
 
     uint16_t STDCALL control_descriptor_imp::descriptor_type() const
     {
-        assert(control_desc.descriptor_type == JDKSAVDECC_DESCRIPTOR_CONTROL);
-        return control_desc.descriptor_type;
+        assert(jdksavdecc_descriptor_control_get_descriptor_type(control_desc, 0) == JDKSAVDECC_DESCRIPTOR_CONTROL);
+        return jdksavdecc_descriptor_control_get_descriptor_type(control_desc, 0);
     }
 
     uint16_t STDCALL control_descriptor_imp::descriptor_index() const
     {
-        return control_desc.descriptor_index;
+        return jdksavdecc_descriptor_control_get_descriptor_index(control_desc, 0);
     }
 
     uint8_t * STDCALL control_descriptor_imp::object_name()
     {
-        return control_desc.object_name.value;
+        return control_desc + JDKSAVDECC_DESCRIPTOR_CONTROL_OFFSET_OBJECT_NAME;
     }
 
     uint16_t STDCALL control_descriptor_imp::localized_description()
     {
-        return control_desc.localized_description;
+        return jdksavdecc_descriptor_control_get_localized_description(control_desc, 0);
     }
 
     uint32_t STDCALL control_descriptor_imp::block_latency()
     {
-        return control_desc.block_latency;
+        return jdksavdecc_descriptor_control_get_block_latency(control_desc, 0);
     }
 
     uint32_t STDCALL control_descriptor_imp::control_latency()
     {
-        return control_desc.control_latency;
+        return jdksavdecc_descriptor_control_get_control_latency(control_desc, 0);
     }
 
     uint16_t STDCALL control_descriptor_imp::control_domain()
     {
-        return control_desc.control_domain;
+        return jdksavdecc_descriptor_control_get_control_domain(control_desc, 0);
     }
 
     uint16_t STDCALL control_descriptor_imp::control_value_type()
     {
-        return control_desc.control_value_type;
+        return jdksavdecc_descriptor_control_get_control_value_type(control_desc, 0);
     }
 
     uint64_t STDCALL control_descriptor_imp::control_type()
     {
-        return jdksavdecc_uint64_get(&control_desc.control_type, 0);
+        return jdksavdecc_uint64_get(control_desc, JDKSAVDECC_DESCRIPTOR_CONTROL_OFFSET_CONTROL_TYPE);
     }
 
     uint32_t STDCALL control_descriptor_imp::reset_time()
     {
-        return control_desc.reset_time;
+        return jdksavdecc_descriptor_control_get_reset_time(control_desc, 0);
     }
 
     uint16_t STDCALL control_descriptor_imp::values_offset()
     {
-        return control_desc.values_offset;
+        return jdksavdecc_descriptor_control_get_values_offset(control_desc, 0);
     }
 
     uint16_t STDCALL control_descriptor_imp::number_of_values()
     {
-        return control_desc.number_of_values;
+        return jdksavdecc_descriptor_control_get_number_of_values(control_desc, 0);
     }
 
     uint16_t STDCALL control_descriptor_imp::signal_type()
     {
-        return control_desc.signal_type;
+        return jdksavdecc_descriptor_control_get_signal_type(control_desc, 0);
     }
 
     uint16_t STDCALL control_descriptor_imp::signal_index()
     {
-        return control_desc.signal_index;
+        return jdksavdecc_descriptor_control_get_signal_index(control_desc, 0);
     }
 
     uint16_t STDCALL control_descriptor_imp::signal_output()
     {
-        return control_desc.signal_output;
+        return jdksavdecc_descriptor_control_get_signal_output(control_desc, 0);
     }
 }
@@ -38,7 +38,8 @@ namespace avdecc_lib
     class control_descriptor_imp : public control_descriptor, public virtual descriptor_base_imp
     {
     private:
-        struct jdksavdecc_descriptor_control control_desc; // Structure containing the control_desc fields
+        uint8_t *control_desc; // The CONTROL descriptor payload held in the End Station's arena
+        size_t control_desc_len;
 
     public:
         control_descriptor_imp(end_station_imp *end_station_obj, const uint8_t *frame, ssize_t pos, size_t frame_len);
@@ -43,6 +43,9 @@
 #include "adp_discovery_state_machine.h"
 #include "acmp_controller_state_machine.h"
 #include "aecp_controller_state_machine.h"
+#include "timer_wheel.h"
+#include "descriptor_cache.h"
+#include "net_interface_set.h"
 #include "controller_imp.h"
 
 namespace avdecc_lib
@@ -65,6 +68,10 @@ namespace avdecc_lib
         {
             log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "Dynamic cast from base net_interface to derived net_interface_imp error");
         }
+        else
+        {
+            net_interface_set_ref->add(net_interface_ref);
+        }
 
         return controller_imp_ref;
     }
@@ -83,9 +90,8 @@ namespace avdecc_lib
             delete end_station_vec.at(end_station_index);
         }
 
-        delete adp_discovery_state_machine_ref;
-        delete acmp_controller_state_machine_ref;
-        delete aecp_controller_state_machine_ref;
+        // The interfaces belong to the application, a controller created later adds its own
+        net_interface_set_ref->clear();
     }
 
     void STDCALL controller_imp::destroy()
@@ -100,30 +106,63 @@ namespace avdecc_lib
 
     size_t STDCALL controller_imp::get_end_station_count()
     {
+        std::lock_guard<std::mutex> guard(end_station_lock);
         return end_station_vec.size();
     }
 
     end_station * STDCALL controller_imp::get_end_station_by_index(size_t end_station_index)
     {
+        std::lock_guard<std::mutex> guard(end_station_lock);
         return end_station_vec.at(end_station_index);
     }
 
-    bool STDCALL controller_imp::is_end_station_found_by_entity_id(uint64_t entity_entity_id, uint32_t &end_station_index)
+    end_station_imp * controller_imp::end_station_at(size_t end_station_index)
     {
-        uint64_t end_station_entity_id;
+        std::lock_guard<std::mutex> guard(end_station_lock);
+        return (end_station_index < end_station_vec.size()) ? end_station_vec[end_station_index] : NULL;
+    }
 
-        for(uint32_t i = 0; i < end_station_vec.size(); i++)
+    end_station * STDCALL controller_imp::get_end_station_by_entity_id(uint64_t entity_entity_id)
+    {
+        return find_end_station(entity_entity_id);
+    }
+
+    end_station_imp * controller_imp::add_end_station(const uint8_t *frame, size_t frame_len)
+    {
+        end_station_imp *end_station = new end_station_imp(frame, frame_len);
+        std::lock_guard<std::mutex> guard(end_station_lock);
+
+        end_station_index_map[end_station->entity_id()] = (uint32_t)end_station_vec.size();
+        end_station_vec.push_back(end_station);
+
+        return end_station;
+    }
+
+    end_station_imp * controller_imp::find_end_station(uint64_t entity_entity_id)
+    {
+        std::lock_guard<std::mutex> guard(end_station_lock);
+        std::unordered_map<uint64_t, uint32_t>::const_iterator it = end_station_index_map.find(entity_entity_id);
+
+        if(it == end_station_index_map.end())
         {
-            end_station_entity_id = end_station_vec.at(i)->entity_id();
+            return NULL;
+        }
 
-            if(end_station_entity_id == entity_entity_id)
-            {
-                end_station_index = i;
-                return true;
-            }
+        return end_station_vec[it->second];
+    }
+
+    bool STDCALL controller_imp::is_end_station_found_by_entity_id(uint64_t entity_entity_id, uint32_t &end_station_index)
+    {
+        std::lock_guard<std::mutex> guard(end_station_lock);
+        std::unordered_map<uint64_t, uint32_t>::const_iterator it = end_station_index_map.find(entity_entity_id);
+
+        if(it == end_station_index_map.end())
+        {
+            return false;
         }
 
-        return false;
+        end_station_index = it->second;
+        return true;
     }
 
     configuration_descriptor * STDCALL controller_imp::get_current_config_desc(size_t end_station_index, bool report_error)
@@ -131,10 +170,10 @@ namespace avdecc_lib
         uint16_t entity_index = 0;
         uint16_t config_index = 0;
         bool is_valid = false;
+        avdecc_lib::end_station *end_station = end_station_at(end_station_index);
 
-        if(end_station_index < end_station_vec.size())
+        if(end_station)
         {
-            avdecc_lib::end_station *end_station = end_station_vec.at(end_station_index);
             entity_index = end_station->get_current_entity_index();
             config_index = end_station->get_current_config_index();
 
@@ -145,7 +184,7 @@ namespace avdecc_lib
         if(is_valid)
         {
             configuration_descriptor * configuration;
-            configuration = end_station_vec.at(end_station_index)->get_entity_desc_by_index(entity_index)->get_config_desc_by_index(config_index);
+            configuration = end_station->get_entity_desc_by_index(entity_index)->get_config_desc_by_index(config_index);
 
             return configuration;
         }
@@ -159,24 +198,22 @@ namespace avdecc_lib
 
     configuration_descriptor * controller_imp::get_config_desc_by_entity_id(uint64_t entity_entity_id, uint16_t entity_index, uint16_t config_index)
     {
-        for(uint32_t i = 0; i < end_station_vec.size(); i++)
+        end_station_imp *end_station = find_end_station(entity_entity_id);
+
+        if(end_station)
         {
-            uint64_t end_station_entity_id = end_station_vec.at(i)->entity_id();
-            if(end_station_entity_id == entity_entity_id)
+            bool is_valid = ((entity_index < end_station->entity_desc_count()) &&
+                             (config_index < end_station->get_entity_desc_by_index(entity_index)->configurations_count()));
+            if(is_valid)
             {
-                bool is_valid = ((entity_index < end_station_vec.at(i)->entity_desc_count()) &&
-                                 (config_index < end_station_vec.at(i)->get_entity_desc_by_index(entity_index)->configurations_count()));
-                if(is_valid)
-                {
-                    configuration_descriptor * configuration;
-                    configuration = end_station_vec.at(i)->get_entity_desc_by_index(entity_index)->get_config_desc_by_index(config_index);
+                configuration_descriptor * configuration;
+                configuration = end_station->get_entity_desc_by_index(entity_index)->get_config_desc_by_index(config_index);
 
-                    return configuration;
-                }
-                else
-                {
-                    log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "get_config_desc_by_entity_id error");
-                }
+                return configuration;
+            }
+            else
+            {
+                log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "get_config_desc_by_entity_id error");
             }
         }
 
@@ -186,7 +223,9 @@ namespace avdecc_lib
     bool controller_imp::is_inflight_cmd_with_notification_id(void *notification_id)
     {
         bool is_inflight_cmd = ((aecp_controller_state_machine_ref->is_inflight_cmd_with_notification_id(notification_id)) ||
-                                (acmp_controller_state_machine_ref->is_inflight_cmd_with_notification_id(notification_id)));
+                                (acmp_controller_state_machine_ref->is_inflight_cmd_with_notification_id(notification_id)) ||
+                                (engine_shard_ref->bulk_cmds.has_notification_id(notification_id)) ||
+                                (engine_shard_ref->transfers.has_notification_id(notification_id)));
 
         return is_inflight_cmd;
     }
@@ -196,6 +235,15 @@ namespace avdecc_lib
         return aecp_controller_state_machine_ref->is_active_operation_with_notification_id(notification_id);
     }
 
+    int controller_imp::tick_completion_status(void *notification_id)
+    {
+        int status = AVDECC_LIB_STATUS_TICK_TIMEOUT;
+
+        if (!engine_shard_ref->bulk_cmds.tick_status(notification_id, status))
+            engine_shard_ref->transfers.tick_status(notification_id, status);
+        return status;
+    }
+
     void STDCALL controller_imp::set_logging_level(int32_t new_log_level)
     {
         log_imp_ref->set_log_level(new_log_level);
@@ -206,50 +254,111 @@ namespace avdecc_lib
         return notification_imp_ref->missed_notification_event_count();
     }
 
+    int STDCALL controller_imp::set_notification_capacity(uint32_t count)
+    {
+        if (notification_imp_ref->set_notification_capacity(count) < 0)
+        {
+            log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "Notification capacity cannot be changed after the system layer has started");
+            return -1;
+        }
+
+        return 0;
+    }
+
+    void STDCALL controller_imp::set_notification_batch_callback(void (*batch_callback) (void *, const struct notification_msg *, uint32_t), void *batch_user_obj)
+    {
+        notification_imp_ref->set_notification_batch_callback(batch_callback, batch_user_obj);
+    }
+
     uint32_t STDCALL controller_imp::missed_log_count()
     {
         return log_imp_ref->missed_log_event_count();
     }
 
-    void controller_imp::time_tick_event()
+    void STDCALL controller_imp::set_log_record_callback(void (*record_callback) (void *, int32_t, const char *, const struct log_arg *, uint32_t, int32_t),
+                                                         void *record_user_obj)
     {
-        uint64_t end_station_entity_id;
-        uint32_t disconnected_end_station_index;
-        aecp_controller_state_machine_ref->tick();
-        acmp_controller_state_machine_ref->tick();
+        log_imp_ref->set_log_record_callback(record_callback, record_user_obj);
+    }
+
+    void STDCALL controller_imp::set_background_read_limits(uint16_t end_station_limit, uint16_t total_limit)
+    {
+        end_station_imp::set_background_read_limits(end_station_limit, total_limit);
+    }
+
+    int STDCALL controller_imp::enable_descriptor_cache(const char *path)
+    {
+        return descriptor_cache_ref->open(path);
+    }
+
+    void STDCALL controller_imp::enable_unsolicited_notifications(bool enable)
+    {
+        end_station_imp::set_unsolicited_auto_register(enable);
+    }
+
+    int STDCALL controller_imp::add_net_interface(net_interface *netif)
+    {
+        net_interface_imp *netif_imp = dynamic_cast<net_interface_imp *>(netif);
 
-        if(adp_discovery_state_machine_ref->tick(end_station_entity_id) &&
-           is_end_station_found_by_entity_id(end_station_entity_id, disconnected_end_station_index))
+        if(!netif_imp || (net_interface_set_ref->count() == 0))
         {
-            end_station_vec.at(disconnected_end_station_index)->set_disconnected();
+            log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "Network interface cannot be added");
+            return -1;
         }
 
-        /* tick updates to background read of descriptors */
-        for (uint32_t i = 0; i < end_station_vec.size(); i++)
+        return net_interface_set_ref->add(netif_imp);
+    }
+
+    int STDCALL controller_imp::get_end_station_net_interface(uint64_t entity_entity_id)
+    {
+        return net_interface_set_ref->entity_net_interface(entity_entity_id);
+    }
+
+    void controller_imp::time_tick_event()
+    {
+        uint64_t end_station_entity_id;
+
+        /* Inflight command, end station and background read timeouts */
+        timer_wheel_ref->run();
+        engine_shard_ref->bulk_cmds.tick_event();
+        engine_shard_ref->transfers.tick_event();
+
+        while(adp_discovery_state_machine_ref->tick(end_station_entity_id))
         {
-            end_station_vec.at(i)->background_read_update_timeouts();
-            end_station_vec.at(i)->background_read_submit_pending();
+            end_station_imp *end_station = find_end_station(end_station_entity_id);
+
+            if(end_station)
+            {
+                end_station->set_disconnected();
+            }
+
+            net_interface_set_ref->remove_entity(end_station_entity_id);
+
+            std::lock_guard<std::mutex> guard(connection_lock);
+            connections.remove_entity(end_station_entity_id);
         }
     }
 
-    int controller_imp::find_in_end_station(struct jdksavdecc_eui64 &other_entity_id, const uint8_t *frame)
+    end_station_imp * controller_imp::find_in_end_station(struct jdksavdecc_eui64 &other_entity_id, const uint8_t *frame)
     {
         struct jdksavdecc_eui64 other_controller_id = jdksavdecc_acmpdu_get_controller_entity_id(frame, ETHER_HDR_SIZE);
+        end_station_imp *end_station = find_end_station(jdksavdecc_eui64_convert_to_uint64(&other_entity_id));
 
-        for(uint32_t i = 0; i < end_station_vec.size(); i++)
+        if(!end_station)
         {
-            struct jdksavdecc_eui64 end_entity_id = end_station_vec.at(i)->get_adp()->get_entity_entity_id();
-            struct jdksavdecc_eui64 this_controller_id = end_station_vec.at(i)->get_adp()->get_controller_entity_id();
+            return NULL;
+        }
 
-            if((jdksavdecc_eui64_compare(&end_entity_id, &other_entity_id) == 0) &&
-                ((jdksavdecc_eui64_compare(&other_controller_id, &this_controller_id) == 0) ||
-                (jdksavdecc_eui64_compare(&other_controller_id, &end_entity_id) == 0)))
-            {
-                return i;
-            }
+        struct jdksavdecc_eui64 end_entity_id = end_station->get_adp()->get_entity_entity_id();
+        struct jdksavdecc_eui64 this_controller_id = end_station->get_adp()->get_controller_entity_id();
+
+        if((jdksavdecc_eui64_compare(&other_controller_id, &this_controller_id) == 0) ||
+           (jdksavdecc_eui64_compare(&other_controller_id, &end_entity_id) == 0))
+        {
+            return end_station;
         }
 
-        return -1;
+        return NULL;
     }
 
     void controller_imp::rx_packet_event(void *&notification_id,
@@ -258,13 +367,15 @@ namespace avdecc_lib
                                         size_t frame_len,
                                         int &status,
                                         uint16_t &operation_id,
-                                        bool &is_operation_id_valid)
+                                        bool &is_operation_id_valid,
+                                        size_t netif_index)
     {
         uint64_t dest_mac_addr;
         utility::convert_eui48_to_uint64(frame, dest_mac_addr);
         is_operation_id_valid = false;
+        bool is_local_mac = net_interface_set_ref->is_local_mac(netif_index, dest_mac_addr);
 
-        if((dest_mac_addr == net_interface_ref->mac_addr()) || (dest_mac_addr & UINT64_C(0x010000000000))) // Process if the packet dest is our MAC address or a multicast address
+        if(is_local_mac || (dest_mac_addr & UINT64_C(0x010000000000))) // Process if the packet dest is our MAC address or a multicast address
         {
             uint8_t subtype = jdksavdecc_common_control_header_get_subtype(frame,ETHER_HDR_SIZE);
 
@@ -273,7 +384,6 @@ namespace avdecc_lib
                 case JDKSAVDECC_SUBTYPE_ADP:
                 {
                     end_station_imp *end_station = NULL;
-                    bool found_adp_in_end_station = false;
 
                     jdksavdecc_adpdu adpdu;
                     memset(&adpdu,0,sizeof(adpdu));
@@ -293,36 +403,63 @@ namespace avdecc_lib
                      * Check if an ADP object is already in the system. If not, create a new End Station object storing the ADPDU information
                      * and add the End Station object to the system.
                      */
-                    for(uint32_t i = 0; i < end_station_vec.size(); i++)
+                    end_station = find_end_station(jdksavdecc_eui64_convert_to_uint64(&adpdu.header.entity_id));
+
+                    if(jdksavdecc_eui64_convert_to_uint64(&adpdu.header.entity_id) != 0)
                     {
-                        struct jdksavdecc_eui64 end_entity_id = end_station_vec.at(i)->get_adp()->get_entity_entity_id();
-                        if(jdksavdecc_eui64_compare(&end_entity_id, &adpdu.header.entity_id) == 0)
+                        uint64_t entity_id = jdksavdecc_eui64_convert_to_uint64(&adpdu.header.entity_id);
+                        bool is_new_net_interface = false;
+                        int previous_netif_index = net_interface_set_ref->entity_net_interface(entity_id);
+                        int current_netif_index;
+
+                        if (adpdu.header.message_type == JDKSAVDECC_ADP_MESSAGE_TYPE_ENTITY_AVAILABLE)
                         {
-                            found_adp_in_end_station = true;
-                            end_station = end_station_vec.at(i);
+                            is_new_net_interface = net_interface_set_ref->adp_event(entity_id, netif_index, adpdu.header.valid_time * 2 * 1000);
                         }
-                    }
 
+                        current_netif_index = net_interface_set_ref->entity_net_interface(entity_id);
 
-                    if(jdksavdecc_eui64_convert_to_uint64(&adpdu.header.entity_id) != 0)
-                    {
-                        if(!found_adp_in_end_station)
+                        if(!end_station)
+                        {
+                            adp_discovery_state_machine_ref->state_avail(frame, frame_len);
+                            add_end_station(frame, frame_len)->set_connected();
+                        }
+                        else if ((current_netif_index >= 0) && ((size_t)current_netif_index != netif_index))
                         {
+                            /**
+                             * A redundant entity keeps a separate available_index on each network, so only the ADPDUs of
+                             * the interface it is reached on describe it. The copies from the other networks still keep
+                             * it from timing out.
+                             */
                             adp_discovery_state_machine_ref->state_avail(frame, frame_len);
-                            end_station_vec.push_back(new end_station_imp(frame, frame_len));
-                            end_station_vec.at(end_station_vec.size() - 1)->set_connected();
                         }
                         else
                         {
-                            if ((adpdu.available_index < end_station->get_adp()->get_available_index()) ||
-                                (jdksavdecc_eui64_convert_to_uint64(&adpdu.entity_model_id) != end_station->get_adp()->get_entity_model_id()))
+                            if (is_new_net_interface)
                             {
-                                log_imp_ref->post_log_msg(LOGGING_LEVEL_DEBUG, "Re-enumerating end station with entity_id %ull", end_station->entity_id());
-                                end_station->end_station_reenumerate();
+                                // Reach the End Station through its MAC address on the network it has moved to
+                                uint64_t src_mac_addr;
+                                utility::convert_eui48_to_uint64(frame + DEST_MAC_SIZE, src_mac_addr);
+                                end_station->set_end_station_mac(src_mac_addr);
                             }
 
+                            // The available_index of a network the entity has just moved to does not follow on from the old one
+                            bool is_moved = is_new_net_interface && (previous_netif_index >= 0);
+
+                            // A departed End Station is enumerated again when it is marked as connected
+                            bool is_reenumerate = (end_station->get_connection_status() != 'D') &&
+                                                  ((!is_moved && (adpdu.available_index < end_station->get_adp()->get_available_index())) ||
+                                                   (jdksavdecc_eui64_convert_to_uint64(&adpdu.entity_model_id) != end_station->get_adp()->get_entity_model_id()));
+
+                            // Enumerate with the new ADPDU, so a changed entity model ID picks the right shared model
                             end_station->get_adp()->proc_adpdu(frame, frame_len);
 
+                            if (is_reenumerate)
+                            {
+                                log_imp_ref->post_log_msg(LOGGING_LEVEL_DEBUG, "Re-enumerating end station with entity_id %ull", end_station->entity_id());
+                                end_station->end_station_reenumerate();
+                            }
+
                             if(end_station->get_connection_status() == 'D')
                             {
                                 end_station->set_connected();
@@ -333,6 +470,12 @@ namespace avdecc_lib
                                 adp_discovery_state_machine_ref->state_avail(frame, frame_len);
                             }
                         }
+
+                        if ((adpdu.header.message_type == JDKSAVDECC_ADP_MESSAGE_TYPE_ENTITY_DEPARTING) &&
+                            ((current_netif_index < 0) || ((size_t)current_netif_index == netif_index)))
+                        {
+                            net_interface_set_ref->remove_entity(entity_id);
+                        }
                     }
                     else if (adpdu.header.message_type != JDKSAVDECC_ADP_MESSAGE_TYPE_ENTITY_DISCOVER)
                     {
@@ -343,20 +486,18 @@ namespace avdecc_lib
 
                 case JDKSAVDECC_SUBTYPE_AECP:
                 {
-                    int found_end_station_index = -1;
-                    bool found_aecp_in_end_station = false;
+                    end_station_imp *found_end_station = NULL;
                     uint32_t msg_type = jdksavdecc_common_control_header_get_control_data(frame, ETHER_HDR_SIZE);
                     struct jdksavdecc_eui64 entity_entity_id = jdksavdecc_common_control_header_get_stream_id(frame, ETHER_HDR_SIZE);
 
-                    if (dest_mac_addr == net_interface_ref->mac_addr())
+                    if (is_local_mac)
                     {    /**
                          * Check if an AECP object is already in the system. If yes, process response for the AECP packet.
                          */
-                        found_end_station_index = find_in_end_station(entity_entity_id, frame);
-                        if (found_end_station_index >= 0) found_aecp_in_end_station = true;
+                        found_end_station = find_in_end_station(entity_entity_id, frame);
                     }
 
-                    if (!found_aecp_in_end_station)
+                    if (!found_end_station)
                     {
                         status = AVDECC_LIB_STATUS_INVALID;
                         break;
@@ -367,6 +508,7 @@ namespace avdecc_lib
                         case JDKSAVDECC_AECP_MESSAGE_TYPE_AEM_RESPONSE:
                         {
                             uint16_t cmd_type = jdksavdecc_aecpdu_aem_get_command_type(frame, ETHER_HDR_SIZE);
+                            bool u_field = (cmd_type >> 15) & 0x01;
                             cmd_type &= 0x7FFF;
 
                             if(cmd_type == JDKSAVDECC_AEM_COMMAND_CONTROLLER_AVAILABLE)
@@ -375,7 +517,16 @@ namespace avdecc_lib
                             }
                             else
                             {
-                                end_station_vec.at(found_end_station_index)->proc_rcvd_aem_resp(notification_id, frame, frame_len, status, operation_id, is_operation_id_valid);
+                                found_end_station->proc_rcvd_aem_resp(notification_id, frame, frame_len, status, operation_id, is_operation_id_valid);
+                            }
+
+                            if(u_field)
+                            {
+                                // Notify once the End Station has applied the new state to its descriptors
+                                struct jdksavdecc_frame unsolicited_frame;
+                                unsolicited_frame.length = (uint16_t)frame_len;
+                                memcpy(unsolicited_frame.payload, frame, frame_len);
+                                aecp_controller_state_machine_ref->state_rcvd_unsolicited(notification_id, &unsolicited_frame);
                             }
 
                             is_notification_id_valid = true;
@@ -383,7 +534,7 @@ namespace avdecc_lib
                         }
                         case JDKSAVDECC_AECP_MESSAGE_TYPE_ADDRESS_ACCESS_RESPONSE:
                         {
-                            end_station_vec.at(found_end_station_index)->proc_rcvd_aecp_aa_resp(notification_id, frame, frame_len, status);
+                            found_end_station->proc_rcvd_aecp_aa_resp(notification_id, frame, frame_len, status);
 
                             is_notification_id_valid = true;
                             break;
@@ -395,11 +546,15 @@ namespace avdecc_lib
 
                 case JDKSAVDECC_SUBTYPE_ACMP:
                 {
-                    int found_end_station_index = -1;
-                    bool found_acmp_in_end_station = false;
+                    end_station_imp *found_end_station = NULL;
                     struct jdksavdecc_eui64 entity_entity_id;
                     uint32_t msg_type = jdksavdecc_common_control_header_get_control_data(frame, ETHER_HDR_SIZE);
 
+                    {
+                        std::lock_guard<std::mutex> guard(connection_lock);
+                        connections.acmp_event(frame, frame_len);
+                    }
+
                     if((msg_type == JDKSAVDECC_ACMP_MESSAGE_TYPE_GET_TX_STATE_RESPONSE) || 
                        (msg_type == JDKSAVDECC_ACMP_MESSAGE_TYPE_GET_TX_CONNECTION_RESPONSE))
                     {
@@ -412,12 +567,11 @@ namespace avdecc_lib
                         entity_entity_id = jdksavdecc_acmpdu_get_listener_entity_id(frame, ETHER_HDR_SIZE);
                     }
 
-                    found_end_station_index = find_in_end_station(entity_entity_id, frame);
-                    if (found_end_station_index >= 0) found_acmp_in_end_station = true;
+                    found_end_station = find_in_end_station(entity_entity_id, frame);
 
-                    if(found_acmp_in_end_station)
+                    if(found_end_station)
                     {
-                        end_station_vec.at(found_end_station_index)->proc_rcvd_acmp_resp(msg_type, notification_id, frame, frame_len, status);
+                        found_end_station->proc_rcvd_acmp_resp(msg_type, notification_id, frame, frame_len, status);
                         is_notification_id_valid = true;
                     }
                     else
@@ -431,11 +585,32 @@ namespace avdecc_lib
                 default:
                     break;
             }
+
+            if(is_notification_id_valid)
+            {
+                engine_shard_ref->bulk_cmds.rx_event(frame, status);
+                engine_shard_ref->transfers.rx_event(frame, frame_len, notification_id, status);
+            }
         }
     }
 
     void controller_imp::tx_packet_event(void *notification_id, uint32_t notification_flag, uint8_t *frame, size_t frame_len)
     {
+        if(notification_flag == CMD_BATCH_WITH_NOTIFICATION)
+        {
+            struct bulk_cmd_batch *batch;
+            memcpy(&batch, frame, sizeof(batch));
+            engine_shard_ref->bulk_cmds.add(batch);
+            return;
+        }
+        else if(notification_flag == CMD_TRANSFER_WITH_NOTIFICATION)
+        {
+            struct memory_transfer *transfer;
+            memcpy(&transfer, frame, sizeof(transfer));
+            engine_shard_ref->transfers.add(transfer);
+            return;
+        }
+
         uint8_t subtype = jdksavdecc_common_control_header_get_subtype(frame,ETHER_HDR_SIZE);
         struct jdksavdecc_frame packet_frame;
 
@@ -464,15 +639,22 @@ namespace avdecc_lib
         struct jdksavdecc_frame cmd_frame;
         struct jdksavdecc_aem_command_controller_available aem_cmd_controller_avail;
         ssize_t aem_cmd_controller_avail_returned;
+        end_station_imp *end_station = end_station_at(end_station_index);
         memset(&aem_cmd_controller_avail,0,sizeof(aem_cmd_controller_avail));
 
+        if(!end_station)
+        {
+            log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "send_controller_avail_cmd invalid End Station index %d", (int)end_station_index);
+            return -1;
+        }
+
         /*************************************************** AECP Common Data **************************************************/
-        aem_cmd_controller_avail.aem_header.aecpdu_header.controller_entity_id = end_station_vec.at(end_station_index)->get_adp()->get_controller_entity_id();
+        aem_cmd_controller_avail.aem_header.aecpdu_header.controller_entity_id = end_station->get_adp()->get_controller_entity_id();
         // Fill aem_cmd_controller_avail.sequence_id in AEM Controller State Machine
         aem_cmd_controller_avail.aem_header.command_type = JDKSAVDECC_AEM_COMMAND_CONTROLLER_AVAILABLE;
 
         /******************************** Fill frame payload with AECP data and send the frame ***************************/
-        aecp_controller_state_machine_ref->ether_frame_init(end_station_vec.at(end_station_index)->mac(), &cmd_frame,
+        aecp_controller_state_machine_ref->ether_frame_init(end_station->mac(), &cmd_frame,
 								ETHER_HDR_SIZE + JDKSAVDECC_AEM_COMMAND_CONTROLLER_AVAILABLE);
         aem_cmd_controller_avail_returned = jdksavdecc_aem_command_controller_available_write(&aem_cmd_controller_avail,
                                                                                               cmd_frame.payload,
@@ -488,7 +670,7 @@ namespace avdecc_lib
 
         aecp_controller_state_machine_ref->common_hdr_init(JDKSAVDECC_AECP_MESSAGE_TYPE_AEM_COMMAND,
                                                             &cmd_frame,
-                                                            end_station_vec.at(end_station_index)->entity_id(),
+                                                            end_station->entity_id(),
                                                             JDKSAVDECC_AEM_COMMAND_CONTROLLER_AVAILABLE_COMMAND_LEN - 
                                                             JDKSAVDECC_COMMON_CONTROL_HEADER_LEN);
         system_queue_tx(notification_id, CMD_WITH_NOTIFICATION, cmd_frame.payload, cmd_frame.length);
@@ -527,4 +709,194 @@ namespace avdecc_lib
 
         return 0;
     }
+
+    size_t STDCALL controller_imp::get_connection_count()
+    {
+        std::lock_guard<std::mutex> guard(connection_lock);
+        return connections.connection_count();
+    }
+
+    int STDCALL controller_imp::get_connection_by_index(size_t index, struct stream_connection &connection)
+    {
+        std::lock_guard<std::mutex> guard(connection_lock);
+        return connections.connection_by_index(index, connection);
+    }
+
+    size_t STDCALL controller_imp::get_listener_count(uint64_t talker_entity_id, uint16_t talker_unique_id)
+    {
+        std::lock_guard<std::mutex> guard(connection_lock);
+        return connections.listener_count(talker_entity_id, talker_unique_id);
+    }
+
+    int STDCALL controller_imp::get_listener_by_index(uint64_t talker_entity_id, uint16_t talker_unique_id, size_t index, struct stream_connection &connection)
+    {
+        std::lock_guard<std::mutex> guard(connection_lock);
+        return connections.listener_by_index(talker_entity_id, talker_unique_id, index, connection);
+    }
+
+    int STDCALL controller_imp::get_talker_connection(uint64_t listener_entity_id, uint16_t listener_unique_id, struct stream_connection &connection)
+    {
+        std::lock_guard<std::mutex> guard(connection_lock);
+        return connections.talker_connection(listener_entity_id, listener_unique_id, connection);
+    }
+
+    int STDCALL controller_imp::get_talker_by_stream_id(uint64_t stream_id, uint64_t &talker_entity_id, uint16_t &talker_unique_id)
+    {
+        std::lock_guard<std::mutex> guard(connection_lock);
+        return connections.talker_by_stream_id(stream_id, talker_entity_id, talker_unique_id);
+    }
+
+    int STDCALL controller_imp::send_bulk_cmds(void *notification_id, const struct bulk_cmd *cmds, size_t count, uint16_t entity_limit)
+    {
+        if(count == 0)
+        {
+            log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "send_bulk_cmds called without commands");
+            return -1;
+        }
+
+        struct bulk_cmd_batch *batch = new bulk_cmd_batch();
+        batch->notification_id = notification_id;
+        batch->entity_limit = (entity_limit > 0) ? entity_limit : 1;
+        batch->unsent = count;
+        batch->frames.resize(count);
+
+        for(size_t i = 0; i < count; i++)
+        {
+            end_station_imp *end_station = find_end_station(cmds[i].entity_id);
+
+            if(!end_station)
+            {
+                log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "send_bulk_cmds unknown End Station 0x%" PRIx64, cmds[i].entity_id);
+                delete batch;
+                return -1;
+            }
+
+            if(bulk_cmd_frame_init(cmds[i], end_station, batch->frames[i]) < 0)
+            {
+                delete batch;
+                return -1;
+            }
+        }
+
+        // The whole batch goes through the transmit queue as a single frame holding the batch pointer
+        system_queue_tx(notification_id, CMD_BATCH_WITH_NOTIFICATION, (uint8_t *)&batch, sizeof(batch));
+
+        return 0;
+    }
+
+    int controller_imp::bulk_cmd_frame_init(const struct bulk_cmd &cmd, end_station_imp *end_station, struct bulk_cmd_frame &bulk_frame)
+    {
+        struct jdksavdecc_frame cmd_frame;
+        ssize_t write_return_val = -1;
+
+        switch(cmd.cmd_type)
+        {
+            case bulk_cmd::BULK_CMD_READ_DESCRIPTOR:
+            {
+                struct jdksavdecc_aem_command_read_descriptor aem_cmd_read_desc;
+                memset(&aem_cmd_read_desc, 0, sizeof(aem_cmd_read_desc));
+
+                aem_cmd_read_desc.aem_header.aecpdu_header.controller_entity_id = end_station->get_adp()->get_controller_entity_id();
+                // Fill aem_cmd_read_desc.sequence_id in AEM Controller State Machine
+                aem_cmd_read_desc.aem_header.command_type = JDKSAVDECC_AEM_COMMAND_READ_DESCRIPTOR;
+                aem_cmd_read_desc.configuration_index = end_station->read_desc_config_index(cmd.desc_type);
+                aem_cmd_read_desc.descriptor_type = cmd.desc_type;
+                aem_cmd_read_desc.descriptor_index = cmd.desc_index;
+
+                aecp_controller_state_machine_ref->ether_frame_init(end_station->mac(), &cmd_frame,
+                                                                    ETHER_HDR_SIZE + JDKSAVDECC_AEM_COMMAND_READ_DESCRIPTOR_COMMAND_LEN);
+                write_return_val = jdksavdecc_aem_command_read_descriptor_write(&aem_cmd_read_desc,
+                                                                                cmd_frame.payload,
+                                                                                ETHER_HDR_SIZE,
+                                                                                sizeof(cmd_frame.payload));
+                if(write_return_val >= 0)
+                {
+                    aecp_controller_state_machine_ref->common_hdr_init(JDKSAVDECC_AECP_MESSAGE_TYPE_AEM_COMMAND,
+                                                                       &cmd_frame,
+                                                                       end_station->entity_id(),
+                                                                       JDKSAVDECC_AEM_COMMAND_READ_DESCRIPTOR_COMMAND_LEN -
+                                                                       JDKSAVDECC_COMMON_CONTROL_HEADER_LEN);
+                }
+            }
+            break;
+
+            case bulk_cmd::BULK_CMD_GET_STREAM_INFO:
+            {
+                struct jdksavdecc_aem_command_get_stream_info aem_cmd_get_stream_info;
+                memset(&aem_cmd_get_stream_info, 0, sizeof(aem_cmd_get_stream_info));
+
+                aem_cmd_get_stream_info.aem_header.aecpdu_header.controller_entity_id = end_station->get_adp()->get_controller_entity_id();
+                // Fill aem_cmd_get_stream_info.sequence_id in AEM Controller State Machine
+                aem_cmd_get_stream_info.aem_header.command_type = JDKSAVDECC_AEM_COMMAND_GET_STREAM_INFO;
+                aem_cmd_get_stream_info.descriptor_type = cmd.desc_type;
+                aem_cmd_get_stream_info.descriptor_index = cmd.desc_index;
+
+                aecp_controller_state_machine_ref->ether_frame_init(end_station->mac(), &cmd_frame,
+                                                                    ETHER_HDR_SIZE + JDKSAVDECC_AEM_COMMAND_GET_STREAM_INFO_COMMAND_LEN);
+                write_return_val = jdksavdecc_aem_command_get_stream_info_write(&aem_cmd_get_stream_info,
+                                                                                cmd_frame.payload,
+                                                                                ETHER_HDR_SIZE,
+                                                                                sizeof(cmd_frame.payload));
+                if(write_return_val >= 0)
+                {
+                    aecp_controller_state_machine_ref->common_hdr_init(JDKSAVDECC_AECP_MESSAGE_TYPE_AEM_COMMAND,
+                                                                       &cmd_frame,
+                                                                       end_station->entity_id(),
+                                                                       JDKSAVDECC_AEM_COMMAND_GET_STREAM_INFO_COMMAND_LEN -
+                                                                       JDKSAVDECC_COMMON_CONTROL_HEADER_LEN);
+                }
+            }
+            break;
+
+            case bulk_cmd::BULK_CMD_GET_RX_STATE:
+            case bulk_cmd::BULK_CMD_GET_TX_STATE:
+            {
+                struct jdksavdecc_acmpdu acmp_cmd_get_state;
+                bool is_rx = (cmd.cmd_type == bulk_cmd::BULK_CMD_GET_RX_STATE);
+                memset(&acmp_cmd_get_state, 0, sizeof(acmp_cmd_get_state));
+
+                acmp_cmd_get_state.controller_entity_id = end_station->get_adp()->get_controller_entity_id();
+                if(is_rx)
+                {
+                    jdksavdecc_uint64_write(end_station->entity_id(), &acmp_cmd_get_state.listener_entity_id, 0, sizeof(uint64_t));
+                    acmp_cmd_get_state.listener_unique_id = cmd.desc_index;
+                }
+                else
+                {
+                    jdksavdecc_uint64_write(end_station->entity_id(), &acmp_cmd_get_state.talker_entity_id, 0, sizeof(uint64_t));
+                    acmp_cmd_get_state.talker_unique_id = cmd.desc_index;
+                }
+                // Fill acmp_cmd_get_state.sequence_id in ACMP Controller State Machine
+
+                acmp_controller_state_machine_ref->ether_frame_init(&cmd_frame);
+                write_return_val = jdksavdecc_acmpdu_write(&acmp_cmd_get_state,
+                                                           cmd_frame.payload,
+                                                           ETHER_HDR_SIZE,
+                                                           sizeof(cmd_frame.payload));
+                if(write_return_val >= 0)
+                {
+                    acmp_controller_state_machine_ref->common_hdr_init(is_rx ? JDKSAVDECC_ACMP_MESSAGE_TYPE_GET_RX_STATE_COMMAND :
+                                                                       JDKSAVDECC_ACMP_MESSAGE_TYPE_GET_TX_STATE_COMMAND, &cmd_frame);
+                }
+            }
+            break;
+
+            default:
+                log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "send_bulk_cmds unsupported command type %d", (int)cmd.cmd_type);
+                return -1;
+        }
+
+        if(write_return_val < 0)
+        {
+            log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "send_bulk_cmds frame write error");
+            return -1;
+        }
+
+        assert(cmd_frame.length <= sizeof(bulk_frame.payload));
+        bulk_frame.entity_id = end_station->entity_id();
+        bulk_frame.length = cmd_frame.length;
+        memcpy(bulk_frame.payload, cmd_frame.payload, cmd_frame.length);
+
+        return 0;
+    }
 }
@@ -29,7 +29,11 @@
 
 #pragma once
 
+#include <mutex>
+#include <unordered_map>
 #include "controller.h"
+#include "connection_graph.h"
+#include "engine_shard.h"
 
 namespace avdecc_lib
 {
@@ -37,11 +41,35 @@ namespace avdecc_lib
     {
     private:
         std::vector<end_station_imp *> end_station_vec; // Store a list of End Station objects
+        std::unordered_map<uint64_t, uint32_t> end_station_index_map; // Index into end_station_vec by Entity ID
+        std::mutex end_station_lock; // Guards end_station_vec and end_station_index_map, added to by every engine shard
+        connection_graph connections; // Stream connections seen in ACMP responses
+        std::mutex connection_lock; // Guards connections, updated by every engine shard
+
+        /**
+         * Add a new End Station to the list and index it by Entity ID.
+         */
+        end_station_imp * add_end_station(const uint8_t *frame, size_t frame_len);
+
+        /**
+         * \return The End Station with the Entity ID, or NULL if not found.
+         */
+        end_station_imp * find_end_station(uint64_t entity_entity_id);
+
+        /**
+         * \return The End Station at the index, or NULL if there is none.
+         */
+        end_station_imp * end_station_at(size_t end_station_index);
 
         /**
          * Find an end station that matches the entity and controller IDs
          */
-        int find_in_end_station(struct jdksavdecc_eui64 &entity_entity_id, const uint8_t *frame);
+        end_station_imp * find_in_end_station(struct jdksavdecc_eui64 &entity_entity_id, const uint8_t *frame);
+
+        /**
+         * Build the command frame of a send_bulk_cmds command.
+         */
+        int bulk_cmd_frame_init(const struct bulk_cmd &cmd, end_station_imp *end_station, struct bulk_cmd_frame &bulk_frame);
 
     public:
         /**
@@ -60,6 +88,7 @@ namespace avdecc_lib
         const char * STDCALL get_version() const;
         size_t STDCALL get_end_station_count();
         end_station * STDCALL get_end_station_by_index(size_t end_station_index);
+        end_station * STDCALL get_end_station_by_entity_id(uint64_t entity_entity_id);
 
         /**
          * Check if the corresponding End Station with the Entity ID exist.
@@ -77,19 +106,34 @@ namespace avdecc_lib
 
         bool is_active_operation_with_notification_id(void *notification_id);
 
+        /**
+         * \return The status to complete a command with that stopped being inflight during time_tick_event,
+         *         which is AVDECC_LIB_STATUS_TICK_TIMEOUT unless it was a batch or memory transfer that failed otherwise.
+         */
+        int tick_completion_status(void *notification_id);
+
         void STDCALL set_logging_level(int32_t new_log_level);
         uint32_t STDCALL missed_notification_count();
+        int STDCALL set_notification_capacity(uint32_t count);
+        void STDCALL set_notification_batch_callback(void (*batch_callback) (void *, const struct notification_msg *, uint32_t), void *batch_user_obj);
         uint32_t STDCALL missed_log_count();
+        void STDCALL set_log_record_callback(void (*record_callback) (void *, int32_t, const char *, const struct log_arg *, uint32_t, int32_t), void *record_user_obj);
+        void STDCALL set_background_read_limits(uint16_t end_station_limit, uint16_t total_limit);
+        int STDCALL enable_descriptor_cache(const char *path);
+        void STDCALL enable_unsolicited_notifications(bool enable);
+        int STDCALL add_net_interface(net_interface *netif);
+        int STDCALL get_end_station_net_interface(uint64_t entity_entity_id);
 
         /**
-         * Check for End Station connection, command packet, and response packet timeouts.
+         * Run expired End Station connection, command packet, and background read timeouts.
          */
         void time_tick_event();
 
         /**
-         * Lookup and process packet received.
+         * Lookup and process packet received on the network interface with index netif_index.
          */
-        void rx_packet_event(void *&notification_id, bool &is_notification_id_valid, const uint8_t *frame, size_t frame_len, int &status, uint16_t &operation_id, bool &is_operation_id_valid);
+        void rx_packet_event(void *&notification_id, bool &is_notification_id_valid, const uint8_t *frame, size_t frame_len, int &status, uint16_t &operation_id, bool &is_operation_id_valid,
+                             size_t netif_index);
 
         /**
          * Send queued packet to the AEM Controller State Machine.
@@ -97,6 +141,14 @@ namespace avdecc_lib
         void tx_packet_event(void *notification_id, uint32_t notification_flag, uint8_t *frame, size_t frame_len);
 
         int STDCALL send_controller_avail_cmd(void *notification_id, uint32_t end_station_index);
+        int STDCALL send_bulk_cmds(void *notification_id, const struct bulk_cmd *cmds, size_t count, uint16_t entity_limit);
+
+        size_t STDCALL get_connection_count();
+        int STDCALL get_connection_by_index(size_t index, struct stream_connection &connection);
+        size_t STDCALL get_listener_count(uint64_t talker_entity_id, uint16_t talker_unique_id);
+        int STDCALL get_listener_by_index(uint64_t talker_entity_id, uint16_t talker_unique_id, size_t index, struct stream_connection &connection);
+        int STDCALL get_talker_connection(uint64_t listener_entity_id, uint16_t listener_unique_id, struct stream_connection &connection);
+        int STDCALL get_talker_by_stream_id(uint64_t stream_id, uint64_t &talker_entity_id, uint16_t &talker_unique_id);
 
         /**
          * Process a CONTROLLER_AVAILABLE response for the CONTROLLER_AVAILABLE command.
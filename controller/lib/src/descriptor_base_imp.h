@@ -47,7 +47,19 @@ namespace avdecc_lib
     {
     protected:
         end_station_imp *base_end_station_imp_ref;
-        std::vector<descriptor_field_imp *>m_fields;
+        std::vector<descriptor_field_imp> m_field_views; // One view per field of the reflection table, returned by field()
+
+        /**
+         * Expose the fields of the table through field_count() and field(), reading their values from storage.
+         * The storage must stay at the same address for the lifetime of the descriptor.
+         */
+        template <size_t N>
+        void set_field_table(const descriptor_field_info (&table)[N], const void *storage)
+        {
+            m_field_views.resize(N);
+            for (size_t i = 0; i < N; i++)
+                m_field_views[i].bind(&table[i], storage);
+        }
 
     public:
         descriptor_base_imp(end_station_imp *base);
@@ -60,13 +72,13 @@ namespace avdecc_lib
 
         size_t STDCALL field_count() const
         {
-            return m_fields.size();
+            return m_field_views.size();
         };
 
         descriptor_field * STDCALL field(size_t index) const
         {
-            if (index < m_fields.size())
-                return m_fields.at(index);
+            if (index < m_field_views.size())
+                return const_cast<descriptor_field_imp *>(&m_field_views[index]);
             else
                 return nullptr;
         };
@@ -0,0 +1,276 @@
+/*
+ * Licensed under the MIT License (MIT)
+ *
+ * Copyright (c) 2014 AudioScience Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * descriptor_cache.cpp
+ *
+ * Persistent descriptor cache implementation
+ */
+
+#include <cstring>
+#if defined __linux__ || defined __MACH__
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+#include "enumeration.h"
+#include "log_imp.h"
+#include "jdksavdecc.h"
+#include "descriptor_cache.h"
+
+namespace avdecc_lib
+{
+    descriptor_cache *descriptor_cache_ref = new descriptor_cache();
+
+    static const char cache_magic[8] = {'A', 'V', 'D', 'E', 'S', 'C', 'C', 'H'};
+    static const uint32_t cache_version = 1;
+
+    struct cache_file_header
+    {
+        char magic[8];
+        uint32_t version;
+        uint32_t reserved;
+    };
+
+    struct cache_record_header
+    {
+        uint64_t entity_model_id;
+        uint16_t config_index;
+        uint16_t desc_type;
+        uint16_t desc_index;
+        uint16_t desc_len;
+    };
+
+    static inline size_t cache_record_size(uint16_t desc_len)
+    {
+        return (sizeof(struct cache_record_header) + desc_len + 7) & ~(size_t)7;
+    }
+
+    descriptor_cache::descriptor_cache()
+    {
+        fd = -1;
+        map_base = NULL;
+        map_size = 0;
+    }
+
+    descriptor_cache::~descriptor_cache()
+    {
+        close();
+    }
+
+#if defined __linux__ || defined __MACH__
+    int descriptor_cache::open(const char *path)
+    {
+        struct cache_file_header file_header;
+        struct stat st;
+        std::lock_guard<std::mutex> guard(lock);
+
+        close();
+
+        fd = ::open(path, O_RDWR | O_CREAT | O_APPEND, 0644);
+        if (fd < 0)
+        {
+            log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "Unable to open descriptor cache %s, errno %d", path, errno);
+            return -1;
+        }
+
+        if ((fstat(fd, &st) < 0) ||
+            ((size_t)st.st_size < sizeof(file_header)) ||
+            (pread(fd, &file_header, sizeof(file_header), 0) != (ssize_t)sizeof(file_header)) ||
+            (memcmp(file_header.magic, cache_magic, sizeof(cache_magic)) != 0) ||
+            (file_header.version != cache_version))
+        {
+            // New, empty or incompatible cache file, start again
+            memset(&file_header, 0, sizeof(file_header));
+            memcpy(file_header.magic, cache_magic, sizeof(cache_magic));
+            file_header.version = cache_version;
+
+            if ((ftruncate(fd, 0) < 0) || (write(fd, &file_header, sizeof(file_header)) != (ssize_t)sizeof(file_header)))
+            {
+                log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "Unable to initialize descriptor cache %s, errno %d", path, errno);
+                close();
+                return -1;
+            }
+
+            return 0;
+        }
+
+        map_size = (size_t)st.st_size;
+        void *p = mmap(NULL, map_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p == MAP_FAILED)
+        {
+            log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "Unable to map descriptor cache %s, errno %d", path, errno);
+            map_size = 0;
+            close();
+            return -1;
+        }
+        map_base = (uint8_t *)p;
+
+        index_records();
+        log_imp_ref->post_log_msg(LOGGING_LEVEL_DEBUG, "Descriptor cache %s has %d descriptors", path, (int)records.size());
+
+        return 0;
+    }
+
+    void descriptor_cache::close()
+    {
+        records.clear();
+        appended.clear();
+
+        if (map_base)
+        {
+            munmap(map_base, map_size);
+            map_base = NULL;
+            map_size = 0;
+        }
+
+        if (fd >= 0)
+        {
+            ::close(fd);
+            fd = -1;
+        }
+    }
+
+    void descriptor_cache::index_records()
+    {
+        size_t pos = sizeof(struct cache_file_header);
+
+        while (pos + sizeof(struct cache_record_header) <= map_size)
+        {
+            struct cache_record_header record_header;
+            memcpy(&record_header, map_base + pos, sizeof(record_header));
+
+            if (pos + sizeof(record_header) + record_header.desc_len > map_size)
+            {
+                break;
+            }
+
+            record_key key = {record_header.entity_model_id, record_header.config_index,
+                              record_header.desc_type, record_header.desc_index};
+            record_value value = {map_base + pos + sizeof(record_header), record_header.desc_len};
+            records[key] = value;
+
+            pos += cache_record_size(record_header.desc_len);
+        }
+
+        if (pos < map_size)
+        {
+            // Drop a record left incomplete by an interrupted write so that new records follow the last good one
+            log_imp_ref->post_log_msg(LOGGING_LEVEL_DEBUG, "Descriptor cache truncated at offset %d", (int)pos);
+            if (ftruncate(fd, pos) < 0)
+            {
+                log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "Descriptor cache truncate failed, errno %d", errno);
+            }
+        }
+    }
+
+    void descriptor_cache::store(uint64_t entity_model_id, uint16_t config_index, uint16_t desc_type, uint16_t desc_index,
+                                 const uint8_t *desc, uint16_t desc_len)
+    {
+        std::lock_guard<std::mutex> guard(lock);
+
+        if (fd < 0)
+        {
+            return;
+        }
+
+        record_key key = {entity_model_id, config_index, desc_type, desc_index};
+        std::unordered_map<record_key, record_value, record_key_hash>::const_iterator it = records.find(key);
+
+        if ((it != records.end()) && (it->second.desc_len == desc_len) && (memcmp(it->second.desc, desc, desc_len) == 0))
+        {
+            return;
+        }
+
+        struct cache_record_header record_header = {entity_model_id, config_index, desc_type, desc_index, desc_len};
+        std::vector<uint8_t> record(cache_record_size(desc_len), 0);
+        memcpy(&record[0], &record_header, sizeof(record_header));
+        memcpy(&record[sizeof(record_header)], desc, desc_len);
+
+        if (write(fd, &record[0], record.size()) != (ssize_t)record.size())
+        {
+            log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "Descriptor cache write failed, errno %d", errno);
+            close();
+            return;
+        }
+
+        appended.push_back(std::vector<uint8_t>(desc, desc + desc_len));
+        record_value value = {appended.back().data(), desc_len};
+        records[key] = value;
+    }
+#else
+    int descriptor_cache::open(const char *path)
+    {
+        log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "The descriptor cache is not supported on this platform");
+        return -1;
+    }
+
+    void descriptor_cache::close() {}
+
+    void descriptor_cache::index_records() {}
+
+    void descriptor_cache::store(uint64_t entity_model_id, uint16_t config_index, uint16_t desc_type, uint16_t desc_index,
+                                 const uint8_t *desc, uint16_t desc_len) {}
+#endif
+
+    bool descriptor_cache::lookup(uint64_t entity_model_id, uint16_t config_index, uint16_t desc_type, uint16_t desc_index,
+                                  const uint8_t *&desc, uint16_t &desc_len) const
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        record_key key = {entity_model_id, config_index, desc_type, desc_index};
+        std::unordered_map<record_key, record_value, record_key_hash>::const_iterator it = records.find(key);
+
+        if (it == records.end())
+        {
+            return false;
+        }
+
+        desc = it->second.desc;
+        desc_len = it->second.desc_len;
+        return true;
+    }
+
+    bool descriptor_cache::is_static_desc_type(uint16_t desc_type)
+    {
+        switch (desc_type)
+        {
+            // ENTITY, AVB_INTERFACE and CLOCK_SOURCE carry per-entity identifiers, and AUDIO_UNIT,
+            // STREAM_INPUT, STREAM_OUTPUT, CLOCK_DOMAIN and CONTROL carry current settings.
+            // CONFIGURATION, JACK_INPUT, JACK_OUTPUT and AUDIO_CLUSTER have a settable object_name,
+            // and MEMORY_OBJECT also carries its current length.
+            case JDKSAVDECC_DESCRIPTOR_LOCALE:
+            case JDKSAVDECC_DESCRIPTOR_STRINGS:
+            case JDKSAVDECC_DESCRIPTOR_STREAM_PORT_INPUT:
+            case JDKSAVDECC_DESCRIPTOR_STREAM_PORT_OUTPUT:
+            case JDKSAVDECC_DESCRIPTOR_EXTERNAL_PORT_INPUT:
+            case JDKSAVDECC_DESCRIPTOR_EXTERNAL_PORT_OUTPUT:
+            case JDKSAVDECC_DESCRIPTOR_AUDIO_MAP:
+                return true;
+
+            default:
+                return false;
+        }
+    }
+}
@@ -0,0 +1,141 @@
+/*
+ * Licensed under the MIT License (MIT)
+ *
+ * Copyright (c) 2014 AudioScience Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * descriptor_cache.h
+ *
+ * Persistent cache of static AEM descriptors shared by entities with the same entity model ID.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <vector>
+#include <mutex>
+#include <unordered_map>
+
+namespace avdecc_lib
+{
+    /**
+     * Raw READ_DESCRIPTOR response payloads, starting at the descriptor type field, keyed by
+     * (entity_model_id, configuration, descriptor type, descriptor index).
+     *
+     * The cache file is a header followed by appended records. Existing records are read through
+     * a read-only memory mapping, new records are appended to the file and kept in memory until the
+     * cache is next opened. A truncated record at the end of the file is ignored. Records are
+     * written in host byte order.
+     *
+     * Only descriptor types for which is_static_desc_type() is true are cached, which is a small part of
+     * a typical entity model. The others are still read from every End Station, so a cold start with the
+     * cache saves mostly the STRINGS, port and AUDIO_MAP reads rather than the whole enumeration.
+     */
+    class descriptor_cache
+    {
+    public:
+        descriptor_cache();
+
+        ~descriptor_cache();
+
+        /**
+         * Open or create the cache file and index the records in it.
+         *
+         * \return 0 on success, -1 if the file cannot be used.
+         */
+        int open(const char *path);
+
+        /**
+         * Unmap and close the cache file.
+         */
+        void close();
+
+        inline bool is_open() const
+        {
+            return fd >= 0;
+        }
+
+        /**
+         * \return True if descriptors of this type are the same for every entity with the same
+         *         entity model ID, and can be served from the cache. This is the case for LOCALE,
+         *         STRINGS, STREAM_PORT_INPUT/OUTPUT, EXTERNAL_PORT_INPUT/OUTPUT and AUDIO_MAP only,
+         *         the other types carry per-entity identifiers, names or current settings.
+         */
+        static bool is_static_desc_type(uint16_t desc_type);
+
+        /**
+         * Find a cached descriptor. The returned pointer stays valid until the cache is closed.
+         */
+        bool lookup(uint64_t entity_model_id, uint16_t config_index, uint16_t desc_type, uint16_t desc_index,
+                    const uint8_t *&desc, uint16_t &desc_len) const;
+
+        /**
+         * Add a descriptor to the cache and append it to the cache file.
+         */
+        void store(uint64_t entity_model_id, uint16_t config_index, uint16_t desc_type, uint16_t desc_index,
+                   const uint8_t *desc, uint16_t desc_len);
+
+    private:
+        struct record_key
+        {
+            uint64_t entity_model_id;
+            uint16_t config_index;
+            uint16_t desc_type;
+            uint16_t desc_index;
+
+            bool operator==(const record_key &other) const
+            {
+                return (entity_model_id == other.entity_model_id) && (config_index == other.config_index) &&
+                       (desc_type == other.desc_type) && (desc_index == other.desc_index);
+            }
+        };
+
+        struct record_key_hash
+        {
+            size_t operator()(const record_key &k) const
+            {
+                uint64_t h = k.entity_model_id ^ ((uint64_t)k.config_index << 32) ^ ((uint64_t)k.desc_type << 16) ^ k.desc_index;
+                h ^= h >> 33;
+                h *= UINT64_C(0xff51afd7ed558ccd);
+                h ^= h >> 33;
+                return (size_t)h;
+            }
+        };
+
+        struct record_value
+        {
+            const uint8_t *desc;
+            uint16_t desc_len;
+        };
+
+        int fd; // Cache file, opened for appending
+        uint8_t *map_base; // Read-only mapping of the records present when the file was opened
+        size_t map_size;
+        std::unordered_map<record_key, record_value, record_key_hash> records;
+        std::deque<std::vector<uint8_t> > appended; // Payloads of records added since the file was opened
+        mutable std::mutex lock; // Guards records and appended, which every engine shard looks up and stores to
+
+        void index_records();
+    };
+
+    extern descriptor_cache *descriptor_cache_ref;
+}
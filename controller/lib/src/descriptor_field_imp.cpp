@@ -27,8 +27,6 @@
  * Descriptor field class implementation
  */
 
-#include <algorithm>
-#include <vector>
 #include <assert.h>
 #include <stdint.h>
 #include "build.h"
@@ -36,69 +34,59 @@
 #include "descriptor_field_flags_imp.h"
 #include "descriptor_field_imp.h"
 
-static void delete_bitfield(avdecc_lib::descriptor_field_flags_imp *f)
-{
-    delete f;
-}
-
 namespace avdecc_lib
 {
-
-    descriptor_field_imp::descriptor_field_imp(const char * name, enum aem_desc_field_types the_type, void * v) :
-            m_name(name), m_value(v) , m_type(the_type)
+    descriptor_field_imp::descriptor_field_imp() : m_info(NULL), m_value(NULL)
     {
     }
 
-    descriptor_field_imp::~descriptor_field_imp()
-    {
-        std::for_each(m_fields.begin(), m_fields.end(), delete_bitfield);
-        m_fields.clear();
-    }
+    descriptor_field_imp::~descriptor_field_imp() {}
 
-    enum descriptor_field::aem_desc_field_types STDCALL descriptor_field_imp::get_type() const
+    void descriptor_field_imp::bind(const descriptor_field_info *info, const void *storage)
     {
-        return m_type;
+        m_info = info;
+        m_value = (const uint8_t *)storage + info->offset;
     }
 
-    void descriptor_field_imp::append_field(descriptor_field_flags_imp *bit_field)
+    enum descriptor_field::aem_desc_field_types STDCALL descriptor_field_imp::get_type() const
     {
-        m_fields.push_back(bit_field);
+        return m_info->type;
     }
 
     const char * STDCALL descriptor_field_imp::get_name() const
     {
-        return m_name;
+        return m_info->name;
     }
 
     char * STDCALL descriptor_field_imp::get_char() const
     {
-        assert(m_type == TYPE_CHAR);
+        assert(m_info->type == TYPE_CHAR);
         return (char *)m_value;
     }
 
     uint16_t STDCALL descriptor_field_imp::get_uint16() const
     {
-        assert(m_type == TYPE_UINT16);
-        return *(uint16_t *)m_value;
+        assert(m_info->type == TYPE_UINT16);
+        return *(const uint16_t *)m_value;
     }
 
     uint32_t STDCALL descriptor_field_imp::get_uint32() const
     {
-        assert(m_type == TYPE_UINT32);
-        return *(uint32_t *)m_value;
+        assert(m_info->type == TYPE_UINT32);
+        return *(const uint32_t *)m_value;
     }
 
     uint32_t STDCALL descriptor_field_imp::get_flags() const
     {
         uint32_t flag;
-        assert((m_type == TYPE_FLAGS16) || (m_type == TYPE_FLAGS16));
-        if (m_type == TYPE_FLAGS16)
+        assert((m_info->type == TYPE_FLAGS16) || (m_info->type == TYPE_FLAGS32));
+        if (m_info->type == TYPE_FLAGS16)
         {
-            flag = (uint32_t)*(uint16_t *)m_value;
+            flag = (uint32_t)*(const uint16_t *)m_value;
         }
         else
         {
-            flag = *(uint32_t *)m_value;
+            flag = *(const uint32_t *)m_value;
 
         }
         return flag;
@@ -106,14 +94,14 @@ namespace avdecc_lib
 
     uint32_t STDCALL descriptor_field_imp::get_flags_count() const
     {
-        assert((m_type == TYPE_FLAGS16) || (m_type == TYPE_FLAGS16));
-        return m_fields.size();
+        assert((m_info->type == TYPE_FLAGS16) || (m_info->type == TYPE_FLAGS32));
+        return m_info->flags_count;
     }
 
     descriptor_field_flags * STDCALL descriptor_field_imp::get_flag_by_index(uint32_t index) const
     {
-        assert((m_type == TYPE_FLAGS16) || (m_type == TYPE_FLAGS16));
-        return m_fields[index];
+        assert((m_info->type == TYPE_FLAGS16) || (m_info->type == TYPE_FLAGS32));
+        assert(index < m_info->flags_count);
+        return &m_info->flags[index];
     }
 }
-
@@ -29,7 +29,7 @@
 
 #pragma once
 
-#include <vector>
+#include <stddef.h>
 #include <stdint.h>
 #include "build.h"
 
@@ -38,13 +38,31 @@
 
 namespace avdecc_lib
 {
+    /**
+     * Static description of one reflected descriptor field, shared by every descriptor of the type.
+     */
+    struct descriptor_field_info
+    {
+        const char *name;
+        enum descriptor_field::aem_desc_field_types type;
+        size_t offset; // Offset of the value from the start of the descriptor's field storage
+        descriptor_field_flags_imp *flags; // The flag bits of a TYPE_FLAGS16 or TYPE_FLAGS32 field, NULL otherwise
+        uint32_t flags_count;
+    };
+
+    /**
+     * View binding a descriptor_field_info to the field storage of one descriptor.
+     */
     class descriptor_field_imp : public descriptor_field
     {
     public:
-        descriptor_field_imp(const char * name, enum aem_desc_field_types the_type, void * v);
+        descriptor_field_imp();
         virtual ~descriptor_field_imp();
 
-        void append_field(descriptor_field_flags_imp *bit_field);
+        /**
+         * Point the view at a field of a descriptor.
+         */
+        void bind(const descriptor_field_info *info, const void *storage);
 
         const char * STDCALL get_name() const;
         enum descriptor_field::aem_desc_field_types STDCALL get_type() const;
@@ -55,10 +73,8 @@ namespace avdecc_lib
         uint32_t STDCALL get_flags_count() const;
         descriptor_field_flags * STDCALL get_flag_by_index(uint32_t index) const;
     private:
-        const char * m_name;
-        void * m_value;
-        enum aem_desc_field_types m_type;
-        std::vector<descriptor_field_flags_imp *> m_fields;
+        const descriptor_field_info *m_info;
+        const uint8_t *m_value;
     };
 }
 
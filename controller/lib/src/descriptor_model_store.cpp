@@ -0,0 +1,114 @@
+/*
+ * Licensed under the MIT License (MIT)
+ *
+ * Copyright (c) 2014 AudioScience Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * descriptor_model_store.cpp
+ *
+ * Shared descriptor model store implementation
+ */
+
+#include "descriptor_model_store.h"
+
+namespace avdecc_lib
+{
+    descriptor_model_store *descriptor_model_store_ref = new descriptor_model_store();
+
+    static inline uint64_t desc_key(uint16_t config_index, uint16_t desc_type, uint16_t desc_index)
+    {
+        return ((uint64_t)config_index << 32) | ((uint64_t)desc_type << 16) | desc_index;
+    }
+
+    descriptor_model::descriptor_model(uint64_t entity_model_id) : model_id(entity_model_id) {}
+
+    descriptor_model::~descriptor_model()
+    {
+        descriptor_model_store_ref->release(model_id);
+    }
+
+    bool descriptor_model::lookup(uint16_t config_index, uint16_t desc_type, uint16_t desc_index,
+                                  const uint8_t *&desc, uint16_t &desc_len) const
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        std::unordered_map<uint64_t, std::vector<uint8_t> >::const_iterator it = descs.find(desc_key(config_index, desc_type, desc_index));
+
+        if (it == descs.end())
+        {
+            return false;
+        }
+
+        desc = it->second.data();
+        desc_len = (uint16_t)it->second.size();
+        return true;
+    }
+
+    void descriptor_model::store(uint16_t config_index, uint16_t desc_type, uint16_t desc_index,
+                                 const uint8_t *desc, uint16_t desc_len)
+    {
+        uint64_t key = desc_key(config_index, desc_type, desc_index);
+        std::lock_guard<std::mutex> guard(lock);
+
+        if (descs.find(key) == descs.end())
+        {
+            descs[key].assign(desc, desc + desc_len);
+        }
+    }
+
+    std::shared_ptr<descriptor_model> descriptor_model_store::acquire(uint64_t entity_model_id)
+    {
+        // Zero does not identify a model, so entities reporting it share nothing
+        if (entity_model_id == 0)
+        {
+            return std::make_shared<descriptor_model>(entity_model_id);
+        }
+
+        std::lock_guard<std::mutex> guard(lock);
+        std::weak_ptr<descriptor_model> &entry = models[entity_model_id];
+        std::shared_ptr<descriptor_model> model = entry.lock();
+
+        if (!model)
+        {
+            model = std::make_shared<descriptor_model>(entity_model_id);
+            entry = model;
+        }
+
+        return model;
+    }
+
+    size_t descriptor_model_store::model_count() const
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        return models.size();
+    }
+
+    void descriptor_model_store::release(uint64_t entity_model_id)
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        std::unordered_map<uint64_t, std::weak_ptr<descriptor_model> >::iterator it = models.find(entity_model_id);
+
+        // A new model for the same ID may already have replaced the one being freed
+        if ((it != models.end()) && it->second.expired())
+        {
+            models.erase(it);
+        }
+    }
+}
@@ -0,0 +1,99 @@
+/*
+ * Licensed under the MIT License (MIT)
+ *
+ * Copyright (c) 2014 AudioScience Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * descriptor_model_store.h
+ *
+ * Reference counted store of static descriptors shared by End Stations with the same entity model ID.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <unordered_map>
+
+namespace avdecc_lib
+{
+    /**
+     * The static descriptors of one entity model, as raw READ_DESCRIPTOR payloads starting at the
+     * descriptor type field. Every End Station advertising the entity model holds a reference, and
+     * the model is freed with the last one.
+     */
+    class descriptor_model
+    {
+    public:
+        descriptor_model(uint64_t entity_model_id);
+
+        ~descriptor_model();
+
+        inline uint64_t entity_model_id() const
+        {
+            return model_id;
+        }
+
+        /**
+         * Find a descriptor of the model. The returned pointer stays valid while the model exists.
+         */
+        bool lookup(uint16_t config_index, uint16_t desc_type, uint16_t desc_index,
+                    const uint8_t *&desc, uint16_t &desc_len) const;
+
+        /**
+         * Add a descriptor to the model. A descriptor that is already present is kept unchanged.
+         */
+        void store(uint16_t config_index, uint16_t desc_type, uint16_t desc_index,
+                   const uint8_t *desc, uint16_t desc_len);
+
+    private:
+        uint64_t model_id;
+        std::unordered_map<uint64_t, std::vector<uint8_t> > descs; // Payloads by configuration, type and index
+        mutable std::mutex lock; // End Stations of the model may be in different engine shards
+    };
+
+    class descriptor_model_store
+    {
+    public:
+        /**
+         * \return The shared model for the entity model ID, created empty if no End Station holds it.
+         *         An entity model ID of zero gets a new model of its own every time.
+         */
+        std::shared_ptr<descriptor_model> acquire(uint64_t entity_model_id);
+
+        /**
+         * \return The number of entity models currently held by End Stations.
+         */
+        size_t model_count() const;
+
+    private:
+        friend class descriptor_model;
+
+        std::unordered_map<uint64_t, std::weak_ptr<descriptor_model> > models;
+        mutable std::mutex lock; // Guards models, acquired and released by every engine shard
+
+        void release(uint64_t entity_model_id);
+    };
+
+    extern descriptor_model_store *descriptor_model_store_ref;
+}
@@ -29,6 +29,7 @@
 
 #include <vector>
 #include <cstring>
+#include <algorithm>
 #include "avdecc_error.h"
 #include "enumeration.h"
 #include "notification_imp.h"
@@ -39,29 +40,44 @@
 #include "aecp_controller_state_machine.h"
 #include "system_tx_queue.h"
 #include "jdksavdecc.h"
+#include "descriptor_cache.h"
+#include "descriptor_model_store.h"
 #include "end_station_imp.h"
 
+#define BACKGROUND_READ_TIMEOUT_MS 750 // 1722.1 timeout is 250ms
+#define BACKGROUND_READ_BACKOFF_MS 100 // Delay before the first resend, doubled on each further resend
+#define UNSOLICITED_REGISTER_RETRY_MS 5000 // Delay before the first resend of an automatic registration, doubled on each further resend
+#define UNSOLICITED_REGISTER_MAX_ATTEMPTS 5 // Automatic registrations sent before giving up until the End Station is enumerated again
+#define BACKGROUND_READ_MAX_RETRIES 3
+
 namespace avdecc_lib
 {
+    uint16_t end_station_imp::background_read_end_station_limit = 16;
+    uint16_t end_station_imp::background_read_total_limit = 128;
+    thread_local uint32_t end_station_imp::background_read_total_inflight = 0;
+    thread_local std::list<end_station_imp *> end_station_imp::background_read_waiting_list;
+    std::atomic<bool> end_station_imp::unsolicited_auto_register(true);
+
     end_station_imp::end_station_imp(const uint8_t *frame, size_t frame_len)
     {
         end_station_connection_status = ' ';
+        m_background_read_waiting = false;
         adp_ref = new adp(frame, frame_len);
         struct jdksavdecc_eui64 entity_id;
         entity_id = adp_ref->get_entity_entity_id();
         end_station_entity_id = jdksavdecc_uint64_get(&entity_id, 0);
-        utility::convert_eui48_to_uint64(adp_ref->get_src_addr().value, end_station_mac);
+        uint64_t src_mac;
+        utility::convert_eui48_to_uint64(adp_ref->get_src_addr().value, src_mac);
+        end_station_mac = src_mac;
         end_station_init();
     }
 
     end_station_imp::~end_station_imp()
     {
+        background_read_flush();
+        m_background_read_free.clear();
+        m_arena.release();
         delete adp_ref;
-
-        for(uint32_t entity_vec_index = 0; entity_vec_index < entity_desc_vec.size(); entity_vec_index++)
-        {
-            delete entity_desc_vec.at(entity_vec_index);
-        }
     }
 
     int end_station_imp::end_station_init()
@@ -70,21 +86,31 @@ namespace avdecc_lib
         current_config_desc = 0;
         selected_entity_index = 0;
         selected_config_index = 0;
+        m_background_read_window = background_read_end_station_limit;
+        m_unsolicited_registered = false;
+        m_unsolicited_attempts = 0;
+        m_unsolicited_retry.cancel();
+        m_descriptor_model = descriptor_model_store_ref->acquire(adp_ref->get_entity_model_id());
 
         read_desc_init(JDKSAVDECC_DESCRIPTOR_ENTITY, 0);
 
         return 0;
     }
 
-    void end_station_imp::end_station_reenumerate()
+    void end_station_imp::end_station_release()
     {
-        for(uint32_t entity_vec_index = 0; entity_vec_index < entity_desc_vec.size(); entity_vec_index++)
-        {
-            delete entity_desc_vec.at(entity_vec_index);
-        }
+        background_read_flush();
+        background_read_wake_waiting();
 
+        // The whole descriptor tree and the background read requests go with the arena
         entity_desc_vec.clear();
+        m_background_read_free.clear();
+        m_arena.release();
+    }
 
+    void end_station_imp::end_station_reenumerate()
+    {
+        end_station_release();
         end_station_init();
     }
 
@@ -95,12 +121,28 @@ namespace avdecc_lib
 
     void end_station_imp::set_connected()
     {
+        bool is_returning = (end_station_connection_status == 'D');
+
         end_station_connection_status = 'C';
+
+        if (is_returning)
+        {
+            end_station_reenumerate();
+        }
+
+        // An End Station that comes back may have dropped its registrations
+        register_unsolicited_when_enumerated();
     }
 
     void end_station_imp::set_disconnected()
     {
         end_station_connection_status = 'D';
+        m_unsolicited_registered = false;
+        m_unsolicited_attempts = 0;
+        m_unsolicited_retry.cancel();
+
+        // Nothing is kept for an End Station that is gone, it is read again if it comes back
+        end_station_release();
     }
 
     uint64_t STDCALL end_station_imp::entity_id()
@@ -110,7 +152,12 @@ namespace avdecc_lib
 
     uint64_t STDCALL end_station_imp::mac()
     {
-        return end_station_mac;
+        return end_station_mac.load(std::memory_order_relaxed);
+    }
+
+    void end_station_imp::set_end_station_mac(uint64_t mac)
+    {
+        end_station_mac.store(mac, std::memory_order_relaxed);
     }
 
     adp * end_station_imp::get_adp()
@@ -139,6 +186,30 @@ namespace avdecc_lib
         return NULL;
     }
 
+    configuration_descriptor_imp * end_station_imp::current_config_desc_imp()
+    {
+        if((current_entity_desc >= entity_desc_vec.size()) ||
+           (current_config_desc >= entity_desc_vec.at(current_entity_desc)->config_desc_count()))
+        {
+            return NULL;
+        }
+
+        return entity_desc_vec.at(current_entity_desc)->get_config_desc_imp_by_index(current_config_desc);
+    }
+
+    int end_station_imp::proc_resp_without_config_desc(int &status)
+    {
+        log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "0x%llx, response before the CONFIGURATION descriptor has been read", end_station_entity_id);
+        status = AVDECC_LIB_STATUS_INVALID;
+        return -1;
+    }
+
+    uint16_t end_station_imp::read_desc_config_index(uint16_t desc_type)
+    {
+        return (desc_type == JDKSAVDECC_DESCRIPTOR_ENTITY || desc_type == JDKSAVDECC_DESCRIPTOR_CONFIGURATION) ?
+               0 : entity_desc_vec.at(current_entity_desc)->current_configuration();
+    }
+
     int end_station_imp::read_desc_init(uint16_t desc_type, uint16_t desc_index)
     {
         return send_read_desc_cmd_with_flag(NULL, CMD_WITHOUT_NOTIFICATION, desc_type, desc_index);
@@ -161,8 +232,7 @@ namespace avdecc_lib
         aem_command_read_desc.aem_header.command_type = JDKSAVDECC_AEM_COMMAND_READ_DESCRIPTOR;
 
         /******************************************************** AECP Message Specific Data ********************************************************/
-        aem_command_read_desc.configuration_index = (desc_type == JDKSAVDECC_DESCRIPTOR_ENTITY || desc_type == JDKSAVDECC_DESCRIPTOR_CONFIGURATION) ?
-                                                    0 : entity_desc_vec.at(current_entity_desc)->current_configuration();
+        aem_command_read_desc.configuration_index = read_desc_config_index(desc_type);
         aem_command_read_desc.descriptor_type = desc_type;
         aem_command_read_desc.descriptor_index = desc_index;
 
@@ -189,69 +259,39 @@ namespace avdecc_lib
         return 0;
     }
 
-    int end_station_imp::proc_read_desc_resp(void *&notification_id, const uint8_t *frame, size_t frame_len, int &status)
+    void end_station_imp::store_desc(uint16_t desc_type, const uint8_t *frame, ssize_t read_desc_offset, size_t frame_len)
     {
-        const int read_desc_offset = ETHER_HDR_SIZE + JDKSAVDECC_AEM_COMMAND_READ_DESCRIPTOR_RESPONSE_LEN;
-        struct jdksavdecc_frame cmd_frame;
-        struct jdksavdecc_aem_command_read_descriptor_response aem_cmd_read_desc_resp;
-        ssize_t aem_cmd_read_desc_resp_returned;
-        uint32_t msg_type;
-        bool u_field;
-        uint16_t desc_type;
         configuration_descriptor_imp *config_desc_imp_ref = NULL;
-        memset(&aem_cmd_read_desc_resp,0,sizeof(aem_cmd_read_desc_resp));
+        bool store_descriptor = false;
 
-        if(entity_desc_vec.size() >= 1 && entity_desc_vec.at(current_entity_desc)->config_desc_count() >= 1)
+        switch(desc_type)
         {
-            config_desc_imp_ref = dynamic_cast<configuration_descriptor_imp *>(entity_desc_vec.at(current_entity_desc)->get_config_desc_by_index(current_config_desc));
-
-            if(!config_desc_imp_ref)
-            {
-                log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "Dynamic cast from base configuration_descriptor to derived configuration_descriptor_imp error");
-            }
-        }
+            case JDKSAVDECC_DESCRIPTOR_ENTITY:
+                store_descriptor = true;
+                break;
 
-        memcpy(cmd_frame.payload, frame, frame_len);
-        aem_cmd_read_desc_resp_returned = jdksavdecc_aem_command_read_descriptor_response_read(&aem_cmd_read_desc_resp,
-                                                                                               frame,
-                                                                                               ETHER_HDR_SIZE,
-                                                                                               frame_len);
+            case JDKSAVDECC_DESCRIPTOR_CONFIGURATION:
+                if(entity_desc_vec.size() == 1 && entity_desc_vec.at(current_entity_desc)->config_desc_count() == 0)
+                {
+                    store_descriptor = true;
+                }
+                break;
 
-        if(aem_cmd_read_desc_resp_returned < 0)
-        {
-            log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "aem_cmd_read_desc_res_read error");
-            return -1;
+            default:
+                if(entity_desc_vec.size() == 1 && entity_desc_vec.at(current_entity_desc)->config_desc_count() >= 1)
+                {
+                    store_descriptor = true;
+                }
+                break;
         }
 
-        msg_type = aem_cmd_read_desc_resp.aem_header.aecpdu_header.header.message_type;
-        status = aem_cmd_read_desc_resp.aem_header.aecpdu_header.header.status;
-        u_field = aem_cmd_read_desc_resp.aem_header.command_type >> 15 & 0x01; // u_field = the msb of the uint16_t command_type
-        desc_type = jdksavdecc_uint16_get(frame, ETHER_HDR_SIZE + JDKSAVDECC_AEM_COMMAND_READ_DESCRIPTOR_RESPONSE_OFFSET_DESCRIPTOR);
-
-        aecp_controller_state_machine_ref->update_inflight_for_rcvd_resp(notification_id, msg_type, u_field, &cmd_frame);
-
-        bool store_descriptor = false;
-        if(status == avdecc_lib::AEM_STATUS_SUCCESS)
+        if(entity_desc_vec.size() >= 1 && entity_desc_vec.at(current_entity_desc)->config_desc_count() >= 1)
         {
-            switch(desc_type)
-            {
-                case JDKSAVDECC_DESCRIPTOR_ENTITY:
-                    store_descriptor = true;
-                    break;
+            config_desc_imp_ref = entity_desc_vec.at(current_entity_desc)->get_config_desc_imp_by_index(current_config_desc);
 
-                case JDKSAVDECC_DESCRIPTOR_CONFIGURATION:
-                    if(entity_desc_vec.size() == 1 && entity_desc_vec.at(current_entity_desc)->config_desc_count() == 0)
-                    {
-                        store_descriptor = true;
-                    }
-                    break;
-
-                default:
-                    if(entity_desc_vec.size() == 1 && entity_desc_vec.at(current_entity_desc)->config_desc_count() >= 1)
-                    {
-                        store_descriptor = true;
-                    }
-                    break;
+            if(!config_desc_imp_ref)
+            {
+                log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "configuration_descriptor lookup error");
             }
         }
 
@@ -264,7 +304,7 @@ namespace avdecc_lib
                     case JDKSAVDECC_DESCRIPTOR_ENTITY:
                         if (entity_desc_vec.size() == 0)
                         {
-                            entity_desc_vec.push_back(new entity_descriptor_imp(this, frame, read_desc_offset, frame_len));
+                            entity_desc_vec.push_back(m_arena.create<entity_descriptor_imp>(this, frame, read_desc_offset, frame_len));
                             current_config_desc = entity_desc_vec.at(current_entity_desc)->current_configuration();
                         }
                         break;
@@ -363,45 +403,119 @@ namespace avdecc_lib
             }
             background_read_deduce_next(cd, desc_type, (void *)frame, read_desc_offset);
         }
-        background_read_update_inflight(desc_type, (void *)frame, read_desc_offset);
-        background_read_submit_pending();
+    }
+
+    int end_station_imp::proc_read_desc_resp(void *&notification_id, const uint8_t *frame, size_t frame_len, int &status)
+    {
+        const int read_desc_offset = ETHER_HDR_SIZE + JDKSAVDECC_AEM_COMMAND_READ_DESCRIPTOR_RESPONSE_LEN;
+        struct jdksavdecc_frame cmd_frame;
+        struct jdksavdecc_aem_command_read_descriptor_response aem_cmd_read_desc_resp;
+        ssize_t aem_cmd_read_desc_resp_returned;
+        uint32_t msg_type;
+        bool u_field;
+        uint16_t desc_type;
+        memset(&aem_cmd_read_desc_resp,0,sizeof(aem_cmd_read_desc_resp));
 
-        if ((entity_desc_vec.size() >= 1) && (entity_desc_vec.at(current_entity_desc)->config_desc_count() >= 1))
+        memcpy(cmd_frame.payload, frame, frame_len);
+        aem_cmd_read_desc_resp_returned = jdksavdecc_aem_command_read_descriptor_response_read(&aem_cmd_read_desc_resp,
+                                                                                               frame,
+                                                                                               ETHER_HDR_SIZE,
+                                                                                               frame_len);
+
+        if(aem_cmd_read_desc_resp_returned < 0)
         {
-            if (m_backbround_read_inflight.empty() && m_backbround_read_pending.empty())
+            log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "aem_cmd_read_desc_res_read error");
+            return -1;
+        }
+
+        msg_type = aem_cmd_read_desc_resp.aem_header.aecpdu_header.header.message_type;
+        status = aem_cmd_read_desc_resp.aem_header.aecpdu_header.header.status;
+        u_field = aem_cmd_read_desc_resp.aem_header.command_type >> 15 & 0x01; // u_field = the msb of the uint16_t command_type
+        desc_type = jdksavdecc_uint16_get(frame, ETHER_HDR_SIZE + JDKSAVDECC_AEM_COMMAND_READ_DESCRIPTOR_RESPONSE_OFFSET_DESCRIPTOR);
+
+        aecp_controller_state_machine_ref->update_inflight_for_rcvd_resp(notification_id, msg_type, u_field, &cmd_frame);
+
+        // A response that arrives after the End Station departed must not rebuild its descriptor tree
+        if((status == avdecc_lib::AEM_STATUS_SUCCESS) && ((ssize_t)frame_len > read_desc_offset) &&
+           (end_station_connection_status != 'D'))
+        {
+            if(is_shared_desc_type(desc_type))
             {
-                notification_imp_ref->post_notification_msg(END_STATION_READ_COMPLETED, end_station_entity_id, 0, 0, 0, 0, NULL);
+                uint16_t desc_index = jdksavdecc_uint16_get(frame, read_desc_offset + 2);
+                uint16_t desc_len = (uint16_t)(frame_len - read_desc_offset);
+
+                m_descriptor_model->store(aem_cmd_read_desc_resp.configuration_index, desc_type, desc_index, frame + read_desc_offset, desc_len);
+                if(descriptor_cache_ref->is_open())
+                {
+                    descriptor_cache_ref->store(adp_ref->get_entity_model_id(), aem_cmd_read_desc_resp.configuration_index,
+                                                desc_type, desc_index, frame + read_desc_offset, desc_len);
+                }
             }
+
+            store_desc(desc_type, frame, read_desc_offset, frame_len);
         }
 
+        background_read_update_inflight(desc_type, (void *)frame, read_desc_offset, status);
+        background_read_submit_pending();
+
         return 0;
     }
 
-    void end_station_imp::background_read_update_timeouts(void)
+    void end_station_imp::background_read_timeout(background_read_request *b)
     {
-        std::list<background_read_request *>::iterator ii;
-        background_read_request *b;
+        log_imp_ref->post_log_msg(LOGGING_LEVEL_DEBUG, "Background read timeout reading descriptor %s index %d", utility::aem_desc_value_to_name(b->m_type), b->m_index);
+        m_backbround_read_inflight.remove(b);
+        background_read_total_inflight--;
+        background_read_retry(b);
 
-        ii = m_backbround_read_inflight.begin();
-        while (ii != m_backbround_read_inflight.end())
+        background_read_wake_waiting();
+        background_read_submit_pending();
+    }
+
+    void end_station_imp::background_read_timeout_cb(void *context)
+    {
+        background_read_request *b = (background_read_request *)context;
+
+        b->m_end_station->background_read_timeout(b);
+    }
+
+    void end_station_imp::background_read_backoff_expired(background_read_request *b)
+    {
+        m_backbround_read_backoff.remove(b);
+        m_backbround_read_pending.push_front(b);
+
+        background_read_submit_pending();
+    }
+
+    void end_station_imp::background_read_backoff_cb(void *context)
+    {
+        background_read_request *b = (background_read_request *)context;
+
+        b->m_end_station->background_read_backoff_expired(b);
+    }
+
+    void end_station_imp::background_read_retry(background_read_request *b)
+    {
+        // Multiplicative decrease, the window grows back by one for each successful read
+        m_background_read_window = std::max<uint16_t>(m_background_read_window / 2, 1);
+
+        if (b->m_retries < BACKGROUND_READ_MAX_RETRIES)
         {
-            b = *ii;
-            // check inflight timeout
-            if (b->m_timer.timeout())
-            {
-                log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "Background read timeout reading descriptor %s index %d\n", utility::aem_desc_value_to_name(b->m_type), b->m_index);
-                ii = m_backbround_read_inflight.erase(ii);
-                delete b;
-            }
-            else
-            {
-                ++ii;
-            }
+            uint32_t delay_ms = BACKGROUND_READ_BACKOFF_MS << b->m_retries;
+
+            b->m_retries++;
+            m_backbround_read_backoff.push_back(b);
+            timer_wheel_ref->schedule(&b->m_timer, delay_ms, &background_read_backoff_cb, b);
+        }
+        else
+        {
+            log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "Background read of descriptor %s index %d failed after %d attempts",
+                                      utility::aem_desc_value_to_name(b->m_type), b->m_index, b->m_retries + 1);
+            background_read_release(b);
         }
     }
 
-
-    void end_station_imp::background_read_update_inflight(uint16_t desc_type, void *frame, ssize_t read_desc_offset)
+    void end_station_imp::background_read_update_inflight(uint16_t desc_type, void *frame, ssize_t read_desc_offset, int status)
     {
         std::list<background_read_request *>::iterator ii;
         background_read_request *b;
@@ -409,59 +523,236 @@ namespace avdecc_lib
 
         bool have_index = desc_index_from_frame(desc_type, frame, read_desc_offset, desc_index);
 
+        if (!have_index)
+        {
+            return;
+        }
+
         ii = m_backbround_read_inflight.begin();
         while (ii != m_backbround_read_inflight.end())
         {
             b = *ii;
             // check inflight has been read
-            if (have_index && (b->m_type == desc_type) && (b->m_index == desc_index))
+            if ((b->m_type == desc_type) && (b->m_index == desc_index))
             {
                 ii = m_backbround_read_inflight.erase(ii);
-                delete b;
+                background_read_total_inflight--;
+
+                if (status == AEM_STATUS_NO_RESOURCES)
+                {
+                    // The entity cannot handle this many outstanding commands
+                    background_read_retry(b);
+                }
+                else
+                {
+                    if (m_background_read_window < background_read_end_station_limit)
+                    {
+                        m_background_read_window++;
+                    }
+                    background_read_release(b);
+                }
             }
             else
             {
                 ++ii;
             }
         }
+
+        // A late response to a read that timed out makes the resend unnecessary
+        if (status != AEM_STATUS_NO_RESOURCES)
+        {
+            ii = m_backbround_read_backoff.begin();
+            while (ii != m_backbround_read_backoff.end())
+            {
+                b = *ii;
+                if ((b->m_type == desc_type) && (b->m_index == desc_index))
+                {
+                    ii = m_backbround_read_backoff.erase(ii);
+                    background_read_release(b);
+                }
+                else
+                {
+                    ++ii;
+                }
+            }
+        }
+
+        background_read_wake_waiting();
     }
 
     void end_station_imp::background_read_submit_pending(void)
     {
-        // if there are no pending inflight, but the background read list is not
-        // empty submit the next set of read operations
-        if (m_backbround_read_inflight.empty() && !m_backbround_read_pending.empty())
-        {
-            background_read_request *b_first = m_backbround_read_pending.front();
-            m_backbround_read_pending.pop_front();
-            log_imp_ref->post_log_msg(LOGGING_LEVEL_DEBUG, "Background read of %s index %d", utility::aem_desc_value_to_name(b_first->m_type), b_first->m_index);
-            read_desc_init(b_first->m_type, b_first->m_index);
-            b_first->m_timer.start(750);       // 750 ms timeout (1722.1 timeout is 250ms)
-            m_backbround_read_inflight.push_back(b_first);
+        // Keep up to the window of reads on the wire. Descriptors are stored by index, so responses
+        // of different types may arrive in any order.
+        uint16_t window = std::min(m_background_read_window, background_read_end_station_limit);
 
-            if (!m_backbround_read_pending.empty())
+        while (!m_backbround_read_pending.empty() && (m_backbround_read_inflight.size() < window))
+        {
+            if (background_read_total_inflight >= background_read_total_limit)
             {
-                background_read_request *b_next = m_backbround_read_pending.front();
-                while (b_next->m_type == b_first->m_type)
+                if (!m_background_read_waiting)
                 {
-                    m_backbround_read_pending.pop_front();
-                    log_imp_ref->post_log_msg(LOGGING_LEVEL_DEBUG, "Background read of %s index %d", utility::aem_desc_value_to_name(b_next->m_type), b_next->m_index);
-                    read_desc_init(b_next->m_type, b_next->m_index);
-                    b_next->m_timer.start(750);       // 750 ms timeout (1722.1 timeout is 250ms)
-                    m_backbround_read_inflight.push_back(b_next);
-                    if (m_backbround_read_pending.empty())
-                    {
-                        break;
-                    }
-                    else
-                    {
-                        b_next = m_backbround_read_pending.front();
-                    }
+                    m_background_read_waiting = true;
+                    background_read_waiting_list.push_back(this);
                 }
+                break;
             }
+
+            background_read_request *b = m_backbround_read_pending.front();
+            m_backbround_read_pending.pop_front();
+
+            if (background_read_from_cache(b))
+            {
+                background_read_release(b);
+                continue;
+            }
+
+            log_imp_ref->post_log_msg(LOGGING_LEVEL_DEBUG, "Background read of %s index %d", utility::aem_desc_value_to_name(b->m_type), b->m_index);
+            read_desc_init(b->m_type, b->m_index);
+            timer_wheel_ref->schedule(&b->m_timer, BACKGROUND_READ_TIMEOUT_MS, &background_read_timeout_cb, b);
+            m_backbround_read_inflight.push_back(b);
+            background_read_total_inflight++;
+        }
+
+        // Every background read has finished, whether the last one succeeded, was served from the
+        // shared model or was given up on after its retries
+        if ((entity_desc_vec.size() >= 1) &&
+            m_backbround_read_inflight.empty() && m_backbround_read_pending.empty() && m_backbround_read_backoff.empty())
+        {
+            notification_imp_ref->post_notification_msg(END_STATION_READ_COMPLETED, end_station_entity_id, 0, 0, 0, 0, NULL);
+            register_unsolicited_when_enumerated();
         }
     }
 
+    bool end_station_imp::background_read_from_cache(background_read_request *b)
+    {
+        const ssize_t read_desc_offset = ETHER_HDR_SIZE + JDKSAVDECC_AEM_COMMAND_READ_DESCRIPTOR_RESPONSE_LEN;
+        struct jdksavdecc_frame cache_frame;
+        const uint8_t *desc;
+        uint16_t desc_len;
+        uint16_t config_index;
+
+        if (!is_shared_desc_type(b->m_type))
+        {
+            return false;
+        }
+
+        // Another End Station with the same entity model may already have read the descriptor
+        config_index = read_desc_config_index(b->m_type);
+        if (!m_descriptor_model->lookup(config_index, b->m_type, b->m_index, desc, desc_len))
+        {
+            if (!descriptor_cache_ref->is_open() ||
+                !descriptor_cache_ref->lookup(adp_ref->get_entity_model_id(), config_index, b->m_type, b->m_index, desc, desc_len))
+            {
+                return false;
+            }
+            m_descriptor_model->store(config_index, b->m_type, b->m_index, desc, desc_len);
+        }
+
+        if (read_desc_offset + desc_len > (ssize_t)sizeof(cache_frame.payload))
+        {
+            return false;
+        }
+
+        // Rebuild the response frame around the cached descriptor, only the descriptor is parsed
+        memset(cache_frame.payload, 0, read_desc_offset);
+        memcpy(cache_frame.payload + read_desc_offset, desc, desc_len);
+
+        log_imp_ref->post_log_msg(LOGGING_LEVEL_DEBUG, "Background read of %s index %d from the shared descriptor model", utility::aem_desc_value_to_name(b->m_type), b->m_index);
+        store_desc(b->m_type, cache_frame.payload, read_desc_offset, read_desc_offset + desc_len);
+
+        return true;
+    }
+
+    bool end_station_imp::is_shared_desc_type(uint16_t desc_type)
+    {
+        // An entity model ID of zero says nothing about the model, so unrelated entities may report it
+        return (adp_ref->get_entity_model_id() != 0) && descriptor_cache::is_static_desc_type(desc_type);
+    }
+
+    const uint8_t * end_station_imp::store_payload(const uint8_t *desc, size_t desc_len)
+    {
+        uint16_t desc_type = jdksavdecc_uint16_get(desc, 0);
+        const uint8_t *shared_desc;
+        uint16_t shared_desc_len;
+
+        if (is_shared_desc_type(desc_type) &&
+            m_descriptor_model->lookup(read_desc_config_index(desc_type), desc_type, jdksavdecc_uint16_get(desc, 2), shared_desc, shared_desc_len) &&
+            (shared_desc_len == desc_len) && (memcmp(shared_desc, desc, desc_len) == 0))
+        {
+            return shared_desc;
+        }
+
+        return m_arena.store(desc, desc_len);
+    }
+
+    void end_station_imp::background_read_wake_waiting()
+    {
+        while (!background_read_waiting_list.empty() && (background_read_total_inflight < background_read_total_limit))
+        {
+            end_station_imp *end_station = background_read_waiting_list.front();
+            background_read_waiting_list.pop_front();
+            end_station->m_background_read_waiting = false;
+            end_station->background_read_submit_pending();
+        }
+    }
+
+    void end_station_imp::background_read_flush()
+    {
+        std::list<background_read_request *>::iterator ii;
+
+        for (ii = m_backbround_read_pending.begin(); ii != m_backbround_read_pending.end(); ++ii)
+        {
+            background_read_release(*ii);
+        }
+        for (ii = m_backbround_read_inflight.begin(); ii != m_backbround_read_inflight.end(); ++ii)
+        {
+            background_read_release(*ii);
+        }
+        for (ii = m_backbround_read_backoff.begin(); ii != m_backbround_read_backoff.end(); ++ii)
+        {
+            background_read_release(*ii);
+        }
+
+        background_read_total_inflight -= (uint32_t)m_backbround_read_inflight.size();
+        m_backbround_read_pending.clear();
+        m_backbround_read_inflight.clear();
+        m_backbround_read_backoff.clear();
+
+        if (m_background_read_waiting)
+        {
+            background_read_waiting_list.remove(this);
+            m_background_read_waiting = false;
+        }
+    }
+
+    background_read_request *end_station_imp::background_read_alloc(uint16_t desc_type, uint16_t desc_index)
+    {
+        if (m_background_read_free.empty())
+        {
+            return m_arena.create<background_read_request>(this, desc_type, desc_index);
+        }
+
+        background_read_request *b = m_background_read_free.back();
+        m_background_read_free.pop_back();
+        b->m_type = desc_type;
+        b->m_index = desc_index;
+        b->m_retries = 0;
+        return b;
+    }
+
+    void end_station_imp::background_read_release(background_read_request *b)
+    {
+        b->m_timer.cancel();
+        m_background_read_free.push_back(b);
+    }
+
+    void end_station_imp::set_background_read_limits(uint16_t end_station_limit, uint16_t total_limit)
+    {
+        background_read_end_station_limit = std::max(end_station_limit, (uint16_t)1);
+        background_read_total_limit = std::max(total_limit, (uint16_t)1);
+    }
+
     bool end_station_imp::desc_index_from_frame(uint16_t desc_type, void *frame, ssize_t read_desc_offset, uint16_t &desc_index)
     {
         switch (desc_type)
@@ -662,7 +953,7 @@ namespace avdecc_lib
 
         for (int i = 0; i < desc_count; i++)
         {
-            b = new background_read_request(desc_type, desc_base_index + i);
+            b = background_read_alloc(desc_type, desc_base_index + i);
             m_backbround_read_pending.push_back(b);
         }
     }
@@ -742,6 +1033,7 @@ namespace avdecc_lib
         uint16_t cmd_type;
         uint16_t desc_type;
         uint16_t desc_index;
+        configuration_descriptor_imp *config_desc_imp_ref = current_config_desc_imp(); // NULL until the CONFIGURATION descriptor has been read
         cmd_type = jdksavdecc_aecpdu_aem_get_command_type(frame, ETHER_HDR_SIZE);
         cmd_type &= 0x7FFF;
 
@@ -755,7 +1047,7 @@ namespace avdecc_lib
                     if(desc_type == JDKSAVDECC_DESCRIPTOR_ENTITY)
                     {
                         entity_descriptor_imp *entity_desc_imp_ref =
-                            dynamic_cast<entity_descriptor_imp *>(entity_desc_vec.at(current_entity_desc));
+                            (current_entity_desc < entity_desc_vec.size()) ? entity_desc_vec.at(current_entity_desc) : NULL;
 
                         if(entity_desc_imp_ref)
                         {
@@ -763,13 +1055,16 @@ namespace avdecc_lib
                         }
                         else
                         {
-                            log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "Dynamic cast from base entity_descriptor to derived entity_descriptor_imp error");
+                            log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "entity_descriptor lookup error");
                         }
                     }
                     else if(desc_type == JDKSAVDECC_DESCRIPTOR_STREAM_INPUT)
                     {
+                        if(!config_desc_imp_ref)
+                            return proc_resp_without_config_desc(status);
+
                         stream_input_descriptor_imp *stream_input_desc_imp_ref =
-                            dynamic_cast<stream_input_descriptor_imp *>(entity_desc_vec.at(current_entity_desc)->get_config_desc_by_index(current_config_desc)->get_stream_input_desc_by_index(desc_index));
+                            config_desc_imp_ref->get_stream_input_desc_imp_by_index(desc_index);
 
                         if(stream_input_desc_imp_ref)
                         {
@@ -777,13 +1072,16 @@ namespace avdecc_lib
                         }
                         else
                         {
-                            log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "Dynamic cast from base stream_input_descriptor to derived stream_input_descriptor_imp error");
+                            log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "stream_input_descriptor lookup error");
                         }
                     }
                     else if(desc_type == JDKSAVDECC_DESCRIPTOR_STREAM_OUTPUT)
                     {
+                        if(!config_desc_imp_ref)
+                            return proc_resp_without_config_desc(status);
+
                         stream_output_descriptor_imp *stream_output_desc_imp_ref =
-                            dynamic_cast<stream_output_descriptor_imp *>(entity_desc_vec.at(current_entity_desc)->get_config_desc_by_index(current_config_desc)->get_stream_output_desc_by_index(desc_index));
+                            config_desc_imp_ref->get_stream_output_desc_imp_by_index(desc_index);
 
                         if(stream_output_desc_imp_ref)
                         {
@@ -791,7 +1089,7 @@ namespace avdecc_lib
                         }
                         else
                         {
-                            log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "Dynamic cast from base stream_output_descriptor_imp to derived stream_output_descriptor_imp error");
+                            log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "stream_output_descriptor lookup error");
                         }
                     }
                     else
@@ -810,7 +1108,7 @@ namespace avdecc_lib
                     if(desc_type == JDKSAVDECC_DESCRIPTOR_ENTITY)
                     {
                         entity_descriptor_imp *entity_desc_imp_ref =
-                            dynamic_cast<entity_descriptor_imp *>(entity_desc_vec.at(current_entity_desc));
+                            (current_entity_desc < entity_desc_vec.size()) ? entity_desc_vec.at(current_entity_desc) : NULL;
 
                         if(entity_desc_imp_ref)
                         {
@@ -818,13 +1116,16 @@ namespace avdecc_lib
                         }
                         else
                         {
-                            log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "Dynamic cast from base entity_descriptor to derived entity_descriptor_imp error");
+                            log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "entity_descriptor lookup error");
                         }
                     }
                     else if(desc_type == JDKSAVDECC_DESCRIPTOR_STREAM_INPUT)
                     {
+                        if(!config_desc_imp_ref)
+                            return proc_resp_without_config_desc(status);
+
                         stream_input_descriptor_imp *stream_input_desc_imp_ref =
-                            dynamic_cast<stream_input_descriptor_imp *>(entity_desc_vec.at(current_entity_desc)->get_config_desc_by_index(current_config_desc)->get_stream_input_desc_by_index(desc_index));
+                            config_desc_imp_ref->get_stream_input_desc_imp_by_index(desc_index);
 
                         if(stream_input_desc_imp_ref)
                         {
@@ -832,13 +1133,16 @@ namespace avdecc_lib
                         }
                         else
                         {
-                            log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "Dynamic cast from base stream_input_descriptor to derived stream_input_descriptor_imp error");
+                            log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "stream_input_descriptor lookup error");
                         }
                     }
                     else if(desc_type == JDKSAVDECC_DESCRIPTOR_STREAM_OUTPUT)
                     {
+                        if(!config_desc_imp_ref)
+                            return proc_resp_without_config_desc(status);
+
                         stream_output_descriptor_imp *stream_output_desc_imp_ref =
-                            dynamic_cast<stream_output_descriptor_imp *>(entity_desc_vec.at(current_entity_desc)->get_config_desc_by_index(current_config_desc)->get_stream_output_desc_by_index(desc_index));
+                            config_desc_imp_ref->get_stream_output_desc_imp_by_index(desc_index);
 
                         if(stream_output_desc_imp_ref)
                         {
@@ -846,7 +1150,7 @@ namespace avdecc_lib
                         }
                         else
                         {
-                            log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "Dynamic cast from base stream_output_descriptor_imp to derived stream_output_descriptor_imp error");
+                            log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "stream_output_descriptor lookup error");
                         }
                     }
                     else
@@ -872,8 +1176,11 @@ namespace avdecc_lib
 
                     if(desc_type == JDKSAVDECC_DESCRIPTOR_STREAM_INPUT)
                     {
+                        if(!config_desc_imp_ref)
+                            return proc_resp_without_config_desc(status);
+
                         stream_input_descriptor_imp *stream_input_desc_imp_ref =
-                            dynamic_cast<stream_input_descriptor_imp *>(entity_desc_vec.at(current_entity_desc)->get_config_desc_by_index(current_config_desc)->get_stream_input_desc_by_index(desc_index));
+                            config_desc_imp_ref->get_stream_input_desc_imp_by_index(desc_index);
 
                         if(stream_input_desc_imp_ref)
                         {
@@ -881,13 +1188,16 @@ namespace avdecc_lib
                         }
                         else
                         {
-                            log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "Dynamic cast from base stream_input_descriptor to derived stream_input_descriptor_imp error");
+                            log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "stream_input_descriptor lookup error");
                         }
                     }
                     else if(desc_type == JDKSAVDECC_DESCRIPTOR_STREAM_OUTPUT)
                     {
+                        if(!config_desc_imp_ref)
+                            return proc_resp_without_config_desc(status);
+
                         stream_output_descriptor_imp *stream_output_desc_imp_ref =
-                            dynamic_cast<stream_output_descriptor_imp *>(entity_desc_vec.at(current_entity_desc)->get_config_desc_by_index(current_config_desc)->get_stream_output_desc_by_index(desc_index));
+                            config_desc_imp_ref->get_stream_output_desc_imp_by_index(desc_index);
 
                         if(stream_output_desc_imp_ref)
                         {
@@ -895,7 +1205,7 @@ namespace avdecc_lib
                         }
                         else
                         {
-                            log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "Dynamic cast from base stream_output_descriptor_imp to derived stream_output_descriptor_imp error");
+                            log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "stream_output_descriptor lookup error");
                         }
                     }
                 }
@@ -909,8 +1219,11 @@ namespace avdecc_lib
 
                     if(desc_type == JDKSAVDECC_DESCRIPTOR_STREAM_INPUT)
                     {
+                        if(!config_desc_imp_ref)
+                            return proc_resp_without_config_desc(status);
+
                         stream_input_descriptor_imp *stream_input_desc_imp_ref =
-                            dynamic_cast<stream_input_descriptor_imp *>(entity_desc_vec.at(current_entity_desc)->get_config_desc_by_index(current_config_desc)->get_stream_input_desc_by_index(desc_index));
+                            config_desc_imp_ref->get_stream_input_desc_imp_by_index(desc_index);
 
                         if(stream_input_desc_imp_ref)
                         {
@@ -918,13 +1231,16 @@ namespace avdecc_lib
                         }
                         else
                         {
-                            log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "Dynamic cast from base stream_input_descriptor to derived stream_input_descriptor_imp error");
+                            log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "stream_input_descriptor lookup error");
                         }
                     }
                     else if(desc_type == JDKSAVDECC_DESCRIPTOR_STREAM_OUTPUT)
                     {
+                        if(!config_desc_imp_ref)
+                            return proc_resp_without_config_desc(status);
+
                         stream_output_descriptor_imp *stream_output_desc_imp_ref =
-                            dynamic_cast<stream_output_descriptor_imp *>(entity_desc_vec.at(current_entity_desc)->get_config_desc_by_index(current_config_desc)->get_stream_output_desc_by_index(desc_index));
+                            config_desc_imp_ref->get_stream_output_desc_imp_by_index(desc_index);
 
                         if(stream_output_desc_imp_ref)
                         {
@@ -932,7 +1248,7 @@ namespace avdecc_lib
                         }
                         else
                         {
-                            log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "Dynamic cast from base stream_output_descriptor_imp to derived stream_output_descriptor_imp error");
+                            log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "stream_output_descriptor lookup error");
                         }
                     }
                 }
@@ -944,8 +1260,11 @@ namespace avdecc_lib
                 desc_index = jdksavdecc_aem_command_set_stream_info_response_get_descriptor_index(frame, ETHER_HDR_SIZE);
                 if(desc_type == JDKSAVDECC_DESCRIPTOR_STREAM_INPUT)
                 {
+                    if(!config_desc_imp_ref)
+                        return proc_resp_without_config_desc(status);
+
                     stream_input_descriptor_imp *stream_input_desc_imp_ref =
-                        dynamic_cast<stream_input_descriptor_imp *>(entity_desc_vec.at(current_entity_desc)->get_config_desc_by_index(current_config_desc)->get_stream_input_desc_by_index(desc_index));
+                        config_desc_imp_ref->get_stream_input_desc_imp_by_index(desc_index);
 
                     if(stream_input_desc_imp_ref)
                     {
@@ -953,13 +1272,16 @@ namespace avdecc_lib
                     }
                     else
                     {
-                        log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "Dynamic cast from base stream_input_descriptor to derived stream_input_descriptor_imp error");
+                        log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "stream_input_descriptor lookup error");
                     }
                 }
                 else if(desc_type == JDKSAVDECC_DESCRIPTOR_STREAM_OUTPUT)
                 {
+                    if(!config_desc_imp_ref)
+                        return proc_resp_without_config_desc(status);
+
                     stream_output_descriptor_imp *stream_output_desc_imp_ref =
-                        dynamic_cast<stream_output_descriptor_imp *>(entity_desc_vec.at(current_entity_desc)->get_config_desc_by_index(current_config_desc)->get_stream_output_desc_by_index(desc_index));
+                        config_desc_imp_ref->get_stream_output_desc_imp_by_index(desc_index);
 
                     if(stream_output_desc_imp_ref)
                     {
@@ -967,7 +1289,7 @@ namespace avdecc_lib
                     }
                     else
                     {
-                        log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "Dynamic cast from base stream_output_descriptor_imp to derived stream_output_descriptor_imp error");
+                        log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "stream_output_descriptor lookup error");
                     }
                 }
                 break;
@@ -978,8 +1300,11 @@ namespace avdecc_lib
 
                 if(desc_type == JDKSAVDECC_DESCRIPTOR_STREAM_INPUT)
                 {
+                    if(!config_desc_imp_ref)
+                        return proc_resp_without_config_desc(status);
+
                     stream_input_descriptor_imp *stream_input_desc_imp_ref =
-                        dynamic_cast<stream_input_descriptor_imp *>(entity_desc_vec.at(current_entity_desc)->get_config_desc_by_index(current_config_desc)->get_stream_input_desc_by_index(desc_index));
+                        config_desc_imp_ref->get_stream_input_desc_imp_by_index(desc_index);
 
                     if(stream_input_desc_imp_ref)
                     {
@@ -987,13 +1312,16 @@ namespace avdecc_lib
                     }
                     else
                     {
-                        log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "Dynamic cast from derived stream_input_descriptor_imp to base stream_input_descriptor error");
+                        log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "stream_input_descriptor lookup error");
                     }
                 }
                 else if(desc_type == JDKSAVDECC_DESCRIPTOR_STREAM_OUTPUT)
                 {
+                    if(!config_desc_imp_ref)
+                        return proc_resp_without_config_desc(status);
+
                     stream_output_descriptor_imp *stream_output_desc_imp_ref =
-                        dynamic_cast<stream_output_descriptor_imp *>(entity_desc_vec.at(current_entity_desc)->get_config_desc_by_index(current_config_desc)->get_stream_output_desc_by_index(desc_index));
+                        config_desc_imp_ref->get_stream_output_desc_imp_by_index(desc_index);
 
                     if(stream_output_desc_imp_ref)
                     {
@@ -1001,24 +1329,20 @@ namespace avdecc_lib
                     }
                     else
                     {
-                        log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "Dynamic cast from derived stream_output_descriptor_imp to base stream_output_descriptor error");
+                        log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "stream_output_descriptor lookup error");
                     }
                 }
 
                 break;
 
             case JDKSAVDECC_AEM_COMMAND_SET_NAME:
-                desc_type = jdksavdecc_aem_command_set_name_response_get_descriptor_type(frame, ETHER_HDR_SIZE);
-                desc_index = jdksavdecc_aem_command_set_name_response_get_descriptor_index(frame, ETHER_HDR_SIZE);
-                log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "Need to implement SET_NAME command.");
-
-                break;
-
             case JDKSAVDECC_AEM_COMMAND_GET_NAME:
-                desc_type = jdksavdecc_aem_command_get_name_response_get_descriptor_type(frame, ETHER_HDR_SIZE);
-                desc_index = jdksavdecc_aem_command_get_name_response_get_descriptor_index(frame, ETHER_HDR_SIZE);
-                log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "Need to implement GET_NAME command.");
+                proc_name_resp(notification_id, frame, frame_len, status);
+                break;
 
+            case JDKSAVDECC_AEM_COMMAND_REGISTER_UNSOLICITED_NOTIFICATION:
+            case JDKSAVDECC_AEM_COMMAND_DEREGISTER_UNSOLICITED_NOTIFICATION:
+                proc_unsolicited_cmd_resp(notification_id, frame, frame_len, status);
                 break;
 
             case JDKSAVDECC_AEM_COMMAND_SET_SAMPLING_RATE:
@@ -1028,8 +1352,11 @@ namespace avdecc_lib
 
                     if(desc_type == JDKSAVDECC_DESCRIPTOR_AUDIO_UNIT)
                     {
+                        if(!config_desc_imp_ref)
+                            return proc_resp_without_config_desc(status);
+
                         audio_unit_descriptor_imp *audio_unit_desc_imp_ref =
-                            dynamic_cast<audio_unit_descriptor_imp *>(entity_desc_vec.at(current_entity_desc)->get_config_desc_by_index(current_config_desc)->get_audio_unit_desc_by_index(desc_index));
+                            config_desc_imp_ref->get_audio_unit_desc_imp_by_index(desc_index);
 
                         if(audio_unit_desc_imp_ref)
                         {
@@ -1037,7 +1364,7 @@ namespace avdecc_lib
                         }
                         else
                         {
-                            log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "Dynamic cast from base audio_unit_descriptor to derived audio_unit_descriptor_imp error");
+                            log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "audio_unit_descriptor lookup error");
                         }
                     }
                 }
@@ -1050,8 +1377,11 @@ namespace avdecc_lib
 
                     if(desc_type == JDKSAVDECC_DESCRIPTOR_AUDIO_UNIT)
                     {
+                        if(!config_desc_imp_ref)
+                            return proc_resp_without_config_desc(status);
+
                         audio_unit_descriptor_imp *audio_unit_desc_imp_ref =
-                            dynamic_cast<audio_unit_descriptor_imp *>(entity_desc_vec.at(current_entity_desc)->get_config_desc_by_index(current_config_desc)->get_audio_unit_desc_by_index(desc_index));
+                            config_desc_imp_ref->get_audio_unit_desc_imp_by_index(desc_index);
 
                         if(audio_unit_desc_imp_ref)
                         {
@@ -1059,7 +1389,7 @@ namespace avdecc_lib
                         }
                         else
                         {
-                            log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "Dynamic cast from base audio_unit_descriptor to derived audio_unit_descriptor_imp error");
+                            log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "audio_unit_descriptor lookup error");
                         }
                     }
                 }
@@ -1070,8 +1400,11 @@ namespace avdecc_lib
                     desc_type = jdksavdecc_aem_command_set_clock_source_response_get_descriptor_type(frame, ETHER_HDR_SIZE);
                     desc_index = jdksavdecc_aem_command_set_clock_source_response_get_descriptor_index(frame, ETHER_HDR_SIZE);
 
+                    if(!config_desc_imp_ref)
+                        return proc_resp_without_config_desc(status);
+
                     clock_domain_descriptor_imp *clock_domain_desc_imp_ref =
-                        dynamic_cast<clock_domain_descriptor_imp *>(entity_desc_vec.at(current_entity_desc)->get_config_desc_by_index(current_config_desc)->get_clock_domain_desc_by_index(desc_index));
+                        config_desc_imp_ref->get_clock_domain_desc_imp_by_index(desc_index);
 
                     if(clock_domain_desc_imp_ref)
                     {
@@ -1079,7 +1412,7 @@ namespace avdecc_lib
                     }
                     else
                     {
-                        log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "Dynamic cast from base clock_domain_descriptor to derived clock_domain_descriptor_imp error");
+                        log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "clock_domain_descriptor lookup error");
                     }
                 }
                 break;
@@ -1089,8 +1422,11 @@ namespace avdecc_lib
                     desc_type = jdksavdecc_aem_command_get_clock_source_response_get_descriptor_type(frame, ETHER_HDR_SIZE);
                     desc_index = jdksavdecc_aem_command_get_clock_source_response_get_descriptor_index(frame, ETHER_HDR_SIZE);
 
+                    if(!config_desc_imp_ref)
+                        return proc_resp_without_config_desc(status);
+
                     clock_domain_descriptor_imp *clock_domain_desc_imp_ref =
-                        dynamic_cast<clock_domain_descriptor_imp *>(entity_desc_vec.at(current_entity_desc)->get_config_desc_by_index(current_config_desc)->get_clock_domain_desc_by_index(desc_index));
+                        config_desc_imp_ref->get_clock_domain_desc_imp_by_index(desc_index);
 
                     if(clock_domain_desc_imp_ref)
                     {
@@ -1098,7 +1434,7 @@ namespace avdecc_lib
                     }
                     else
                     {
-                        log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "Dynamic cast from base clock_domain_descriptor to derived clock_domain_descriptor_imp error");
+                        log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "clock_domain_descriptor lookup error");
                     }
                 }
                 break;
@@ -1110,8 +1446,11 @@ namespace avdecc_lib
 
                     if(desc_type == JDKSAVDECC_DESCRIPTOR_STREAM_INPUT)
                     {
+                        if(!config_desc_imp_ref)
+                            return proc_resp_without_config_desc(status);
+
                         stream_input_descriptor_imp *stream_input_desc_imp_ref =
-                            dynamic_cast<stream_input_descriptor_imp *>(entity_desc_vec.at(current_entity_desc)->get_config_desc_by_index(current_config_desc)->get_stream_input_desc_by_index(desc_index));
+                            config_desc_imp_ref->get_stream_input_desc_imp_by_index(desc_index);
 
                         if(stream_input_desc_imp_ref)
                         {
@@ -1119,13 +1458,16 @@ namespace avdecc_lib
                         }
                         else
                         {
-                            log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "Dynamic cast from derived stream_input_descriptor_imp to base stream_input_descriptor error");
+                            log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "stream_input_descriptor lookup error");
                         }
                     }
                     else if(desc_type == JDKSAVDECC_DESCRIPTOR_STREAM_OUTPUT)
                     {
+                        if(!config_desc_imp_ref)
+                            return proc_resp_without_config_desc(status);
+
                         stream_output_descriptor_imp *stream_output_desc_imp_ref =
-                            dynamic_cast<stream_output_descriptor_imp *>(entity_desc_vec.at(current_entity_desc)->get_config_desc_by_index(current_config_desc)->get_stream_output_desc_by_index(desc_index));
+                            config_desc_imp_ref->get_stream_output_desc_imp_by_index(desc_index);
 
                         if(stream_output_desc_imp_ref)
                         {
@@ -1133,7 +1475,7 @@ namespace avdecc_lib
                         }
                         else
                         {
-                            log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "Dynamic cast from derived stream_output_descriptor_imp to base stream_output_descriptor error");
+                            log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "stream_output_descriptor lookup error");
                         }
                     }
                 }
@@ -1146,8 +1488,11 @@ namespace avdecc_lib
 
                     if(desc_type == JDKSAVDECC_DESCRIPTOR_STREAM_INPUT)
                     {
+                        if(!config_desc_imp_ref)
+                            return proc_resp_without_config_desc(status);
+
                         stream_input_descriptor_imp *stream_input_desc_imp_ref =
-                            dynamic_cast<stream_input_descriptor_imp *>(entity_desc_vec.at(current_entity_desc)->get_config_desc_by_index(current_config_desc)->get_stream_input_desc_by_index(desc_index));
+                            config_desc_imp_ref->get_stream_input_desc_imp_by_index(desc_index);
 
                         if(stream_input_desc_imp_ref)
                         {
@@ -1155,13 +1500,16 @@ namespace avdecc_lib
                         }
                         else
                         {
-                            log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "Dynamic cast from derived stream_input_descriptor_imp to base stream_input_descriptor error");
+                            log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "stream_input_descriptor lookup error");
                         }
                     }
                     else if(desc_type == JDKSAVDECC_DESCRIPTOR_STREAM_OUTPUT)
                     {
+                        if(!config_desc_imp_ref)
+                            return proc_resp_without_config_desc(status);
+
                         stream_output_descriptor_imp *stream_output_desc_imp_ref =
-                            dynamic_cast<stream_output_descriptor_imp *>(entity_desc_vec.at(current_entity_desc)->get_config_desc_by_index(current_config_desc)->get_stream_output_desc_by_index(desc_index));
+                            config_desc_imp_ref->get_stream_output_desc_imp_by_index(desc_index);
 
                         if(stream_output_desc_imp_ref)
                         {
@@ -1169,7 +1517,7 @@ namespace avdecc_lib
                         }
                         else
                         {
-                            log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "Dynamic cast from derived stream_output_descriptor_imp to base stream_output_descriptor error");
+                            log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "stream_output_descriptor lookup error");
                         }
                     }
                 }
@@ -1183,7 +1531,7 @@ namespace avdecc_lib
                     if(desc_type == JDKSAVDECC_DESCRIPTOR_ENTITY)
                     {
                         entity_descriptor_imp *entity_desc_imp_ref =
-                            dynamic_cast<entity_descriptor_imp *>(entity_desc_vec.at(current_entity_desc));
+                            (current_entity_desc < entity_desc_vec.size()) ? entity_desc_vec.at(current_entity_desc) : NULL;
 
                         if(entity_desc_imp_ref)
                         {
@@ -1191,7 +1539,7 @@ namespace avdecc_lib
                         }
                         else
                         {
-                            log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "Dynamic cast from base entity_descriptor to derived entity_descriptor_imp error");
+                            log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "entity_descriptor lookup error");
                         }
                     }
                     else
@@ -1209,29 +1557,26 @@ namespace avdecc_lib
 
                     if(desc_type == JDKSAVDECC_DESCRIPTOR_MEMORY_OBJECT)
                     {
-                        memory_object_descriptor *mo = entity_desc_vec.at(current_entity_desc)->get_config_desc_by_index(current_config_desc)->get_memory_object_desc_by_index(desc_index);
+                        if(!config_desc_imp_ref)
+                            return proc_resp_without_config_desc(status);
 
-                        if (mo)
-                        {
-                            memory_object_descriptor_imp *memory_object_desc_imp_ref =
-                                dynamic_cast<memory_object_descriptor_imp *>(mo);
+                        memory_object_descriptor_imp *memory_object_desc_imp_ref =
+                            config_desc_imp_ref->get_memory_object_desc_imp_by_index(desc_index);
 
-                            if(memory_object_desc_imp_ref)
-                            {
-                                uint16_t operation_type;
-                                memory_object_desc_imp_ref->proc_start_operation_resp(notification_id, frame, frame_len, status, operation_id, operation_type);
-                                if (status == AEM_STATUS_SUCCESS && operation_id)
-                                {
-                                    aecp_controller_state_machine_ref->start_operation(notification_id, operation_id, operation_type, frame, frame_len);
-                                    is_operation_id_valid = true;
-                                }
-                            }
-                            else
+                        if(memory_object_desc_imp_ref)
+                        {
+                            uint16_t operation_type;
+                            memory_object_desc_imp_ref->proc_start_operation_resp(notification_id, frame, frame_len, status, operation_id, operation_type);
+                            if (status == AEM_STATUS_SUCCESS && operation_id)
                             {
-                                log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "Dynamic cast from derived memory_object_descriptor_imp to base memory_object_descriptor error");
+                                aecp_controller_state_machine_ref->start_operation(notification_id, operation_id, operation_type, frame, frame_len);
+                                is_operation_id_valid = true;
                             }
                         }
-
+                        else
+                        {
+                            log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "memory_object_descriptor lookup error");
+                        }
                     }
                 }
                 break;
@@ -1243,23 +1588,20 @@ namespace avdecc_lib
 
                     if(desc_type == JDKSAVDECC_DESCRIPTOR_MEMORY_OBJECT)
                     {
-                        memory_object_descriptor *mo = entity_desc_vec.at(current_entity_desc)->get_config_desc_by_index(current_config_desc)->get_memory_object_desc_by_index(desc_index);
+                        if(!config_desc_imp_ref)
+                            return proc_resp_without_config_desc(status);
 
-                        if (mo)
-                        {
-                            memory_object_descriptor_imp *memory_object_desc_imp_ref =
-                                dynamic_cast<memory_object_descriptor_imp *>(mo);
+                        memory_object_descriptor_imp *memory_object_desc_imp_ref =
+                            config_desc_imp_ref->get_memory_object_desc_imp_by_index(desc_index);
 
-                            if(memory_object_desc_imp_ref)
-                            {
-                                memory_object_desc_imp_ref->proc_operation_status_resp(notification_id, frame, frame_len, status, operation_id, is_operation_id_valid);
-                            }
-                            else
-                            {
-                                log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "Dynamic cast from derived memory_object_descriptor_imp to base memory_object_descriptor error");
-                            }
+                        if(memory_object_desc_imp_ref)
+                        {
+                            memory_object_desc_imp_ref->proc_operation_status_resp(notification_id, frame, frame_len, status, operation_id, is_operation_id_valid);
+                        }
+                        else
+                        {
+                            log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "memory_object_descriptor lookup error");
                         }
-
                     }
                 }
                 break;
@@ -1283,9 +1625,27 @@ namespace avdecc_lib
                                                               uint64_t address,
                                                               uint8_t memory_data[])
     {
-        struct jdksavdecc_aecp_aa aecp_cmd_aa_header;
         struct jdksavdecc_frame cmd_frame;
+
+        if (aecp_aa_frame_init(&cmd_frame, mode, length, address, memory_data) < 0)
+        {
+            return -1;
+        }
+
+        system_queue_tx(notification_id, CMD_WITH_NOTIFICATION, cmd_frame.payload, cmd_frame.length);
+
+        return 0;
+    }
+
+    int end_station_imp::aecp_aa_frame_init(struct jdksavdecc_frame *cmd_frame,
+                                            unsigned mode,
+                                            unsigned length,
+                                            uint64_t address,
+                                            const uint8_t *memory_data)
+    {
+        struct jdksavdecc_aecp_aa aecp_cmd_aa_header;
         struct jdksavdecc_aecp_aa_tlv aa_tlv;
+        unsigned data_length = (mode == JDKSAVDECC_AECP_AA_MODE_READ) ? 0 : length; // A READ carries no data, only its length
         memset(&aecp_cmd_aa_header,0,sizeof(aecp_cmd_aa_header));
 
 
@@ -1293,13 +1653,13 @@ namespace avdecc_lib
         aecp_cmd_aa_header.sequence_id = 0;
         aecp_cmd_aa_header.tlv_count = 1;
 
-        aecp_controller_state_machine_ref->ether_frame_init(end_station_mac, &cmd_frame,
-                                                            ETHER_HDR_SIZE + JDKSAVDECC_AECPDU_AA_LEN + JDKSAVDECC_AECPDU_AA_TLV_LEN + length);
+        aecp_controller_state_machine_ref->ether_frame_init(end_station_mac, cmd_frame,
+                                                            ETHER_HDR_SIZE + JDKSAVDECC_AECPDU_AA_LEN + JDKSAVDECC_AECPDU_AA_TLV_LEN + data_length);
 
         ssize_t write_return_val = jdksavdecc_aecp_aa_write(&aecp_cmd_aa_header,
-                                                            cmd_frame.payload,
+                                                            cmd_frame->payload,
                                                             ETHER_HDR_SIZE,
-                                                            sizeof(cmd_frame.payload));
+                                                            sizeof(cmd_frame->payload));
 
         if(write_return_val < 0)
         {
@@ -1312,9 +1672,9 @@ namespace avdecc_lib
         aa_tlv.address_lower = address & 0xFFFFFFFF;
 
         write_return_val = jdksavdecc_aecp_aa_tlv_write(&aa_tlv,
-                                                        cmd_frame.payload,
+                                                        cmd_frame->payload,
                                                         ETHER_HDR_SIZE + JDKSAVDECC_AECPDU_AA_LEN,
-                                                        sizeof(cmd_frame.payload));
+                                                        sizeof(cmd_frame->payload));
 
         if(write_return_val < 0)
         {
@@ -1322,16 +1682,17 @@ namespace avdecc_lib
             return -1;
         }
 
-        memcpy(&cmd_frame.payload[ETHER_HDR_SIZE + JDKSAVDECC_AECPDU_AA_LEN + JDKSAVDECC_AECPDU_AA_TLV_LEN], memory_data, length);
+        if (memory_data && data_length)
+        {
+            memcpy(&cmd_frame->payload[ETHER_HDR_SIZE + JDKSAVDECC_AECPDU_AA_LEN + JDKSAVDECC_AECPDU_AA_TLV_LEN], memory_data, data_length);
+        }
 
         aecp_controller_state_machine_ref->common_hdr_init(JDKSAVDECC_AECP_MESSAGE_TYPE_ADDRESS_ACCESS_COMMAND,
-                                                           &cmd_frame,
+                                                           cmd_frame,
                                                            end_station_entity_id,
-                                                           JDKSAVDECC_AECPDU_AA_LEN + JDKSAVDECC_AECPDU_AA_TLV_LEN + length -
+                                                           JDKSAVDECC_AECPDU_AA_LEN + JDKSAVDECC_AECPDU_AA_TLV_LEN + data_length -
                                                            JDKSAVDECC_COMMON_CONTROL_HEADER_LEN);
 
-        system_queue_tx(notification_id, CMD_WITH_NOTIFICATION, cmd_frame.payload, cmd_frame.length);
-
         return 0;
     }
 
@@ -1383,11 +1744,198 @@ namespace avdecc_lib
     int end_station_imp::proc_set_control_resp(void *&notification_id, const uint8_t *frame, size_t frame_len, int &status)
     {
         struct jdksavdecc_frame cmd_frame;
+        bool u_field = jdksavdecc_aecpdu_aem_get_command_type(frame, ETHER_HDR_SIZE) >> 15 & 0x01; // u_field = the msb of the uint16_t command_type
+
+        memcpy(cmd_frame.payload, frame, frame_len);
+        aecp_controller_state_machine_ref->update_inflight_for_rcvd_resp(notification_id, JDKSAVDECC_AECP_MESSAGE_TYPE_AEM_RESPONSE, u_field, &cmd_frame);
+        return 0;
+    }
+
+    int STDCALL end_station_imp::send_register_unsolicited_cmd(void *notification_id)
+    {
+        return send_unsolicited_cmd_with_flag(notification_id, CMD_WITH_NOTIFICATION, JDKSAVDECC_AEM_COMMAND_REGISTER_UNSOLICITED_NOTIFICATION);
+    }
+
+    int STDCALL end_station_imp::send_deregister_unsolicited_cmd(void *notification_id)
+    {
+        return send_unsolicited_cmd_with_flag(notification_id, CMD_WITH_NOTIFICATION, JDKSAVDECC_AEM_COMMAND_DEREGISTER_UNSOLICITED_NOTIFICATION);
+    }
+
+    int end_station_imp::send_unsolicited_cmd_with_flag(void *notification_id, uint32_t notification_flag, uint16_t cmd_type)
+    {
+        struct jdksavdecc_frame cmd_frame;
+        struct jdksavdecc_aecpdu_aem aem_cmd_unsolicited;
+        memset(&aem_cmd_unsolicited, 0, sizeof(aem_cmd_unsolicited));
+
+        /***************************** AECP Common Data ****************************/
+        aem_cmd_unsolicited.aecpdu_header.controller_entity_id = adp_ref->get_controller_entity_id();
+        // Fill aem_cmd_unsolicited.sequence_id in AEM Controller State Machine
+        aem_cmd_unsolicited.command_type = cmd_type;
+
+        /************************** Fill frame payload with AECP data and send the frame *************************/
+        aecp_controller_state_machine_ref->ether_frame_init(end_station_mac, &cmd_frame, ETHER_HDR_SIZE + JDKSAVDECC_AECPDU_AEM_LEN);
+        ssize_t write_return_val = jdksavdecc_aecpdu_aem_write(&aem_cmd_unsolicited,
+                                                               cmd_frame.payload,
+                                                               ETHER_HDR_SIZE,
+                                                               sizeof(cmd_frame.payload));
+
+        if(write_return_val < 0)
+        {
+            log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "aem_cmd_unsolicited_write error");
+            return -1;
+        }
+
+        aecp_controller_state_machine_ref->common_hdr_init(JDKSAVDECC_AECP_MESSAGE_TYPE_AEM_COMMAND,
+                                                           &cmd_frame,
+                                                           end_station_entity_id,
+                                                           JDKSAVDECC_AECPDU_AEM_LEN -
+                                                           JDKSAVDECC_COMMON_CONTROL_HEADER_LEN);
+        system_queue_tx(notification_id, notification_flag, cmd_frame.payload, cmd_frame.length);
+        return 0;
+    }
+
+    void end_station_imp::register_unsolicited_when_enumerated()
+    {
+        if (!unsolicited_auto_register || m_unsolicited_registered || (m_unsolicited_attempts >= UNSOLICITED_REGISTER_MAX_ATTEMPTS))
+            return;
+
+        if ((entity_desc_vec.size() < 1) || (entity_desc_vec.at(current_entity_desc)->config_desc_count() < 1))
+            return;
+
+        if (!m_backbround_read_inflight.empty() || !m_backbround_read_pending.empty() || !m_backbround_read_backoff.empty())
+            return;
+
+        // The resend is cancelled by a successful or permanently failed response, a lost or transiently rejected registration is resent
+        if (send_unsolicited_cmd_with_flag(NULL, CMD_WITHOUT_NOTIFICATION, JDKSAVDECC_AEM_COMMAND_REGISTER_UNSOLICITED_NOTIFICATION) == 0)
+        {
+            timer_wheel_ref->schedule(&m_unsolicited_retry, UNSOLICITED_REGISTER_RETRY_MS << m_unsolicited_attempts, &unsolicited_retry_cb, this);
+            m_unsolicited_attempts++;
+        }
+    }
+
+    void end_station_imp::unsolicited_retry_cb(void *context)
+    {
+        end_station_imp *end_station = (end_station_imp *)context;
+
+        if (end_station->end_station_connection_status == 'C')
+            end_station->register_unsolicited_when_enumerated();
+    }
+
+    int end_station_imp::proc_unsolicited_cmd_resp(void *&notification_id, const uint8_t *frame, size_t frame_len, int &status)
+    {
+        struct jdksavdecc_frame cmd_frame;
+        bool u_field = jdksavdecc_aecpdu_aem_get_command_type(frame, ETHER_HDR_SIZE) >> 15 & 0x01; // u_field = the msb of the uint16_t command_type
+
+        status = jdksavdecc_common_control_header_get_status(frame, ETHER_HDR_SIZE);
+        memcpy(cmd_frame.payload, frame, frame_len);
+        aecp_controller_state_machine_ref->update_inflight_for_rcvd_resp(notification_id, JDKSAVDECC_AECP_MESSAGE_TYPE_AEM_RESPONSE, u_field, &cmd_frame);
+
+        uint16_t cmd_type = jdksavdecc_aecpdu_aem_get_command_type(frame, ETHER_HDR_SIZE) & 0x7FFF;
+        if (cmd_type == JDKSAVDECC_AEM_COMMAND_REGISTER_UNSOLICITED_NOTIFICATION)
+        {
+            switch (status)
+            {
+            case AEM_STATUS_SUCCESS:
+                m_unsolicited_registered = true;
+                m_unsolicited_retry.cancel();
+                break;
+
+            // The End Station is busy, the scheduled resend goes ahead
+            case AEM_STATUS_ENTITY_LOCKED:
+            case AEM_STATUS_ENTITY_ACQUIRED:
+            case AEM_STATUS_NO_RESOURCES:
+            case AEM_STATUS_IN_PROGRESS:
+                break;
+
+            // NOT_IMPLEMENTED, NOT_SUPPORTED, NO_SUCH_DESCRIPTOR and the like will not change, the End Station is not asked again
+            default:
+                m_unsolicited_attempts = UNSOLICITED_REGISTER_MAX_ATTEMPTS;
+                m_unsolicited_retry.cancel();
+                break;
+            }
+        }
+        else if ((cmd_type == JDKSAVDECC_AEM_COMMAND_DEREGISTER_UNSOLICITED_NOTIFICATION) && (status == AEM_STATUS_SUCCESS))
+        {
+            m_unsolicited_registered = false;
+            m_unsolicited_retry.cancel();
+        }
+
+        return 0;
+    }
+
+    int end_station_imp::proc_name_resp(void *&notification_id, const uint8_t *frame, size_t frame_len, int &status)
+    {
+        struct jdksavdecc_frame cmd_frame;
+        bool u_field = jdksavdecc_aecpdu_aem_get_command_type(frame, ETHER_HDR_SIZE) >> 15 & 0x01; // u_field = the msb of the uint16_t command_type
+
+        status = jdksavdecc_common_control_header_get_status(frame, ETHER_HDR_SIZE);
         memcpy(cmd_frame.payload, frame, frame_len);
-        aecp_controller_state_machine_ref->update_inflight_for_rcvd_resp(notification_id, JDKSAVDECC_AECP_MESSAGE_TYPE_AEM_RESPONSE, false, &cmd_frame);
+        aecp_controller_state_machine_ref->update_inflight_for_rcvd_resp(notification_id, JDKSAVDECC_AECP_MESSAGE_TYPE_AEM_RESPONSE, u_field, &cmd_frame);
+
+        if ((status != AEM_STATUS_SUCCESS) || (frame_len < ETHER_HDR_SIZE + JDKSAVDECC_AEM_COMMAND_SET_NAME_RESPONSE_LEN))
+            return 0;
+
+        // SET_NAME and GET_NAME responses have the same layout
+        uint16_t desc_type = jdksavdecc_aem_command_set_name_response_get_descriptor_type(frame, ETHER_HDR_SIZE);
+        uint16_t desc_index = jdksavdecc_aem_command_set_name_response_get_descriptor_index(frame, ETHER_HDR_SIZE);
+        uint16_t name_index = jdksavdecc_aem_command_set_name_response_get_name_index(frame, ETHER_HDR_SIZE);
+        uint16_t config_index = jdksavdecc_aem_command_set_name_response_get_configuration_index(frame, ETHER_HDR_SIZE);
+
+        if ((desc_type == JDKSAVDECC_DESCRIPTOR_ENTITY) || (desc_type == JDKSAVDECC_DESCRIPTOR_CONFIGURATION) ||
+            ((entity_desc_vec.size() > 0) && (config_index == entity_desc_vec.at(current_entity_desc)->current_configuration())))
+        {
+            update_name(desc_type, desc_index, name_index, frame + ETHER_HDR_SIZE + JDKSAVDECC_AEM_COMMAND_SET_NAME_RESPONSE_OFFSET_NAME);
+        }
+
         return 0;
     }
 
+    void end_station_imp::update_name(uint16_t desc_type, uint16_t desc_index, uint16_t name_index, const uint8_t *name)
+    {
+        uint8_t *stored_name = NULL;
+
+        if (entity_desc_vec.size() < 1)
+            return;
+
+        entity_descriptor_imp *entity_desc_imp_ref = entity_desc_vec.at(current_entity_desc);
+
+        if (desc_type == JDKSAVDECC_DESCRIPTOR_ENTITY)
+        {
+            if (name_index == 0)
+                stored_name = entity_desc_imp_ref->entity_name();
+            else if (name_index == 1)
+                stored_name = entity_desc_imp_ref->group_name();
+        }
+        else if (desc_type == JDKSAVDECC_DESCRIPTOR_CONFIGURATION)
+        {
+            if ((name_index == 0) && (desc_index < entity_desc_imp_ref->config_desc_count()))
+                stored_name = entity_desc_imp_ref->get_config_desc_by_index(desc_index)->object_name();
+        }
+        else if ((name_index == 0) && (entity_desc_imp_ref->config_desc_count() > current_config_desc))
+        {
+            configuration_descriptor_imp *config_desc_imp_ref =
+                entity_desc_imp_ref->get_config_desc_imp_by_index(current_config_desc);
+            descriptor_base_imp *desc = config_desc_imp_ref ? config_desc_imp_ref->lookup_desc(desc_type, desc_index) : NULL;
+
+            if (desc)
+                stored_name = desc->object_name();
+        }
+
+        if (stored_name)
+        {
+            memcpy(stored_name, name, sizeof(struct jdksavdecc_string));
+        }
+        else
+        {
+            log_imp_ref->post_log_msg(LOGGING_LEVEL_DEBUG, "No stored name %d for %s %d", name_index, utility::aem_desc_value_to_name(desc_type), desc_index);
+        }
+    }
+
+    void end_station_imp::set_unsolicited_auto_register(bool enable)
+    {
+        unsolicited_auto_register = enable;
+    }
+
     int end_station_imp::proc_rcvd_aecp_aa_resp(void *&notification_id, const uint8_t *frame, size_t frame_len, int &status)
     {
         struct jdksavdecc_frame cmd_frame;
@@ -1432,6 +1980,10 @@ namespace avdecc_lib
     int end_station_imp::proc_rcvd_acmp_resp(uint32_t msg_type, void *&notification_id, const uint8_t *frame, size_t frame_len, int &status)
     {
         uint16_t desc_index = 0;
+        configuration_descriptor_imp *config_desc_imp_ref = current_config_desc_imp();
+
+        if(!config_desc_imp_ref)
+            return proc_resp_without_config_desc(status);
 
         switch(msg_type)
         {
@@ -1439,7 +1991,7 @@ namespace avdecc_lib
                 {
                     desc_index = jdksavdecc_acmpdu_get_talker_unique_id(frame, ETHER_HDR_SIZE);
                     stream_output_descriptor_imp *stream_output_desc_imp_ref;
-                    stream_output_desc_imp_ref = dynamic_cast<stream_output_descriptor_imp *>(entity_desc_vec.at(current_entity_desc)->get_config_desc_by_index(current_config_desc)->get_stream_output_desc_by_index(desc_index));
+                    stream_output_desc_imp_ref = config_desc_imp_ref->get_stream_output_desc_imp_by_index(desc_index);
 
                     if(stream_output_desc_imp_ref)
                     {
@@ -1447,7 +1999,7 @@ namespace avdecc_lib
                     }
                     else
                     {
-                        log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "Dynamic cast from derived stream_input_descriptor_imp to base stream_input_descriptor error");
+                        log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "stream_input_descriptor lookup error");
                     }
                 }
 
@@ -1457,7 +2009,7 @@ namespace avdecc_lib
                 {
                     desc_index = jdksavdecc_acmpdu_get_listener_unique_id(frame, ETHER_HDR_SIZE);
                     stream_input_descriptor_imp *stream_input_desc_imp_ref;
-                    stream_input_desc_imp_ref = dynamic_cast<stream_input_descriptor_imp *>(entity_desc_vec.at(current_entity_desc)->get_config_desc_by_index(current_config_desc)->get_stream_input_desc_by_index(desc_index));
+                    stream_input_desc_imp_ref = config_desc_imp_ref->get_stream_input_desc_imp_by_index(desc_index);
 
                     if(stream_input_desc_imp_ref)
                     {
@@ -1465,7 +2017,7 @@ namespace avdecc_lib
                     }
                     else
                     {
-                        log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "Dynamic cast from derived stream_input_descriptor_imp to base stream_input_descriptor error");
+                        log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "stream_input_descriptor lookup error");
                     }
                 }
 
@@ -1475,7 +2027,7 @@ namespace avdecc_lib
                 {
                     desc_index = jdksavdecc_acmpdu_get_listener_unique_id(frame, ETHER_HDR_SIZE);
                     stream_input_descriptor_imp *stream_input_desc_imp_ref;
-                    stream_input_desc_imp_ref = dynamic_cast<stream_input_descriptor_imp *>(entity_desc_vec.at(current_entity_desc)->get_config_desc_by_index(current_config_desc)->get_stream_input_desc_by_index(desc_index));
+                    stream_input_desc_imp_ref = config_desc_imp_ref->get_stream_input_desc_imp_by_index(desc_index);
 
                     if(stream_input_desc_imp_ref)
                     {
@@ -1483,7 +2035,7 @@ namespace avdecc_lib
                     }
                     else
                     {
-                        log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "Dynamic cast from derived stream_input_descriptor_imp to base stream_input_descriptor error");
+                        log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "stream_input_descriptor lookup error");
                     }
                 }
 
@@ -1493,7 +2045,7 @@ namespace avdecc_lib
                 {
                     desc_index = jdksavdecc_acmpdu_get_listener_unique_id(frame, ETHER_HDR_SIZE);
                     stream_input_descriptor_imp *stream_input_desc_imp_ref;
-                    stream_input_desc_imp_ref = dynamic_cast<stream_input_descriptor_imp *>(entity_desc_vec.at(current_entity_desc)->get_config_desc_by_index(current_config_desc)->get_stream_input_desc_by_index(desc_index));
+                    stream_input_desc_imp_ref = config_desc_imp_ref->get_stream_input_desc_imp_by_index(desc_index);
 
                     if(stream_input_desc_imp_ref)
                     {
@@ -1501,7 +2053,7 @@ namespace avdecc_lib
                     }
                     else
                     {
-                        log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "Dynamic cast from derived stream_input_descriptor_imp to base stream_input_descriptor error");
+                        log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "stream_input_descriptor lookup error");
                     }
                 }
 
@@ -1511,7 +2063,7 @@ namespace avdecc_lib
                 {
                     desc_index = jdksavdecc_acmpdu_get_talker_unique_id(frame, ETHER_HDR_SIZE);
                     stream_output_descriptor_imp *stream_output_desc_imp_ref;
-                    stream_output_desc_imp_ref = dynamic_cast<stream_output_descriptor_imp *>(entity_desc_vec.at(current_entity_desc)->get_config_desc_by_index(current_config_desc)->get_stream_output_desc_by_index(desc_index));
+                    stream_output_desc_imp_ref = config_desc_imp_ref->get_stream_output_desc_imp_by_index(desc_index);
 
                     if(stream_output_desc_imp_ref)
                     {
@@ -1519,7 +2071,7 @@ namespace avdecc_lib
                     }
                     else
                     {
-                        log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "Dynamic cast from derived stream_input_descriptor_imp to base stream_input_descriptor error");
+                        log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "stream_input_descriptor lookup error");
                     }
                 }
 
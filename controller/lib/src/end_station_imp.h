@@ -29,30 +29,37 @@
 
 #pragma once
 #include <list>
+#include <memory>
+#include <atomic>
 
 #include "entity_descriptor_imp.h"
 #include "end_station.h"
-#include "timer.h"
+#include "timer_wheel.h"
+#include "object_arena.h"
 
 namespace avdecc_lib
 {
     class adp;
+    class end_station_imp;
+    class descriptor_model;
 
 	class background_read_request
 	{
 	public:
-		background_read_request(uint16_t t, uint16_t I) :
-            m_type(t), m_index(I) {};
+		background_read_request(end_station_imp *end_station, uint16_t t, uint16_t I) :
+            m_end_station(end_station), m_type(t), m_index(I), m_retries(0) {};
+        end_station_imp *m_end_station;
 		uint16_t m_type;
 		uint16_t m_index;
-        timer m_timer;
+        uint16_t m_retries; // Number of times the read has been resent
+        timer_wheel_entry m_timer; // Response timeout while inflight, retry delay while backing off
 	};
 
     class end_station_imp : public virtual end_station
     {
     private:
         uint64_t end_station_entity_id; // The unique identifier of the AVDECC Entity the command is targeted to
-        uint64_t end_station_mac; // The source MAC address of the End Station
+        std::atomic<uint64_t> end_station_mac; // The source MAC address of the End Station, updated by the engine while commands are built
         char end_station_connection_status; // The connection status of an End Station
         uint16_t current_entity_desc; // The ENTITY descriptor associated with the End Station
         uint16_t current_config_desc; // The CONFIGURATION descriptor associated with the ENTITY descriptor in the same End Station
@@ -62,16 +69,60 @@ namespace avdecc_lib
 
 		std::list<background_read_request *> m_backbround_read_pending; // Store a list of background reads
         std::list<background_read_request *> m_backbround_read_inflight; // Store a list of background reads that are inflight
+        std::list<background_read_request *> m_backbround_read_backoff; // Store a list of background reads waiting to be resent
+        std::vector<background_read_request *> m_background_read_free; // Finished background reads, reused for later reads
+        uint16_t m_background_read_window; // Current limit on inflight background reads, shrinks on timeouts
+        bool m_background_read_waiting; // Waiting for a slot in the global background read limit
+
+        static uint16_t background_read_end_station_limit; // Maximum inflight background reads per End Station
+        static uint16_t background_read_total_limit; // Maximum inflight background reads across the End Stations of an engine shard
+        static thread_local uint32_t background_read_total_inflight; // Inflight background reads across the End Stations of the engine shard
+        static thread_local std::list<end_station_imp *> background_read_waiting_list; // End Stations of the engine shard waiting for a global slot
+
+        bool m_unsolicited_registered; // The End Station has accepted REGISTER_UNSOLICITED_NOTIFICATION since it was enumerated
+        uint8_t m_unsolicited_attempts; // Automatic REGISTER_UNSOLICITED_NOTIFICATION commands sent since the End Station was enumerated
+        timer_wheel_entry m_unsolicited_retry; // Resend of an unanswered or transiently rejected automatic REGISTER_UNSOLICITED_NOTIFICATION
+        static std::atomic<bool> unsolicited_auto_register; // Register End Stations for unsolicited notifications once enumerated
 
         adp *adp_ref; // ADP associated with the End Station
+        std::shared_ptr<descriptor_model> m_descriptor_model; // Static descriptors shared with End Stations of the same entity model
         std::vector<entity_descriptor_imp *> entity_desc_vec; // Store a list of ENTITY descriptor objects
+        object_arena m_arena; // Owns the descriptor tree, raw descriptor payloads and background read requests
 
         void queue_background_read_request(uint16_t desc_type, uint16_t desc_base_index, uint16_t count);  ///< Generate "count" read requests
         void background_read_deduce_next(configuration_descriptor *cd, uint16_t desc_type, void *frame, ssize_t pos); ///< Deduce what else needs to be read from the rx'd frame
-        void background_read_update_inflight(uint16_t desc_type, void *frame, ssize_t read_desc_offset); ///< Remove rx'd frame from background read inflight list
+        void background_read_update_inflight(uint16_t desc_type, void *frame, ssize_t read_desc_offset, int status); ///< Remove rx'd frame from background read inflight list
+        void background_read_retry(background_read_request *b); ///< Shrink the window and resend after a backoff delay
+        bool background_read_from_cache(background_read_request *b); ///< Store a static descriptor from the shared model or descriptor cache instead of reading it
+        bool is_shared_desc_type(uint16_t desc_type); ///< The descriptor type is shared with End Stations of the same, non-zero, entity model ID
+        void background_read_flush(); ///< Drop all pending, inflight and backing off background reads
+        background_read_request *background_read_alloc(uint16_t desc_type, uint16_t desc_index); ///< Reuse a finished background read or create one in the arena
+        void background_read_release(background_read_request *b); ///< Return a finished background read for reuse
+        static void background_read_wake_waiting(); ///< Submit reads for End Stations waiting on the global limit
 
         bool desc_index_from_frame(uint16_t desc_type, void *frame, ssize_t read_desc_offset, uint16_t &desc_index);
 
+        /**
+         * Send a REGISTER_UNSOLICITED_NOTIFICATION or DEREGISTER_UNSOLICITED_NOTIFICATION command.
+         */
+        int send_unsolicited_cmd_with_flag(void *notification_id, uint32_t notification_flag, uint16_t cmd_type);
+
+        /**
+         * Register for unsolicited notifications once the descriptors have been read, if not already registered.
+         */
+        void register_unsolicited_when_enumerated();
+        static void unsolicited_retry_cb(void *context); ///< Timer wheel handler for registrations without a successful response
+
+        /**
+         * Apply the name of a SET_NAME or GET_NAME response to the descriptor it names.
+         */
+        void update_name(uint16_t desc_type, uint16_t desc_index, uint16_t name_index, const uint8_t *name);
+
+        /**
+         * Store a descriptor from a READ_DESCRIPTOR response and queue the reads it implies.
+         */
+        void store_desc(uint16_t desc_type, const uint8_t *frame, ssize_t read_desc_offset, size_t frame_len);
+
     public:
         end_station_imp(const uint8_t *frame, size_t frame_len);
         virtual ~end_station_imp();
@@ -79,12 +130,13 @@ namespace avdecc_lib
         const char STDCALL get_connection_status() const;
 
         /**
-         * Change the End Station connection status to connected.
+         * Change the End Station connection status to connected. An End Station coming back after
+         * departing is enumerated again.
          */
         void set_connected();
 
         /**
-         * Change the End Station connection status to disconnected.
+         * Change the End Station connection status to disconnected, and free its descriptors.
          */
         void set_disconnected();
 
@@ -95,7 +147,30 @@ namespace avdecc_lib
 
         uint64_t STDCALL entity_id();
         uint64_t STDCALL mac();
+
+        /**
+         * Send commands to a new MAC address, after the End Station has moved to another network interface.
+         */
+        void set_end_station_mac(uint64_t mac);
+
         adp * get_adp();
+
+        /**
+         * \return The arena holding the descriptor objects and raw descriptor payloads of the End Station.
+         *         Everything in it stays in place until the End Station is re-enumerated, departs or is deleted.
+         */
+        object_arena &arena()
+        {
+            return m_arena;
+        }
+
+        /**
+         * Keep a raw descriptor payload for a descriptor object of the End Station.
+         *
+         * \return The shared model's copy if it holds the same payload, otherwise a copy in the arena.
+         */
+        const uint8_t *store_payload(const uint8_t *desc, size_t desc_len);
+
         size_t STDCALL entity_desc_count();
         entity_descriptor * STDCALL get_entity_desc_by_index(size_t entity_desc_index);
         int STDCALL send_read_desc_cmd(void *notification_id, uint16_t desc_type, uint16_t desc_index);
@@ -109,11 +184,35 @@ namespace avdecc_lib
                                         unsigned length,
                                         uint64_t address,
                                         uint8_t memory_data[]);
+
+        /**
+         * Build an AECP Address Access command frame with a single TLV carrying length bytes of memory_data.
+         * If memory_data is NULL the data bytes are left for the caller to fill in. A READ carries no data.
+         */
+        int aecp_aa_frame_init(struct jdksavdecc_frame *cmd_frame, unsigned mode, unsigned length, uint64_t address, const uint8_t *memory_data);
+
         int STDCALL send_identify(void *notification_id, bool turn_on);
         int proc_set_control_resp(void *&notification_id, const uint8_t *frame, size_t frame_len, int &status);
+        int STDCALL send_register_unsolicited_cmd(void *notification_id);
+        int STDCALL send_deregister_unsolicited_cmd(void *notification_id);
+        int proc_unsolicited_cmd_resp(void *&notification_id, const uint8_t *frame, size_t frame_len, int &status);
+        int proc_name_resp(void *&notification_id, const uint8_t *frame, size_t frame_len, int &status);
+
+        /**
+         * Set whether End Stations are registered for unsolicited notifications once enumerated.
+         */
+        static void set_unsolicited_auto_register(bool enable);
+
+        void background_read_timeout(background_read_request *b); ///< Retry a background read that has timed out
+        void background_read_backoff_expired(background_read_request *b); ///< Requeue a background read after its backoff delay
+        void background_read_submit_pending(void); ///< Submit pending background reads up to the window, and notify once none are left
+        static void background_read_timeout_cb(void *context); ///< Timer wheel handler for background read timeouts
+        static void background_read_backoff_cb(void *context); ///< Timer wheel handler for background read retries
 
-        void background_read_update_timeouts(void); ///< update timeout conditions
-        void background_read_submit_pending(void); ///< Submit pending background reads
+        /**
+         * Set the number of background READ_DESCRIPTOR commands that may be inflight per End Station and in total.
+         */
+        static void set_background_read_limits(uint16_t end_station_limit, uint16_t total_limit);
 
         /**
          * Process response received for the corresponding AECP Address Access command.
@@ -127,12 +226,35 @@ namespace avdecc_lib
         void STDCALL set_current_config_index(uint16_t entity_index);
         uint16_t STDCALL get_current_config_index() const;
 
+        /**
+         * \return The configuration index a READ_DESCRIPTOR command for the descriptor type is sent with.
+         */
+        uint16_t read_desc_config_index(uint16_t desc_type);
+
     private:
         /**
          * Initialize End Station with Entity and Configuration descriptors information.
          */
         int end_station_init();
 
+        /**
+         * Drop the background reads and free the descriptor tree.
+         */
+        void end_station_release();
+
+        /**
+         * \return The CONFIGURATION descriptor currently in use by the End Station, or NULL if it has not been read.
+         */
+        configuration_descriptor_imp *current_config_desc_imp();
+
+        /**
+         * Drop a response for a descriptor of the current configuration that arrived before the
+         * CONFIGURATION descriptor was read.
+         *
+         * \return -1, with status set to AVDECC_LIB_STATUS_INVALID.
+         */
+        int proc_resp_without_config_desc(int &status);
+
         /**
          * Initialize End Station by sending non blocking Read Descriptor commands to read
          * all the descriptors for the End Station.
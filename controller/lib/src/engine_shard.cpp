@@ -0,0 +1,191 @@
+/*
+ * Licensed under the MIT License (MIT)
+ *
+ * Copyright (c) 2014 AudioScience Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * engine_shard.cpp
+ *
+ * Engine shard implementation
+ */
+
+#include <string.h>
+#include "jdksavdecc.h"
+#include "enumeration.h"
+#include "end_station_imp.h"
+#include "adp_discovery_state_machine.h"
+#include "acmp_controller_state_machine.h"
+#include "aecp_controller_state_machine.h"
+#include "timer_wheel.h"
+#include "engine_shard.h"
+
+namespace avdecc_lib
+{
+    static engine_shard *primary_engine_shard = new engine_shard(true);
+
+    thread_local engine_shard *engine_shard_ref = primary_engine_shard;
+    thread_local adp_discovery_state_machine *adp_discovery_state_machine_ref = primary_engine_shard->adp_discovery;
+    thread_local acmp_controller_state_machine *acmp_controller_state_machine_ref = primary_engine_shard->acmp_controller;
+    thread_local aecp_controller_state_machine *aecp_controller_state_machine_ref = primary_engine_shard->aecp_controller;
+    thread_local timer_wheel *timer_wheel_ref = primary_engine_shard->timers;
+
+    engine_shard::engine_shard(bool is_primary)
+    {
+        timers = new timer_wheel();
+        adp_discovery = new adp_discovery_state_machine(is_primary);
+        acmp_controller = new acmp_controller_state_machine();
+        aecp_controller = new aecp_controller_state_machine();
+    }
+
+    engine_shard::~engine_shard()
+    {
+        // Inflight commands and entity records cancel their timers as they are freed
+        delete aecp_controller;
+        delete acmp_controller;
+        delete adp_discovery;
+        delete timers;
+    }
+
+    engine_shard * engine_shard::primary()
+    {
+        return primary_engine_shard;
+    }
+
+    void engine_shard::make_current()
+    {
+        engine_shard_ref = this;
+        adp_discovery_state_machine_ref = adp_discovery;
+        acmp_controller_state_machine_ref = acmp_controller;
+        aecp_controller_state_machine_ref = aecp_controller;
+        timer_wheel_ref = timers;
+    }
+
+    size_t engine_shard::index_of(uint64_t entity_id, size_t shard_count)
+    {
+        // Entity IDs of one vendor often only differ in their low bits, so mix them all in
+        uint64_t h = entity_id;
+        h ^= h >> 33;
+        h *= UINT64_C(0xff51afd7ed558ccd);
+        h ^= h >> 33;
+
+        return (shard_count > 1) ? (size_t)(h % shard_count) : 0;
+    }
+
+    uint64_t engine_shard::frame_entity_id(const uint8_t *frame, size_t frame_len)
+    {
+        struct jdksavdecc_eui64 entity_id;
+
+        if (frame_len < ETHER_HDR_SIZE + JDKSAVDECC_COMMON_CONTROL_HEADER_LEN)
+            return 0;
+
+        switch (jdksavdecc_common_control_header_get_subtype(frame, ETHER_HDR_SIZE))
+        {
+            case JDKSAVDECC_SUBTYPE_ADP:
+            case JDKSAVDECC_SUBTYPE_AECP:
+                // The ADP entity_id and the AECP target_entity_id are both in the stream_id field
+                entity_id = jdksavdecc_common_control_header_get_stream_id(frame, ETHER_HDR_SIZE);
+                break;
+
+            case JDKSAVDECC_SUBTYPE_ACMP:
+            {
+                if (frame_len < ETHER_HDR_SIZE + JDKSAVDECC_ACMPDU_LEN)
+                    return 0;
+
+                switch (jdksavdecc_common_control_header_get_control_data(frame, ETHER_HDR_SIZE))
+                {
+                    case JDKSAVDECC_ACMP_MESSAGE_TYPE_CONNECT_TX_COMMAND:
+                    case JDKSAVDECC_ACMP_MESSAGE_TYPE_CONNECT_TX_RESPONSE:
+                    case JDKSAVDECC_ACMP_MESSAGE_TYPE_DISCONNECT_TX_COMMAND:
+                    case JDKSAVDECC_ACMP_MESSAGE_TYPE_DISCONNECT_TX_RESPONSE:
+                    case JDKSAVDECC_ACMP_MESSAGE_TYPE_GET_TX_STATE_COMMAND:
+                    case JDKSAVDECC_ACMP_MESSAGE_TYPE_GET_TX_STATE_RESPONSE:
+                    case JDKSAVDECC_ACMP_MESSAGE_TYPE_GET_TX_CONNECTION_COMMAND:
+                    case JDKSAVDECC_ACMP_MESSAGE_TYPE_GET_TX_CONNECTION_RESPONSE:
+                        entity_id = jdksavdecc_acmpdu_get_talker_entity_id(frame, ETHER_HDR_SIZE);
+                        break;
+
+                    default:
+                        entity_id = jdksavdecc_acmpdu_get_listener_entity_id(frame, ETHER_HDR_SIZE);
+                        break;
+                }
+                break;
+            }
+
+            default:
+                return 0;
+        }
+
+        return jdksavdecc_eui64_convert_to_uint64(&entity_id);
+    }
+
+    size_t engine_shard::tx_index_of(uint32_t notification_flag, const uint8_t *frame, size_t frame_len, size_t shard_count)
+    {
+        if (shard_count <= 1)
+            return 0;
+
+        if (notification_flag == CMD_BATCH_WITH_NOTIFICATION)
+        {
+            // Batches are split with split_batch first, so every command is for the same shard
+            struct bulk_cmd_batch *batch;
+            memcpy(&batch, frame, sizeof(batch));
+            return batch->frames.empty() ? 0 : index_of(batch->frames[0].entity_id, shard_count);
+        }
+        else if (notification_flag == CMD_TRANSFER_WITH_NOTIFICATION)
+        {
+            struct memory_transfer *transfer;
+            memcpy(&transfer, frame, sizeof(transfer));
+            return index_of(transfer->end_station->entity_id(), shard_count);
+        }
+
+        return index_of(frame_entity_id(frame, frame_len), shard_count);
+    }
+
+    size_t engine_shard::split_batch(struct bulk_cmd_batch *batch, size_t shard_count, std::vector<struct bulk_cmd_batch *> &batches)
+    {
+        size_t batch_count = 0;
+
+        batches.assign(shard_count, NULL);
+
+        for (size_t i = 0; i < batch->frames.size(); i++)
+        {
+            size_t index = index_of(batch->frames[i].entity_id, shard_count);
+
+            if (!batches[index])
+            {
+                batches[index] = new bulk_cmd_batch();
+                batches[index]->notification_id = batch->notification_id;
+                batches[index]->entity_limit = batch->entity_limit;
+                batch_count++;
+            }
+
+            batches[index]->frames.push_back(batch->frames[i]);
+        }
+
+        for (size_t i = 0; i < shard_count; i++)
+        {
+            if (batches[i])
+                batches[i]->unsent = batches[i]->frames.size();
+        }
+
+        delete batch;
+        return batch_count;
+    }
+}
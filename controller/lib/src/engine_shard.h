@@ -0,0 +1,111 @@
+/*
+ * Licensed under the MIT License (MIT)
+ *
+ * Copyright (c) 2014 AudioScience Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * engine_shard.h
+ *
+ * The protocol state of one engine thread.
+ *
+ * End Stations are partitioned by Entity ID across one or more engine shards, each run by its own
+ * thread. A shard owns the ADP, ACMP and AECP state machines, the timer wheel and the bulk command
+ * and memory transfer queues of its End Stations. The engine code reaches them through the thread
+ * local references (aecp_controller_state_machine_ref, timer_wheel_ref and so on), which point at
+ * the primary shard on every thread that has not made another shard current. Background read
+ * accounting is kept per thread by end_station_imp, which is the same as per shard.
+ *
+ * A shard is not freed once its thread has run, End Stations keep timers in the timer wheel of
+ * their shard until they are destroyed.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+#include "bulk_cmd_queue.h"
+#include "memory_transfer_queue.h"
+
+namespace avdecc_lib
+{
+    class adp_discovery_state_machine;
+    class acmp_controller_state_machine;
+    class aecp_controller_state_machine;
+    class timer_wheel;
+
+    class engine_shard
+    {
+    public:
+        /**
+         * \param is_primary Only the primary shard sends the ENTITY_DISCOVER that starts discovery,
+         *                   the ENTITY_AVAILABLE responses are steered to the other shards.
+         */
+        engine_shard(bool is_primary);
+
+        ~engine_shard();
+
+        /**
+         * \return The shard of every thread that has not made another one current.
+         */
+        static engine_shard * primary();
+
+        /**
+         * Use this shard for the protocol state of the calling thread.
+         */
+        void make_current();
+
+        adp_discovery_state_machine *adp_discovery;
+        acmp_controller_state_machine *acmp_controller;
+        aecp_controller_state_machine *aecp_controller;
+        timer_wheel *timers;
+        bulk_cmd_queue bulk_cmds; // Commands of send_bulk_cmds batches waiting for a free End Station slot
+        memory_transfer_queue transfers; // Memory object uploads and downloads in progress
+
+        /**
+         * \return The index of the shard owning the End Station with the Entity ID.
+         */
+        static size_t index_of(uint64_t entity_id, size_t shard_count);
+
+        /**
+         * \return The Entity ID of the End Station a received or transmitted ADP, AECP or ACMP frame is
+         *         about, 0 if there is none. ACMP frames of the talker side of a connection are owned by
+         *         the talker, the others by the listener.
+         */
+        static uint64_t frame_entity_id(const uint8_t *frame, size_t frame_len);
+
+        /**
+         * \return The index of the shard a frame queued with system_queue_tx is sent from.
+         */
+        static size_t tx_index_of(uint32_t notification_flag, const uint8_t *frame, size_t frame_len, size_t shard_count);
+
+        /**
+         * Split a send_bulk_cmds batch into one batch per shard with commands for it. Every batch keeps
+         * the notification id and End Station limit of the original, which is deleted.
+         *
+         * \param batches Resized to shard_count, with NULL for shards without commands.
+         * \return The number of batches.
+         */
+        static size_t split_batch(struct bulk_cmd_batch *batch, size_t shard_count, std::vector<struct bulk_cmd_batch *> &batches);
+    };
+
+    extern thread_local engine_shard *engine_shard_ref;
+}
@@ -46,13 +46,7 @@ namespace avdecc_lib
         }
     }
 
-    entity_descriptor_imp::~entity_descriptor_imp()
-    {
-        for(uint32_t config_vec_index = 0; config_vec_index < config_desc_vec.size(); config_vec_index++)
-        {
-            delete config_desc_vec.at(config_vec_index);
-        }
-    }
+    entity_descriptor_imp::~entity_descriptor_imp() {}
 
     uint16_t STDCALL entity_descriptor_imp::descriptor_type() const
     {
@@ -164,7 +158,7 @@ namespace avdecc_lib
 
     void entity_descriptor_imp::store_config_desc(end_station_imp *end_station_obj, const uint8_t *frame, ssize_t pos, size_t frame_len)
     {
-        config_desc_vec.push_back(new configuration_descriptor_imp(end_station_obj, frame, pos, frame_len));
+        config_desc_vec.push_back(end_station_obj->arena().create<configuration_descriptor_imp>(end_station_obj, frame, pos, frame_len));
     }
 
     size_t STDCALL entity_descriptor_imp::config_desc_count()
@@ -173,6 +167,11 @@ namespace avdecc_lib
     }
 
     configuration_descriptor * STDCALL entity_descriptor_imp::get_config_desc_by_index(uint16_t config_desc_index)
+    {
+        return get_config_desc_imp_by_index(config_desc_index);
+    }
+
+    configuration_descriptor_imp * entity_descriptor_imp::get_config_desc_imp_by_index(uint16_t config_desc_index)
     {
         bool is_valid = (config_desc_index < config_desc_vec.size());
 
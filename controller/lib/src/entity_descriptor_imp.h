@@ -74,6 +74,12 @@ namespace avdecc_lib
         void store_config_desc(end_station_imp *end_station_obj, const uint8_t *frame, ssize_t pos, size_t frame_len);
         size_t STDCALL config_desc_count();
         configuration_descriptor * STDCALL get_config_desc_by_index(uint16_t config_desc_index);
+
+        /**
+         * \return The CONFIGURATION descriptor implementation object at the index, or NULL if there is none.
+         */
+        configuration_descriptor_imp *get_config_desc_imp_by_index(uint16_t config_desc_index);
+
         uint32_t STDCALL acquire_entity_flags();
         uint64_t STDCALL acquire_entity_owner_entity_id();
         uint32_t STDCALL lock_entity_flags();
@@ -27,6 +27,7 @@
  * EXTERNAL_PORT_INPUT descriptor implementation
  */
 
+#include <stddef.h>
 #include "avdecc_error.h"
 #include "enumeration.h"
 #include "log_imp.h"
@@ -36,6 +37,32 @@
 
 namespace avdecc_lib
 {
+    static descriptor_field_flags_imp external_port_input_port_flags[] =
+    {
+        descriptor_field_flags_imp("CLOCK_SYNC_SOURCE", 1 << 15),
+        descriptor_field_flags_imp("ASYNC_SAMPLE_RATE_CONVERTER", 1 << 14),
+        descriptor_field_flags_imp("SYNC_SAMPLE_RATE_CONVERTER", 1 << 13)
+    };
+
+#define EXTERNAL_PORT_FIELD(name, type) \
+    { #name, descriptor_field::type, offsetof(struct jdksavdecc_descriptor_external_port, name), NULL, 0 }
+
+    static const descriptor_field_info external_port_input_fields[] =
+    {
+        EXTERNAL_PORT_FIELD(clock_domain_index, TYPE_UINT16),
+        {
+            "port_flags", descriptor_field::TYPE_FLAGS16, offsetof(struct jdksavdecc_descriptor_external_port, port_flags),
+            external_port_input_port_flags, sizeof(external_port_input_port_flags) / sizeof(external_port_input_port_flags[0])
+        },
+        EXTERNAL_PORT_FIELD(number_of_controls, TYPE_UINT16),
+        EXTERNAL_PORT_FIELD(base_control, TYPE_UINT16),
+        EXTERNAL_PORT_FIELD(signal_type, TYPE_UINT16),
+        EXTERNAL_PORT_FIELD(signal_index, TYPE_UINT16),
+        EXTERNAL_PORT_FIELD(signal_output, TYPE_UINT16),
+        EXTERNAL_PORT_FIELD(block_latency, TYPE_UINT32),
+        EXTERNAL_PORT_FIELD(jack_index, TYPE_UINT16)
+    };
+
     external_port_input_descriptor_imp::external_port_input_descriptor_imp(end_station_imp *end_station_obj, const uint8_t *frame, ssize_t pos, size_t frame_len) : descriptor_base_imp(end_station_obj)
     {
         ssize_t ret = jdksavdecc_descriptor_external_port_read(&desc, frame, pos, frame_len);
@@ -45,27 +72,8 @@ namespace avdecc_lib
             throw avdecc_read_descriptor_error("jdksavdecc_descriptor_external_port_read error");
         }
 
-		// fields
-		descriptor_field_imp *f;
-
-		m_fields.push_back(new descriptor_field_imp("clock_domain_index", descriptor_field::TYPE_UINT16, &desc.clock_domain_index));
-
-		f = new descriptor_field_imp("port_flags", descriptor_field::TYPE_FLAGS16, &desc.port_flags);
-		f->append_field(new descriptor_field_flags_imp("CLOCK_SYNC_SOURCE", 1 << 15));
-		f->append_field(new descriptor_field_flags_imp("ASYNC_SAMPLE_RATE_CONVERTER", 1 << 14));
-		f->append_field(new descriptor_field_flags_imp("SYNC_SAMPLE_RATE_CONVERTER", 1 << 13));
-		m_fields.push_back(f);
-
-		m_fields.push_back(new descriptor_field_imp("number_of_controls", descriptor_field::TYPE_UINT16, &desc.number_of_controls));
-		m_fields.push_back(new descriptor_field_imp("base_control", descriptor_field::TYPE_UINT16, &desc.base_control));
-
-		m_fields.push_back(new descriptor_field_imp("signal_type", descriptor_field::TYPE_UINT16, &desc.signal_type));
-		m_fields.push_back(new descriptor_field_imp("signal_index", descriptor_field::TYPE_UINT16, &desc.signal_index));
-		m_fields.push_back(new descriptor_field_imp("signal_output", descriptor_field::TYPE_UINT16, &desc.signal_output));
-
-		m_fields.push_back(new descriptor_field_imp("block_latency", descriptor_field::TYPE_UINT16, &desc.block_latency));
-		m_fields.push_back(new descriptor_field_imp("jack_index", descriptor_field::TYPE_UINT16, &desc.jack_index));
- }
+        set_field_table(external_port_input_fields, &desc);
+    }
 
     external_port_input_descriptor_imp::~external_port_input_descriptor_imp() {}
 
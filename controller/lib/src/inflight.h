@@ -29,18 +29,22 @@
 
 #pragma once
 
-#include "timer.h"
+#include "timer_wheel.h"
 
 namespace avdecc_lib
 {
     class inflight
     {
     private:
+        friend class inflight_table;
+
         struct jdksavdecc_frame cmd_frame;
         uint32_t cmd_notification_flag;
-        timer cmd_timer;
+        timer_wheel_entry cmd_timer;
         uint32_t cmd_timeout_ms;
         uint32_t start_timer_cnt;
+        inflight *table_prev; // Neighbours in the inflight_table, in insertion order
+        inflight *table_next;
 
     public:
         /* following 2 are public for compare prediate classes */
@@ -56,14 +60,25 @@ namespace avdecc_lib
         {
             cmd_frame = *frame;
             start_timer_cnt = 0;
+            table_prev = NULL;
+            table_next = NULL;
         }
 
         ~inflight() {}
 
-        inline void start_timer()
+        /**
+         * Start or restart the command timeout. The handler is called with this inflight command
+         * from the engine thread when the timeout expires.
+         */
+        inline void start_timer(timer_wheel_entry::handler_fn timeout_handler)
         {
             start_timer_cnt++;
-            cmd_timer.start(cmd_timeout_ms);
+            timer_wheel_ref->schedule(&cmd_timer, cmd_timeout_ms, timeout_handler, this);
+        }
+
+        inline void stop_timer()
+        {
+            cmd_timer.cancel();
         }
 
         inline struct jdksavdecc_frame frame()
@@ -76,49 +91,9 @@ namespace avdecc_lib
             return cmd_notification_flag;
         }
 
-        inline bool timeout()
-        {
-            return cmd_timer.timeout();
-        }
-
         inline bool retried()
         {
             return start_timer_cnt >= 2; // The command can be resent once
         }
     };
-
-    /*
-     * Class for use in STL find_if() call to find matching sequence ID.
-     */
-    class SeqIdComp
-    {
-    private:
-        uint16_t v;
-
-    public:
-        SeqIdComp(uint16_t i) : v(i) { }
-
-        inline bool operator()(const inflight & m) const
-        {
-            return m.cmd_seq_id == v;
-        }
-    };
-
-    /*
-     * Class for use in STL find_if() call to find matching notification ID.
-     */
-    class NotificationComp
-    {
-    private:
-        void * v;
-
-    public:
-        NotificationComp(void * p) : v(p) { }
-
-        inline bool operator()(const inflight & m) const
-        {
-            return m.cmd_notification_id == v;
-        }
-    };
 }
-
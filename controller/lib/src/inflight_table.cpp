@@ -0,0 +1,113 @@
+/*
+ * Licensed under the MIT License (MIT)
+ *
+ * Copyright (c) 2014 AudioScience Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * inflight_table.cpp
+ *
+ * Inflight command table implementation
+ */
+
+#include "avdecc_lib_os.h"
+#include "enumeration.h"
+#include "log_imp.h"
+#include "inflight_table.h"
+
+namespace avdecc_lib
+{
+    inflight_table::inflight_table() : slots(SEQ_ID_COUNT, NULL), head(NULL), tail(NULL), count(0) {}
+
+    inflight_table::~inflight_table()
+    {
+        while (head)
+            erase(head);
+
+        for (size_t i = 0; i < free_cmds.size(); i++)
+            delete free_cmds[i];
+    }
+
+    inflight * inflight_table::insert(const inflight &cmd)
+    {
+        inflight *stored;
+
+        if (slots[cmd.cmd_seq_id])
+        {
+            log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "Dropping stale inflight command with sequence id %d", cmd.cmd_seq_id);
+            erase(slots[cmd.cmd_seq_id]);
+        }
+
+        if (free_cmds.empty())
+        {
+            stored = new inflight(cmd);
+        }
+        else
+        {
+            stored = free_cmds.back();
+            free_cmds.pop_back();
+            *stored = cmd;
+        }
+
+        stored->table_prev = tail;
+        stored->table_next = NULL;
+        if (tail)
+            tail->table_next = stored;
+        else
+            head = stored;
+        tail = stored;
+
+        slots[stored->cmd_seq_id] = stored;
+        notification_id_count[stored->cmd_notification_id]++;
+        count++;
+
+        return stored;
+    }
+
+    void inflight_table::erase(inflight *cmd)
+    {
+        cmd->stop_timer();
+
+        std::unordered_map<void *, uint32_t>::iterator it = notification_id_count.find(cmd->cmd_notification_id);
+
+        if (it != notification_id_count.end() && --it->second == 0)
+            notification_id_count.erase(it);
+
+        if (cmd->table_prev)
+            cmd->table_prev->table_next = cmd->table_next;
+        else
+            head = cmd->table_next;
+
+        if (cmd->table_next)
+            cmd->table_next->table_prev = cmd->table_prev;
+        else
+            tail = cmd->table_prev;
+
+        slots[cmd->cmd_seq_id] = NULL;
+        count--;
+
+        free_cmds.push_back(cmd);
+    }
+
+    bool inflight_table::has_notification_id(void *notification_id) const
+    {
+        return notification_id_count.find(notification_id) != notification_id_count.end();
+    }
+}
@@ -0,0 +1,109 @@
+/*
+ * Licensed under the MIT License (MIT)
+ *
+ * Copyright (c) 2014 AudioScience Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * inflight_table.h
+ *
+ * A table of inflight commands indexed by sequence id.
+ */
+
+#pragma once
+
+#include <vector>
+#include <unordered_map>
+
+#include "inflight.h"
+
+namespace avdecc_lib
+{
+    class inflight_table
+    {
+    public:
+        inflight_table();
+
+        ~inflight_table();
+
+        /**
+         * Store a copy of the command. A stale command that still holds the same sequence id
+         * after the 16 bit sequence id has wrapped is dropped.
+         *
+         * \return The stored command, which stays at the same address until it is erased.
+         */
+        inflight * insert(const inflight &cmd);
+
+        /**
+         * \return The inflight command with the sequence id or NULL if there is none.
+         */
+        inline inflight * find(uint16_t seq_id)
+        {
+            return slots[seq_id];
+        }
+
+        /**
+         * Remove a command returned by insert() or find() from the table.
+         */
+        void erase(inflight *cmd);
+
+        /**
+         * \return True if there is an inflight command with the notification id.
+         */
+        bool has_notification_id(void *notification_id) const;
+
+        /**
+         * \return The number of inflight commands.
+         */
+        inline size_t size() const
+        {
+            return count;
+        }
+
+        /**
+         * \return The oldest inflight command or NULL if the table is empty.
+         */
+        inline inflight * first()
+        {
+            return head;
+        }
+
+        /**
+         * \return The inflight command inserted after cmd or NULL if cmd is the newest.
+         */
+        inline inflight * next(inflight *cmd)
+        {
+            return cmd->table_next;
+        }
+
+    private:
+        enum inflight_table_consts
+        {
+            SEQ_ID_COUNT = 65536
+        };
+
+        std::vector<inflight *> slots; // Direct mapped by sequence id
+        std::vector<inflight *> free_cmds; // Released commands kept for reuse
+        std::unordered_map<void *, uint32_t> notification_id_count; // Number of inflight commands per notification id
+        inflight *head;
+        inflight *tail;
+        size_t count;
+    };
+}
@@ -40,6 +40,7 @@ namespace avdecc_lib
     private:
 
         pthread_t h_thread;
+        volatile bool dispatch_stop; // Set by the destructor to end the log thread
         sem_t log_waiting;
 
     public:
@@ -36,6 +36,7 @@
 
 #include <sys/socket.h>
 #include <sys/ioctl.h>
+#include <sys/mman.h>
 #include <linux/if_packet.h>
 #include <linux/if_ether.h>
 #include <linux/if_arp.h>
@@ -45,9 +46,11 @@
 #include <netdb.h>
 #include <ifaddrs.h>
 
+#include <algorithm>
+
 #include "util.h"
 #include "enumeration.h"
-#include "log.h"
+#include "log_imp.h"
 #include "jdksavdecc_util.h"
 #include "net_interface_imp.h"
 
@@ -95,6 +98,16 @@ namespace avdecc_lib
 
         total_devs = 0;
 
+        rx_ring = NULL;
+        rx_ring_size = 0;
+        rx_block_index = 0;
+        rx_block_in_use = false;
+        rx_block_frames_left = 0;
+        rx_block_next_frame = NULL;
+
+        tx_batch_thread = 0;
+        tx_batch_count = 0;
+
         ip_hdr_store = new ipheader;
         udp_hdr_store = new udpheader;
 
@@ -141,6 +154,8 @@ namespace avdecc_lib
 
     net_interface_imp::~net_interface_imp()
     {
+        if (rx_ring)
+            munmap(rx_ring, rx_ring_size);
         close(rawsock);
     }
 
@@ -207,6 +222,11 @@ namespace avdecc_lib
 
         setpromiscuous(rawsock, ifindex);
 
+        if (rx_ring_init() < 0)
+        {
+            log_imp_ref->post_log_msg(LOGGING_LEVEL_DEBUG, "NETIF - receive ring unavailable, using read()");
+        }
+
         memset(&sll,0, sizeof(sll));
         sll.sll_family = AF_PACKET;
         sll.sll_ifindex = ifindex;
@@ -215,6 +235,18 @@ namespace avdecc_lib
 
         utility::convert_eui48_to_uint64((uint8_t *)if_mac.ifr_hwaddr.sa_data, mac);
 
+        ethertype = 0x22f0;
+
+        /* For SOCK_RAW packet sockets only the interface and protocol of the address are used */
+        struct sockaddr_ll *tx_sll = (struct sockaddr_ll *)&tx_addr;
+        memset(&tx_addr, 0, sizeof(tx_addr));
+        tx_sll->sll_family = PF_PACKET;
+        tx_sll->sll_protocol = htons(ethertype);
+        tx_sll->sll_ifindex = ifindex;
+        tx_sll->sll_hatype = ARPHRD_ETHER;
+        tx_sll->sll_pkttype = PACKET_OTHERHOST;
+        tx_sll->sll_halen = ETH_ALEN;
+
 
         uint16_t etypes[1] = {0x22f0};
         set_capture_ether_type(etypes, 1);
@@ -246,12 +278,94 @@ namespace avdecc_lib
         return 0;
     }
 
+    int net_interface_imp::rx_ring_init()
+    {
+        struct tpacket_req3 req;
+        int version = TPACKET_V3;
+
+        if (setsockopt(rawsock, SOL_PACKET, PACKET_VERSION, &version, sizeof(version)) < 0)
+            return -1;
+
+        memset(&req, 0, sizeof(req));
+        req.tp_block_size = RX_RING_BLOCK_SIZE;
+        req.tp_block_nr = RX_RING_BLOCK_COUNT;
+        req.tp_frame_size = RX_RING_FRAME_SIZE;
+        req.tp_frame_nr = (RX_RING_BLOCK_SIZE / RX_RING_FRAME_SIZE) * RX_RING_BLOCK_COUNT;
+        req.tp_retire_blk_tov = RX_RING_BLOCK_TIMEOUT_MS; // Hand partially filled blocks to user space quickly
+
+        if (setsockopt(rawsock, SOL_PACKET, PACKET_RX_RING, &req, sizeof(req)) < 0)
+            return -1;
+
+        rx_ring_size = (size_t)req.tp_block_size * req.tp_block_nr;
+        void *ring = mmap(NULL, rx_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_LOCKED, rawsock, 0);
+        if (ring == MAP_FAILED)
+            ring = mmap(NULL, rx_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED, rawsock, 0);
+        if (ring == MAP_FAILED)
+        {
+            /* Tear the ring down again so that read() works on the socket */
+            memset(&req, 0, sizeof(req));
+            setsockopt(rawsock, SOL_PACKET, PACKET_RX_RING, &req, sizeof(req));
+            rx_ring_size = 0;
+            return -1;
+        }
+
+        rx_ring = (uint8_t *)ring;
+        rx_block_index = 0;
+        rx_block_in_use = false;
+        rx_block_frames_left = 0;
+
+        return 0;
+    }
+
+    int net_interface_imp::rx_ring_next_frame(const uint8_t **frame, uint16_t *mem_buf_len)
+    {
+        struct tpacket_block_desc *block;
+        struct tpacket3_hdr *hdr;
+
+        while (rx_block_frames_left == 0)
+        {
+            if (rx_block_in_use)
+            {
+                /* The last frame of this block has been processed, give the block back to the kernel */
+                block = (struct tpacket_block_desc *)(rx_ring + (size_t)rx_block_index * RX_RING_BLOCK_SIZE);
+                __sync_synchronize();
+                block->hdr.bh1.block_status = TP_STATUS_KERNEL;
+                rx_block_in_use = false;
+                rx_block_index = (rx_block_index + 1) % RX_RING_BLOCK_COUNT;
+            }
+
+            block = (struct tpacket_block_desc *)(rx_ring + (size_t)rx_block_index * RX_RING_BLOCK_SIZE);
+            if ((block->hdr.bh1.block_status & TP_STATUS_USER) == 0)
+            {
+                *mem_buf_len = 0;
+                return 0;
+            }
+            __sync_synchronize();
+
+            rx_block_in_use = true;
+            rx_block_frames_left = block->hdr.bh1.num_pkts;
+            rx_block_next_frame = (uint8_t *)block + block->hdr.bh1.offset_to_first_pkt;
+        }
+
+        hdr = (struct tpacket3_hdr *)rx_block_next_frame;
+        *frame = rx_block_next_frame + hdr->tp_mac;
+        *mem_buf_len = hdr->tp_snaplen;
+
+        rx_block_next_frame += hdr->tp_next_offset;
+        rx_block_frames_left--;
+
+        return *mem_buf_len;
+    }
+
     int STDCALL net_interface_imp::capture_frame(const uint8_t **frame, uint16_t *mem_buf_len)
     {
         int len;
 
+        if (rx_ring)
+            return rx_ring_next_frame(frame, mem_buf_len);
+
         *frame = &rx_buf[0];
-        len = read(rawsock, &rx_buf[0], sizeof(rx_buf));
+        len = recv(rawsock, &rx_buf[0], sizeof(rx_buf), MSG_DONTWAIT);
         if (len < 0)
         {
             *mem_buf_len = 0;
@@ -265,40 +379,93 @@ namespace avdecc_lib
 
     int net_interface_imp::send_frame(uint8_t *frame, uint16_t mem_buf_len)
     {
-        int send_result;
+        // Other threads only ever see 0 or the batching thread here, so they send straight away
+        if (pthread_equal(pthread_self(), tx_batch_thread.load(std::memory_order_acquire)) && (mem_buf_len <= SIZEOF_BUFFER))
+        {
+            if (tx_batch_count == TX_BATCH_COUNT)
+            {
+                int batch_size = tx_batch_count;
 
-        /*target address*/
-        struct sockaddr_ll socket_address;
+                if (tx_batch_end() < batch_size)
+                    return -1;
+                tx_batch_begin();
+            }
 
-        /*prepare sockaddr_ll*/
+            memcpy(tx_batch_buf[tx_batch_count], frame, mem_buf_len);
+            tx_batch_len[tx_batch_count] = mem_buf_len;
+            tx_batch_count++;
 
-        /*RAW communication*/
-        socket_address.sll_family   = PF_PACKET;
-        socket_address.sll_protocol = htons(ethertype);
+            return mem_buf_len;
+        }
 
-        /*index of the network device
-        see full code later how to retrieve it*/
-        socket_address.sll_ifindex  = ifindex;
+        return sendto(rawsock, frame, mem_buf_len, 0, (struct sockaddr *)&tx_addr, sizeof(struct sockaddr_ll));
+    }
 
-        /*ARP hardware identifier is ethernet*/
-        socket_address.sll_hatype   = ARPHRD_ETHER;
+    int net_interface_imp::send_frames(const struct iovec *frames, uint32_t frame_count)
+    {
+        struct mmsghdr msgs[TX_BATCH_COUNT];
+        uint32_t sent = 0;
 
-        /*target is another host*/
-        socket_address.sll_pkttype  = PACKET_OTHERHOST;
+        while (sent < frame_count)
+        {
+            uint32_t count = std::min<uint32_t>(frame_count - sent, TX_BATCH_COUNT);
+            int result;
+
+            memset(msgs, 0, sizeof(msgs[0]) * count);
+            for (uint32_t i = 0; i < count; i++)
+            {
+                msgs[i].msg_hdr.msg_name = &tx_addr;
+                msgs[i].msg_hdr.msg_namelen = sizeof(struct sockaddr_ll);
+                msgs[i].msg_hdr.msg_iov = (struct iovec *)&frames[sent + i];
+                msgs[i].msg_hdr.msg_iovlen = 1;
+            }
 
-        /*address length*/
-        socket_address.sll_halen    = ETH_ALEN;
-        /*MAC - begin*/
-        memcpy(&socket_address.sll_addr[0], &frame[0], 6);
-        /*MAC - end*/
-        socket_address.sll_addr[6]  = 0x00;/*not used*/
-        socket_address.sll_addr[7]  = 0x00;/*not used*/
+            result = sendmmsg(rawsock, msgs, count, 0);
+            if (result < 0)
+            {
+                if (errno == EINTR)
+                    continue;
+
+                log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "NETIF - sendmmsg failed: %s", strerror(errno));
+                return sent > 0 ? (int)sent : -1;
+            }
+
+            sent += result;
+        }
+
+        return sent;
+    }
+
+    void net_interface_imp::tx_batch_begin()
+    {
+        tx_batch_count = 0;
+        tx_batch_thread.store(pthread_self(), std::memory_order_release);
+    }
+
+    int net_interface_imp::tx_batch_end()
+    {
+        struct iovec frames[TX_BATCH_COUNT];
+        uint32_t count = tx_batch_count;
+        int sent;
+
+        tx_batch_thread.store(0, std::memory_order_release);
+        tx_batch_count = 0;
+
+        if (count == 0)
+            return 0;
+
+        for (uint32_t i = 0; i < count; i++)
+        {
+            frames[i].iov_base = tx_batch_buf[i];
+            frames[i].iov_len = tx_batch_len[i];
+        }
 
-        /*send the packet*/
-        send_result = sendto(rawsock, frame, mem_buf_len, 0,
-                             (struct sockaddr*)&socket_address, sizeof(socket_address));
+        // send_frame() reported these frames as sent, so a short send is only visible here
+        sent = send_frames(frames, count);
+        if (sent < (int)count)
+            log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "NETIF - %d of %d batched frames not sent", (int)count - std::max(sent, 0), (int)count);
 
-        return send_result;
+        return sent;
     }
 
     int net_interface_imp::getifindex(int rawsock, const char *iface)
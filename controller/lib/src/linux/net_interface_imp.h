@@ -34,6 +34,10 @@
 #include <iostream>
 #include <vector>
 #include <string>
+#include <atomic>
+#include <pthread.h>
+#include <sys/uio.h>
+#include <sys/socket.h>
 
 #include "build.h"
 #include "net_interface.h"
@@ -49,7 +53,12 @@ namespace avdecc_lib
     private:
         enum econsts
         {
-            SIZEOF_BUFFER = 2048
+            SIZEOF_BUFFER = 2048,
+            RX_RING_BLOCK_SIZE = 1 << 16,
+            RX_RING_BLOCK_COUNT = 32,
+            RX_RING_FRAME_SIZE = 2048,
+            RX_RING_BLOCK_TIMEOUT_MS = 1,
+            TX_BATCH_COUNT = 64
         };
 
         std::vector<std::string> ifnames;
@@ -64,9 +73,37 @@ namespace avdecc_lib
         uint8_t buf[SIZEOF_BUFFER];
         uint8_t rx_buf[SIZEOF_BUFFER];
 
+        uint8_t *rx_ring; // mmap'd TPACKET_V3 receive ring, NULL when frames are read() from the socket
+        size_t rx_ring_size;
+        uint32_t rx_block_index; // Ring block currently being walked
+        bool rx_block_in_use; // Set while the current block is owned by user space
+        uint32_t rx_block_frames_left;
+        uint8_t *rx_block_next_frame;
+
+        struct sockaddr_storage tx_addr; // sockaddr_ll destination for all frames, the link layer header is part of the frame
+        std::atomic<pthread_t> tx_batch_thread; // The thread a batch is open on, 0 outside tx_batch_begin() and tx_batch_end()
+        uint32_t tx_batch_count;
+        uint16_t tx_batch_len[TX_BATCH_COUNT];
+        uint8_t tx_batch_buf[TX_BATCH_COUNT][SIZEOF_BUFFER];
+
         int getifindex(int rawsock, const char *iface);
         int setpromiscuous(int rawsock, int ifindex);
 
+        /**
+         * Set up a memory mapped TPACKET_V3 receive ring on the raw socket.
+         *
+         * \return 0 on success, -1 if the kernel does not support it and frames have to be read() instead.
+         */
+        int rx_ring_init();
+
+        /**
+         * Return the next frame in the receive ring, handing a block back to the kernel once
+         * all of its frames have been walked.
+         *
+         * \return The frame length or 0 if there is no frame ready.
+         */
+        int rx_ring_next_frame(const uint8_t **frame, uint16_t *mem_buf_len);
+
     public:
         /**
          * An empty constructor for net_interface_imp
@@ -107,15 +144,40 @@ namespace avdecc_lib
         int set_capture_ether_type(uint16_t *ether_type, uint32_t count);
 
         /**
-         * Capture a network packet.
+         * Capture a network packet without blocking. Frames returned from the receive ring remain
+         * valid until the next call.
+         *
+         * \return The frame length, or 0 or less if there is no frame ready.
          */
         int STDCALL capture_frame(const uint8_t **frame, uint16_t *mem_buf_len);
 
         /**
-         * Send a network packet.
+         * Send a network packet. While a transmit batch is open on the calling thread the frame is
+         * copied into the batch and sent by tx_batch_end().
+         *
+         * \return The frame length on success or -1 on failure.
          */
         int send_frame(uint8_t *frame, uint16_t mem_buf_len);
 
+        /**
+         * Send a vector of network packets with a single sendmmsg() call.
+         *
+         * \return The number of frames sent or -1 on failure.
+         */
+        int send_frames(const struct iovec *frames, uint32_t frame_count);
+
+        /**
+         * Start collecting frames sent from the calling thread into a batch.
+         */
+        void tx_batch_begin();
+
+        /**
+         * Send all frames collected since tx_batch_begin() and stop batching.
+         *
+         * \return The number of frames sent or -1 on failure.
+         */
+        int tx_batch_end();
+
         int get_fd();
 
     };
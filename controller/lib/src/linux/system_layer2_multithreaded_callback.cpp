@@ -50,15 +50,18 @@
 #include <net/ethernet.h>
 #include <sys/un.h>
 #include <sys/eventfd.h>
+#include <sched.h>
 
 #include <vector>
 
 #include "net_interface_imp.h"
+#include "net_interface_set.h"
 #include "enumeration.h"
 #include "notification_imp.h"
 #include "log_imp.h"
 #include "end_station_imp.h"
 #include "controller_imp.h"
+#include "timer_wheel.h"
 #include "system_message_queue.h"
 #include "system_tx_queue.h"
 #include "system_layer2_multithreaded_callback.h"
@@ -67,11 +70,11 @@
 namespace avdecc_lib
 {
 
-    net_interface_imp *netif_obj_in_system;
     controller_imp *controller_ref_in_system;
     system_layer2_multithreaded_callback *local_system = NULL;
 
     system_layer2_multithreaded_callback *system_layer2_multithreaded_callback::instance = NULL;
+    thread_local system_layer2_multithreaded_callback::engine_thread *system_layer2_multithreaded_callback::current_thread = NULL;
 
 
     size_t system_queue_tx(void *notification_id, uint32_t notification_flag, uint8_t *frame, size_t mem_buf_len)
@@ -96,15 +99,12 @@ namespace avdecc_lib
     system_layer2_multithreaded_callback::system_layer2_multithreaded_callback(net_interface *netif, controller *controller_obj)
     {
         instance = this;
-        netif_obj_in_system = dynamic_cast<net_interface_imp *>(netif);
         controller_ref_in_system = dynamic_cast<controller_imp *>(controller_obj);
-        pipe(tx_pipe);
 
-        wait_mgr = new cmd_wait_mgr();
+        started = false;
+        threads.push_back(create_engine_thread(engine_shard::primary()));
 
-        waiting_sem = (sem_t *)calloc(1, sizeof(*waiting_sem));
-        if (waiting_sem)
-            sem_init(waiting_sem, 0, 0);
+        completions = new cmd_completion_table();
 
         shutdown_sem = (sem_t *)calloc(1, sizeof(*shutdown_sem));
         if (shutdown_sem)
@@ -113,7 +113,9 @@ namespace avdecc_lib
 
     system_layer2_multithreaded_callback::~system_layer2_multithreaded_callback()
     {
-        free(waiting_sem);
+        for (size_t i = 0; i < threads.size(); i++)
+            destroy_engine_thread(threads[i]);
+        delete completions;
         free(shutdown_sem);
     }
 
@@ -121,86 +123,269 @@ namespace avdecc_lib
     {
         if (this == local_system)
         {
+            uint64_t doorbell = 1;
+
             local_system = NULL;
 
-            // Wait for controller to have finished
-            if (sem_wait(shutdown_sem) != 0)
+            if (started)
             {
-                perror("sem_wait");
+                // The engine threads may be sleeping with no timer armed, wake them up to see the shutdown
+                for (size_t i = 0; i < threads.size(); i++)
+                    write(threads[i]->tx_doorbell, &doorbell, sizeof(doorbell));
+
+                // Wait for every engine thread to have finished
+                for (size_t i = 0; i < threads.size(); i++)
+                {
+                    if (sem_wait(shutdown_sem) != 0)
+                    {
+                        perror("sem_wait");
+                    }
+                }
             }
         }
 
         delete this;
     }
 
+    system_layer2_multithreaded_callback::engine_thread * system_layer2_multithreaded_callback::create_engine_thread(engine_shard *shard)
+    {
+        struct engine_thread *t = new engine_thread();
+
+        t->shard = shard;
+        memset(&t->h_thread, 0, sizeof(t->h_thread));
+        t->tx_ring = new mpsc_ring<struct tx_data>(TX_RING_SLOT_COUNT);
+        t->tx_doorbell = eventfd(0, EFD_NONBLOCK);
+
+        // The first thread receives from the network interfaces itself
+        t->rx_ring = threads.empty() ? NULL : new mpsc_ring<struct rx_data>(RX_RING_SLOT_COUNT);
+        t->rx_doorbell = threads.empty() ? -1 : eventfd(0, EFD_NONBLOCK);
+
+        t->tick_timer = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK);
+        t->tick_timer_armed = false;
+        t->tick_timer_expiry = 0;
+
+        return t;
+    }
+
+    void system_layer2_multithreaded_callback::destroy_engine_thread(struct engine_thread *t)
+    {
+        close(t->tick_timer);
+        close(t->tx_doorbell);
+        delete t->tx_ring;
+
+        if (t->rx_ring)
+        {
+            close(t->rx_doorbell);
+            delete t->rx_ring;
+        }
+
+        // A shard that has run keeps the timers of its End Stations, so only unused ones are freed
+        if (!started && (t->shard != engine_shard::primary()))
+            delete t->shard;
+
+        delete t;
+    }
+
+    int STDCALL system_layer2_multithreaded_callback::set_engine_shard_count(uint32_t count)
+    {
+        if (started || (count < 1) || (count > MAX_ENGINE_SHARDS))
+        {
+            log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "Engine shard count %d cannot be used", (int)count);
+            return -1;
+        }
+
+        while (threads.size() > count)
+        {
+            destroy_engine_thread(threads.back());
+            threads.pop_back();
+        }
+
+        while (threads.size() < count)
+            threads.push_back(create_engine_thread(new engine_shard(false)));
+
+        return 0;
+    }
+
+    system_layer2_multithreaded_callback::tx_data * system_layer2_multithreaded_callback::reserve_tx(struct engine_thread *t, bool &is_deferred)
+    {
+        struct tx_data *data;
+
+        // Once a frame of an engine thread has been deferred, the ones after it are too so that they keep their order
+        is_deferred = current_thread && !current_thread->tx_deferred.empty();
+
+        while (!is_deferred && ((data = t->tx_ring->reserve()) == NULL))
+        {
+            if (current_thread)
+            {
+                // An engine thread cannot wait for room: it is the only consumer of its own ring, and two
+                // shards waiting on each other's rings would never drain either. The frame is held back
+                // until the poll loop has drained the thread's ring and the target ring has room.
+                is_deferred = true;
+            }
+            else
+            {
+                sched_yield();
+            }
+        }
+
+        if (is_deferred)
+        {
+            current_thread->tx_deferred.push_back(deferred_tx());
+            current_thread->tx_deferred.back().target = t;
+            data = &current_thread->tx_deferred.back().data;
+        }
+
+        return data;
+    }
+
+    void system_layer2_multithreaded_callback::commit_tx(struct engine_thread *t, struct tx_data *data, bool is_deferred)
+    {
+        if (!is_deferred && t->tx_ring->commit(data))
+        {
+            uint64_t doorbell = 1;
+            write(t->tx_doorbell, &doorbell, sizeof(doorbell));
+        }
+    }
+
+    void system_layer2_multithreaded_callback::flush_deferred_tx(struct engine_thread *t)
+    {
+        while (!t->tx_deferred.empty())
+        {
+            struct deferred_tx &deferred = t->tx_deferred.front();
+            struct tx_data *data = deferred.target->tx_ring->reserve();
+
+            if (!data)
+                break;
+
+            data->mem_buf_len = deferred.data.mem_buf_len;
+            memcpy(data->frame, deferred.data.frame, deferred.data.mem_buf_len);
+            data->notification_id = deferred.data.notification_id;
+            data->notification_flag = deferred.data.notification_flag;
+
+            commit_tx(deferred.target, data, false);
+            t->tx_deferred.pop_front();
+        }
+    }
+
     int system_layer2_multithreaded_callback::queue_tx_frame(
         void *notification_id,
         uint32_t notification_flag,
         uint8_t *frame,
         size_t mem_buf_len)
     {
-        struct tx_data t;
+        struct engine_thread *t;
+        struct tx_data *data;
+        bool is_deferred;
 
-        t.frame = new uint8_t[2048];
-        if (!t.frame)
-        {
-            perror("malloc");
-            exit(EXIT_FAILURE);
+        assert(mem_buf_len <= TX_FRAME_SIZE);
 
-        }
-        t.mem_buf_len = mem_buf_len;
-        memcpy(t.frame, frame, mem_buf_len);
-        t.notification_id = notification_id;
-        t.notification_flag = notification_flag;
-        write(tx_pipe[PIPE_WR], &t, sizeof(t));
-
-        /**
-         * Check for conditions that cause wait for completion.
-         */
-        if ( wait_mgr->primed_state() &&
-             wait_mgr->match_id(notification_id) &&
-             (notification_flag == CMD_WITH_NOTIFICATION))
+        if ((notification_flag == CMD_BATCH_WITH_NOTIFICATION) && (threads.size() > 1))
+            return queue_tx_batch(notification_id, frame);
+
+        // Frames are sent by the engine thread of the End Station they are for
+        t = threads[engine_shard::tx_index_of(notification_flag, frame, mem_buf_len, threads.size())];
+        data = reserve_tx(t, is_deferred);
+
+        data->mem_buf_len = mem_buf_len;
+        memcpy(data->frame, frame, mem_buf_len);
+        data->notification_id = notification_id;
+        data->notification_flag = notification_flag;
+
+        // Mark the command as sent before the engine thread can see it, so that its response cannot be missed
+        cmd_completion_imp *primed = completions->cmd_queued(notification_id, notification_flag);
+
+        commit_tx(t, data, is_deferred);
+
+        // Block until the command completes if the calling thread primed it with set_wait_for_next_cmd
+        if (primed)
+            completions->wait_for_primed(primed);
+
+        return 0;
+    }
+
+    int system_layer2_multithreaded_callback::queue_tx_batch(void *notification_id, uint8_t *frame)
+    {
+        struct bulk_cmd_batch *batch;
+        std::vector<struct bulk_cmd_batch *> batches;
+
+        memcpy(&batch, frame, sizeof(batch));
+
+        // Every engine thread sends the commands for its own End Stations, the last one to finish completes the batch
+        uint32_t parts = (uint32_t)engine_shard::split_batch(batch, threads.size(), batches);
+        cmd_completion_imp *primed = completions->cmd_queued(notification_id, CMD_BATCH_WITH_NOTIFICATION, parts);
+
+        for (size_t i = 0; i < batches.size(); i++)
         {
-            int status = 0;
-
-            status = wait_mgr->set_active_state();
-            assert(status == 0);
-            sem_wait(waiting_sem);
-            resp_status_for_cmd = wait_mgr->get_completion_status();
-            status = wait_mgr->set_idle_state();
-            assert(status == 0);
+            if (!batches[i])
+                continue;
+
+            bool is_deferred;
+            struct tx_data *data = reserve_tx(threads[i], is_deferred);
+
+            data->mem_buf_len = sizeof(batches[i]);
+            memcpy(data->frame, &batches[i], sizeof(batches[i]));
+            data->notification_id = notification_id;
+            data->notification_flag = CMD_BATCH_WITH_NOTIFICATION;
+
+            commit_tx(threads[i], data, is_deferred);
         }
 
+        if (primed)
+            completions->wait_for_primed(primed);
+
         return 0;
     }
 
     int STDCALL system_layer2_multithreaded_callback::set_wait_for_next_cmd(void * id)
     {
-        wait_mgr->set_primed_state(id);
+        completions->set_wait_for_next_cmd(id);
         return 0;
     }
 
     int STDCALL system_layer2_multithreaded_callback::get_last_resp_status()
     {
-        return resp_status_for_cmd;
+        return completions->get_last_resp_status();
+    }
+
+    cmd_completion * STDCALL system_layer2_multithreaded_callback::create_cmd_completion(void *notification_id)
+    {
+        return completions->create(notification_id);
     }
 
 
-    int system_layer2_multithreaded_callback::timer_start_interval(int timerfd)
+    int system_layer2_multithreaded_callback::timer_arm_next(struct engine_thread *t)
     {
         struct itimerspec itimer_new;
-        struct itimerspec itimer_old;
-        unsigned long ns_per_ms = 1000000;
-        unsigned long interval_ms = TIME_PERIOD_25_MILLISECONDS;
+        uint32_t expiry;
 
         memset(&itimer_new, 0, sizeof(itimer_new));
-        memset(&itimer_old, 0, sizeof(itimer_old));
 
-        itimer_new.it_interval.tv_sec = interval_ms / 1000;
-        itimer_new.it_interval.tv_nsec = (interval_ms % 1000) * ns_per_ms;
-        itimer_new.it_value = itimer_new.it_interval;
+        if (!timer_wheel_ref->next_expiry(expiry))
+        {
+            if (!t->tick_timer_armed)
+                return 0;
+
+            t->tick_timer_armed = false;
+            return timerfd_settime(t->tick_timer, 0, &itimer_new, NULL); // Nothing to time out, disarm
+        }
+
+        if (t->tick_timer_armed && (expiry == t->tick_timer_expiry))
+            return 0;
 
-        return timerfd_settime(timerfd, 0, &itimer_new, &itimer_old);
+        int32_t delay_ms = (int32_t)(expiry - timer_wheel_ref->now());
+        if (delay_ms > 0)
+        {
+            itimer_new.it_value.tv_sec = delay_ms / 1000;
+            itimer_new.it_value.tv_nsec = (delay_ms % 1000) * 1000000;
+        }
+        else
+        {
+            itimer_new.it_value.tv_nsec = 1; // Already due
+        }
+
+        t->tick_timer_armed = true;
+        t->tick_timer_expiry = expiry;
+        return timerfd_settime(t->tick_timer, 0, &itimer_new, NULL);
     }
 
     int system_layer2_multithreaded_callback::fn_timer_cb(struct epoll_priv *priv)
@@ -215,36 +400,45 @@ namespace avdecc_lib
     {
         return instance->fn_tx(priv);
     }
+    int system_layer2_multithreaded_callback::fn_rx_cb(struct epoll_priv *priv)
+    {
+        return instance->fn_rx(priv);
+    }
 
 
     int system_layer2_multithreaded_callback::fn_timer(struct epoll_priv *priv)
     {
+        struct engine_thread *t = priv->thread;
         uint64_t timer_exp_count;
         read(priv->fd, &timer_exp_count, sizeof(timer_exp_count));
+        t->tick_timer_armed = false;
 
-        bool notification_id_incomplete = false;
-
-        if (wait_mgr->active_state())
+        // Commands with completions that are inflight before the timer tick update and no longer
+        // inflight after it have been timed out, so complete them.
+        t->tick_active_ids.clear();
+        if (completions->has_active())
         {
-            if (controller_ref_in_system->is_inflight_cmd_with_notification_id(wait_mgr->get_notify_id()) ||
-                controller_ref_in_system->is_active_operation_with_notification_id(wait_mgr->get_notify_id()))
-                notification_id_incomplete = true;
+            size_t inflight_count = 0;
+
+            completions->get_active_ids(t->tick_active_ids);
+            for (size_t i = 0; i < t->tick_active_ids.size(); i++)
+            {
+                if (controller_ref_in_system->is_inflight_cmd_with_notification_id(t->tick_active_ids[i]) ||
+                    controller_ref_in_system->is_active_operation_with_notification_id(t->tick_active_ids[i]))
+                    t->tick_active_ids[inflight_count++] = t->tick_active_ids[i];
+            }
+            t->tick_active_ids.resize(inflight_count);
         }
 
-        // If waiting on a command to complete and the command was "inflight" prior to calling the
-        // timer tick update (ie notification_id_incomplete == true) AND after calling the timer tick
-        // update the command is no longer "inflight", timeout processing has removed it, so signal the
-        // waiting app thread.
         controller_ref_in_system->time_tick_event();
 
-        bool is_timeout_for_waiting_notify_id = wait_mgr->active_state() && notification_id_incomplete &&
-                                                !controller_ref_in_system->is_inflight_cmd_with_notification_id(wait_mgr->get_notify_id()) &&
-                                                !controller_ref_in_system->is_active_operation_with_notification_id(wait_mgr->get_notify_id());
-        if (is_timeout_for_waiting_notify_id)
+        for (size_t i = 0; i < t->tick_active_ids.size(); i++)
         {
-            int status = wait_mgr->set_completion_status(AVDECC_LIB_STATUS_TICK_TIMEOUT);
-            assert(status == 0);
-            sem_post(waiting_sem);
+            if (!controller_ref_in_system->is_inflight_cmd_with_notification_id(t->tick_active_ids[i]) &&
+                !controller_ref_in_system->is_active_operation_with_notification_id(t->tick_active_ids[i]))
+            {
+                completions->complete(t->tick_active_ids[i], controller_ref_in_system->tick_completion_status(t->tick_active_ids[i]));
+            }
         }
 
         return 0;
@@ -252,65 +446,142 @@ namespace avdecc_lib
 
     int system_layer2_multithreaded_callback::fn_tx(struct epoll_priv *priv)
     {
-        struct tx_data t;
-        int result = read(tx_pipe[PIPE_RD], &t, sizeof(t));
+        uint64_t doorbell_count;
+        read(priv->fd, &doorbell_count, sizeof(doorbell_count));
+
+        return proc_tx_ring(priv->thread);
+    }
 
-        if (result > 0)
+    int system_layer2_multithreaded_callback::proc_tx_ring(struct engine_thread *t)
+    {
+        struct tx_data *data;
+        int count = 0;
+
+        while ((count < TX_BATCH_COUNT) && ((data = t->tx_ring->front()) != NULL))
         {
-            log_imp_ref->post_log_msg(LOGGING_LEVEL_DEBUG, "fn_tx");
             controller_ref_in_system->tx_packet_event(
-                t.notification_id,
-                t.notification_flag,
-                t.frame,
-                t.mem_buf_len);
+                data->notification_id,
+                data->notification_flag,
+                data->frame,
+                data->mem_buf_len);
 
-            delete[] t.frame;
+            t->tx_ring->pop();
+            count++;
         }
 
+        if (count > 0)
+            log_imp_ref->post_log_msg(LOGGING_LEVEL_DEBUG, "fn_tx %d frames", count);
+
+        // Only sleep on the doorbell once the ring has been drained, otherwise the poll loop
+        // comes straight back for the next batch after servicing the other events.
+        if (count < TX_BATCH_COUNT)
+            t->tx_ring->arm_doorbell();
+
         return 0;
     }
 
 
+    void system_layer2_multithreaded_callback::rx_frame_event(const uint8_t *frame, uint16_t length, size_t netif_index)
+    {
+        bool is_notification_id_valid = false;
+        int rx_status = -1;
+        void *notification_id = NULL;
+        uint16_t operation_id = 0;
+        bool is_operation_id_valid = false;
+
+        controller_ref_in_system->rx_packet_event(notification_id,
+                is_notification_id_valid,
+                frame,
+                length,
+                rx_status,
+                operation_id,
+                is_operation_id_valid,
+                netif_index);
+
+        if (
+            is_notification_id_valid &&
+            completions->has_active() &&
+            !controller_ref_in_system->is_inflight_cmd_with_notification_id(notification_id) &&
+            !controller_ref_in_system->is_active_operation_with_notification_id(notification_id)
+        )
+        {
+            completions->complete(notification_id, rx_status);
+        }
+    }
+
     int system_layer2_multithreaded_callback::fn_netif(struct epoll_priv *priv)
     {
         uint16_t length = 0;
         const uint8_t *rx_frame;
         int status = 0;
+        size_t shard_count = threads.size();
 
-        status = netif_obj_in_system->capture_frame(&rx_frame, &length);
+        net_interface_imp *netif = net_interface_set_ref->at(priv->netif_index);
 
-        if (status > 0)
+        // Walk every frame that is ready (a whole receive ring block at a time) before going back to
+        // epoll, bounded so that the timer and tx ring still get serviced under heavy receive load.
+        for (int count = 0; count < RX_BATCH_COUNT; count++)
         {
-            bool is_notification_id_valid = false;
-            int rx_status = -1;
-            void *notification_id = NULL;
-            uint16_t operation_id = 0;
-            bool is_operation_id_valid = false;
-
-            controller_ref_in_system->rx_packet_event(notification_id,
-                    is_notification_id_valid,
-                    rx_frame,
-                    length,
-                    rx_status,
-                    operation_id,
-                    is_operation_id_valid);
-
-            if (
-                wait_mgr->active_state() &&
-                is_notification_id_valid &&
-                wait_mgr->match_id(notification_id) &&
-                !controller_ref_in_system->is_inflight_cmd_with_notification_id(wait_mgr->get_notify_id()) &&
-                !controller_ref_in_system->is_active_operation_with_notification_id(wait_mgr->get_notify_id())
-            )
+            status = netif->capture_frame(&rx_frame, &length);
+            if (status <= 0)
+                break;
+
+            size_t index = (shard_count > 1) ? engine_shard::index_of(engine_shard::frame_entity_id(rx_frame, length), shard_count) : 0;
+            if (index == 0)
+            {
+                rx_frame_event(rx_frame, length, priv->netif_index);
+                continue;
+            }
+
+            // Frames for End Stations of the other shards are handed over to their engine threads
+            struct engine_thread *t = threads[index];
+            struct rx_data *data = (length <= TX_FRAME_SIZE) ? t->rx_ring->reserve() : NULL;
+            if (!data)
             {
-                int status = wait_mgr->set_completion_status(rx_status);
-                assert(status == 0);
-                sem_post(waiting_sem);
+                log_imp_ref->post_log_msg(LOGGING_LEVEL_DEBUG, "Engine shard %d receive ring full, frame dropped", (int)index);
+                continue;
+            }
+
+            data->netif_index = priv->netif_index;
+            data->length = length;
+            memcpy(data->frame, rx_frame, length);
+
+            if (t->rx_ring->commit(data))
+            {
+                uint64_t doorbell = 1;
+                write(t->rx_doorbell, &doorbell, sizeof(doorbell));
             }
         }
         return 0;
     }
 
+    int system_layer2_multithreaded_callback::fn_rx(struct epoll_priv *priv)
+    {
+        uint64_t doorbell_count;
+        read(priv->fd, &doorbell_count, sizeof(doorbell_count));
+
+        return proc_rx_ring(priv->thread);
+    }
+
+    int system_layer2_multithreaded_callback::proc_rx_ring(struct engine_thread *t)
+    {
+        struct rx_data *data;
+        int count = 0;
+
+        while ((count < RX_BATCH_COUNT) && ((data = t->rx_ring->front()) != NULL))
+        {
+            rx_frame_event(data->frame, data->length, data->netif_index);
+
+            t->rx_ring->pop();
+            count++;
+        }
+
+        if (count < RX_BATCH_COUNT)
+            t->rx_ring->arm_doorbell();
+
+        return 0;
+    }
+
 
     int system_layer2_multithreaded_callback::prep_evt_desc(
         int fd,
@@ -320,38 +591,70 @@ namespace avdecc_lib
     {
         priv->fd = fd;
         priv->fn = fn;
+        priv->netif_index = 0;
+        priv->thread = NULL;
         ev->events = EPOLLIN;
         ev->data.ptr = priv;
         return 0;
     }
 
-    int system_layer2_multithreaded_callback::proc_poll_loop()
+    int system_layer2_multithreaded_callback::proc_poll_loop(struct engine_thread *t)
     {
 
         int epollfd;
-        struct epoll_event ev, epoll_evt[POLL_COUNT];
-        struct epoll_priv fd_fns[POLL_COUNT];
+        bool is_receiver = (t == threads[0]);
+        size_t netif_count = is_receiver ? net_interface_set_ref->count() : 0;
+        size_t poll_count = POLL_COUNT + (is_receiver ? netif_count : 1);
+        struct epoll_event ev;
+        std::vector<struct epoll_event> epoll_evt(poll_count);
+        std::vector<struct epoll_priv> fd_fns(poll_count);
+
+        // The protocol state used by this thread from now on is the one of its shard
+        t->shard->make_current();
+        current_thread = t;
 
-        epollfd = epoll_create(POLL_COUNT);
+        epollfd = epoll_create((int)poll_count);
 
-        prep_evt_desc(timerfd_create(CLOCK_MONOTONIC, 0), &system_layer2_multithreaded_callback::fn_timer_cb, &fd_fns[0],  &ev);
+        prep_evt_desc(t->tick_timer, &system_layer2_multithreaded_callback::fn_timer_cb, &fd_fns[0],  &ev);
+        fd_fns[0].thread = t;
         epoll_ctl(epollfd, EPOLL_CTL_ADD, fd_fns[0].fd, &ev);
 
-        prep_evt_desc(netif_obj_in_system->get_fd(), &system_layer2_multithreaded_callback::fn_netif_cb, &fd_fns[1], &ev);
+        prep_evt_desc(t->tx_doorbell, &system_layer2_multithreaded_callback::fn_tx_cb, &fd_fns[1], &ev);
+        fd_fns[1].thread = t;
         epoll_ctl(epollfd, EPOLL_CTL_ADD, fd_fns[1].fd, &ev);
 
-        prep_evt_desc(tx_pipe[PIPE_RD], &system_layer2_multithreaded_callback::fn_tx_cb, &fd_fns[2],
-                      &ev);
-        epoll_ctl(epollfd, EPOLL_CTL_ADD, fd_fns[2].fd, &ev);
+        if (is_receiver)
+        {
+            // Every network interface is received on by the first thread
+            for (size_t n = 0; n < netif_count; n++)
+            {
+                struct epoll_priv *netif_fn = &fd_fns[POLL_COUNT + n];
 
-        fcntl(fd_fns[0].fd, F_SETFL, O_NONBLOCK);
-        timer_start_interval(fd_fns[0].fd);
+                prep_evt_desc(net_interface_set_ref->at(n)->get_fd(), &system_layer2_multithreaded_callback::fn_netif_cb, netif_fn, &ev);
+                netif_fn->netif_index = n;
+                netif_fn->thread = t;
+                epoll_ctl(epollfd, EPOLL_CTL_ADD, netif_fn->fd, &ev);
+            }
+        }
+        else
+        {
+            prep_evt_desc(t->rx_doorbell, &system_layer2_multithreaded_callback::fn_rx_cb, &fd_fns[POLL_COUNT], &ev);
+            fd_fns[POLL_COUNT].thread = t;
+            epoll_ctl(epollfd, EPOLL_CTL_ADD, fd_fns[POLL_COUNT].fd, &ev);
+        }
+
+        // The first tick starts discovery, after that the timer is only armed for the next timeout
+        controller_ref_in_system->time_tick_event();
+        timer_arm_next(t);
 
         do
         {
             int i, res;
             struct epoll_priv *priv;
-            res = epoll_wait(epollfd, epoll_evt, POLL_COUNT, -1);
+            bool is_ring_pending = !t->tx_ring->is_doorbell_armed() || !t->tx_deferred.empty() ||
+                                   (t->rx_ring && !t->rx_ring->is_doorbell_armed());
+            int timeout_ms = is_ring_pending ? 0 : -1;
+            res = epoll_wait(epollfd, &epoll_evt[0], (int)poll_count, timeout_ms);
 
             if (local_system == NULL)
             {
@@ -364,12 +667,36 @@ namespace avdecc_lib
             if (-1 == res)
                 return -errno;
 
+            // Everything the receiving thread transmits while handling this iteration's events goes out
+            // in one batch per interface, the other threads send their frames straight away.
+            for (size_t n = 0; n < netif_count; n++)
+                net_interface_set_ref->at(n)->tx_batch_begin();
+
             for (i = 0; i < res; i++)
             {
                 priv = (struct epoll_priv *)epoll_evt[i].data.ptr;
                 if (priv->fn(priv) < 0)
+                {
+                    for (size_t n = 0; n < netif_count; n++)
+                        net_interface_set_ref->at(n)->tx_batch_end();
                     return -1;
+                }
             }
+
+            if (!t->tx_ring->is_doorbell_armed())
+                proc_tx_ring(t);
+
+            // Frames held back while a ring was full go in once it has room
+            if (!t->tx_deferred.empty())
+                flush_deferred_tx(t);
+
+            if (t->rx_ring && !t->rx_ring->is_doorbell_armed())
+                proc_rx_ring(t);
+
+            for (size_t n = 0; n < netif_count; n++)
+                net_interface_set_ref->at(n)->tx_batch_end();
+
+            timer_arm_next(t);
         }
         while (1);
         return 0;
@@ -377,7 +704,7 @@ namespace avdecc_lib
 
     void * system_layer2_multithreaded_callback::thread_fn(void *param)
     {
-        ((system_layer2_multithreaded_callback *)param)->proc_poll_loop();
+        instance->proc_poll_loop((struct engine_thread *)param);
 
         return 0;
     }
@@ -386,11 +713,17 @@ namespace avdecc_lib
     {
         int rc;
 
-        rc = pthread_create(&h_thread, NULL, &system_layer2_multithreaded_callback::thread_fn, (void *)this);
-        if (rc)
+        started = true;
+        notification_imp_ref->fix_capacity();
+
+        for (size_t i = 0; i < threads.size(); i++)
         {
-            printf("ERROR; return code from pthread_create() is %d\n", rc);
-            exit(-1);
+            rc = pthread_create(&threads[i]->h_thread, NULL, &system_layer2_multithreaded_callback::thread_fn, (void *)threads[i]);
+            if (rc)
+            {
+                printf("ERROR; return code from pthread_create() is %d\n", rc);
+                exit(-1);
+            }
         }
         return 0;
     }
@@ -30,10 +30,14 @@
 #pragma once
 
 #include <sys/epoll.h>
+#include <vector>
+#include <deque>
 
 #include "avdecc_lib_os.h"
 #include "system.h"
-#include "cmd_wait_mgr.h"
+#include "cmd_completion_imp.h"
+#include "mpsc_ring.h"
+#include "engine_shard.h"
 
 namespace avdecc_lib
 {
@@ -73,6 +77,16 @@ namespace avdecc_lib
          */
         int STDCALL get_last_resp_status();
 
+        /**
+         * Create a completion token for the next command sent with the notification id.
+         */
+        cmd_completion * STDCALL create_cmd_completion(void *notification_id);
+
+        /**
+         * Run the engine on count threads, with End Stations partitioned across them by Entity ID.
+         */
+        int STDCALL set_engine_shard_count(uint32_t count);
+
         /**
          * Start point of the system process, which calls the thread initialization function.
          */
@@ -86,59 +100,110 @@ namespace avdecc_lib
     private:
         static system_layer2_multithreaded_callback *instance;
         struct epoll_priv;
+        struct engine_thread;
         typedef int (* handler_fn) (struct epoll_priv * priv);
 
         struct epoll_priv
         {
             int fd;
             handler_fn fn;
+            size_t netif_index; // The network interface a receive entry polls
+            struct engine_thread *thread; // The engine thread polling the entry
+        };
+
+        enum useful_enums
+        {
+            POLL_COUNT = 2, // Timer and tx ring, plus one entry per network interface or the rx ring
+            TX_FRAME_SIZE = 2048,
+            TX_RING_SLOT_COUNT = 1024,
+            RX_RING_SLOT_COUNT = 1024,
+            TX_BATCH_COUNT = 64,
+            RX_BATCH_COUNT = 256,
+            MAX_ENGINE_SHARDS = 64
         };
 
         struct tx_data
         {
-            uint8_t *frame;
             size_t mem_buf_len;
             void *notification_id;
             uint32_t notification_flag;
+            uint8_t frame[TX_FRAME_SIZE];
         };
 
-        enum useful_enums
+        struct deferred_tx
+        {
+            struct engine_thread *target; // The engine thread whose tx ring the frame is for
+            struct tx_data data;
+        };
+
+        struct rx_data
+        {
+            size_t netif_index;
+            uint16_t length;
+            uint8_t frame[TX_FRAME_SIZE];
+        };
+
+        /**
+         * A thread running one engine shard. The first one receives on every network interface and
+         * steers the frames for End Stations of the other shards to their rx rings.
+         */
+        struct engine_thread
         {
-            PIPE_RD = 0,
-            PIPE_WR = 1,
-            POLL_COUNT = 3,
-            TIME_PERIOD_25_MILLISECONDS = 25
+            engine_shard *shard;
+            pthread_t h_thread;
+
+            mpsc_ring<struct tx_data> *tx_ring; // Frames queued for End Stations of the shard
+            int tx_doorbell; // eventfd signalled when the tx ring goes from empty to non-empty
+
+            mpsc_ring<struct rx_data> *rx_ring; // Frames steered to the shard, NULL for the first thread
+            int rx_doorbell; // eventfd signalled when the rx ring goes from empty to non-empty
+
+            int tick_timer; // One shot timerfd armed for the next timer wheel expiry
+            bool tick_timer_armed;
+            uint32_t tick_timer_expiry; // Timer wheel tick the timerfd is armed for
+
+            std::vector<void *> tick_active_ids; // Commands with completions inflight before a timer tick
+
+            std::deque<struct deferred_tx> tx_deferred; // Frames the thread queued while their tx ring was full, in queuing order
         };
 
-        pthread_t h_thread;
+        static thread_local struct engine_thread *current_thread; // The engine thread of the calling thread, if any
 
-        //int network_fd;
-        int tx_pipe[2];
-        //int tick_timer;
+        std::vector<struct engine_thread *> threads; // Indexed by engine shard
+        bool started;
 
-        sem_t *waiting_sem;
         sem_t *shutdown_sem;
 
         /*
         Events to process:
-        Rx packet - from socket
+        Rx packet - from socket, or from the rx ring of a shard
         Tx packet - from FIFO
         Timer tick - from timer
         */
 
-        cmd_wait_mgr *wait_mgr;
-        int resp_status_for_cmd;
+        cmd_completion_table *completions; // Commands application threads are waiting on
+        struct engine_thread * create_engine_thread(engine_shard *shard);
+        void destroy_engine_thread(struct engine_thread *t);
+        struct tx_data * reserve_tx(struct engine_thread *t, bool &is_deferred);
+        void commit_tx(struct engine_thread *t, struct tx_data *data, bool is_deferred);
+        void flush_deferred_tx(struct engine_thread *t);
+        int queue_tx_batch(void *notification_id, uint8_t *frame);
         int prep_evt_desc(int fd, handler_fn fn, struct epoll_priv *priv, struct epoll_event *ev);
         static int fn_timer_cb(struct epoll_priv *priv);
         static int fn_netif_cb(struct epoll_priv *priv);
         static int fn_tx_cb(struct epoll_priv *priv);
+        static int fn_rx_cb(struct epoll_priv *priv);
         int fn_timer(struct epoll_priv *priv);
         int fn_netif(struct epoll_priv *priv);
         int fn_tx(struct epoll_priv *priv);
-        int timer_start_interval(int timerfd);
+        int fn_rx(struct epoll_priv *priv);
+        int proc_tx_ring(struct engine_thread *t);
+        int proc_rx_ring(struct engine_thread *t);
+        void rx_frame_event(const uint8_t *frame, uint16_t length, size_t netif_index);
+        int timer_arm_next(struct engine_thread *t);
 
         void * proc_poll_thread(void * p);
-        int proc_poll_loop();
+        int proc_poll_loop(struct engine_thread *t);
         static void * thread_fn(void *param);
 
         int poll_single(void);
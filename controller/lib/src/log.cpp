@@ -29,6 +29,8 @@
 
 #include "avdecc_lib_os.h"
 #include <iostream>
+#include <stdio.h>
+#include <string.h>
 #include "enumeration.h"
 #include "log.h"
 
@@ -39,49 +41,311 @@ namespace avdecc_lib
     log::log()
     {
         log_level = LOGGING_LEVEL_ERROR;
-        read_index = 0;
-        write_index = 0;
         callback_func = default_log;
         user_obj = NULL;
+        record_callback_func = NULL;
+        record_user_obj = NULL;
         missed_log_event_cnt = 0;
+        start_time = std::chrono::steady_clock::now();
+        log_ring = new mpsc_ring<struct log_record>(LOG_BUF_COUNT);
     }
 
-    log::~log() {}
+    log::~log()
+    {
+        delete log_ring;
+    }
 
     void log::set_log_level(int32_t new_log_level)
     {
         log_level = new_log_level;
     }
 
-    void log::post_log_msg(int32_t level, const char *fmt,...)
+    void log::begin_record(struct log_record *r, int32_t level, const char *fmt)
+    {
+        r->level = level;
+        r->time_stamp_ms = (int32_t)std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start_time).count();
+        r->fmt = fmt;
+        r->arg_count = 0;
+        r->str_len = 0;
+    }
+
+    void log::add_int_arg(struct log_record *r, int64_t v)
+    {
+        if (r->arg_count < LOG_MAX_ARGS)
+        {
+            r->args[r->arg_count].type = log_arg::LOG_ARG_INT;
+            r->args[r->arg_count++].value.i = v;
+        }
+    }
+
+    void log::add_uint_arg(struct log_record *r, uint64_t v)
+    {
+        if (r->arg_count < LOG_MAX_ARGS)
+        {
+            r->args[r->arg_count].type = log_arg::LOG_ARG_UINT;
+            r->args[r->arg_count++].value.u = v;
+        }
+    }
+
+    void log::add_arg(struct log_record *r, double v)
+    {
+        if (r->arg_count < LOG_MAX_ARGS)
+        {
+            r->args[r->arg_count].type = log_arg::LOG_ARG_DOUBLE;
+            r->args[r->arg_count++].value.d = v;
+        }
+    }
+
+    void log::add_arg(struct log_record *r, const char *v)
     {
-        if (level <= log_level)
+        // Strings may not outlive the call, so they are copied and truncated to what fits in the record
+        if (r->arg_count < LOG_MAX_ARGS)
         {
-            va_list arglist;
-            uint32_t index;
+            size_t len;
+
+            if (!v)
+                v = "(null)";
+
+            len = strlen(v);
+            if (r->str_len + len + 1 > LOG_STR_BUF_SIZE)
+                len = (r->str_len < LOG_STR_BUF_SIZE) ? LOG_STR_BUF_SIZE - r->str_len - 1 : 0;
+
+            r->args[r->arg_count].type = log_arg::LOG_ARG_STRING;
+            r->args[r->arg_count++].value.str_offset = (r->str_len < LOG_STR_BUF_SIZE) ? r->str_len : LOG_STR_BUF_SIZE - 1;
+            if (r->str_len < LOG_STR_BUF_SIZE)
+            {
+                memcpy(&r->str_buf[r->str_len], v, len);
+                r->str_buf[r->str_len + len] = '\0';
+                r->str_len += (uint16_t)(len + 1);
+            }
+        }
+    }
+
+    void log::add_arg(struct log_record *r, const void *v)
+    {
+        if (r->arg_count < LOG_MAX_ARGS)
+        {
+            r->args[r->arg_count].type = log_arg::LOG_ARG_POINTER;
+            r->args[r->arg_count++].value.p = v;
+        }
+    }
+
+    void log::format_record(const struct log_record *r, char *msg, size_t msg_size)
+    {
+        const char *f = r->fmt;
+        size_t pos = 0;
+        uint16_t arg_index = 0;
+
+        while (*f && (pos + 1 < msg_size))
+        {
+            if (*f != '%')
+            {
+                msg[pos++] = *f++;
+                continue;
+            }
+
+            if (f[1] == '%')
+            {
+                msg[pos++] = '%';
+                f += 2;
+                continue;
+            }
+
+            // Copy the flags, width and precision, drop the length modifier and remember its size
+            char spec[32];
+            size_t spec_len = 0;
+            const char *start = f++;
+            int length = 0; // -2 hh, -1 h, 0 none, 1 l, 2 ll or wider
+
+            while (*f && strchr("-+ #0123456789.", *f) && ((size_t)(f - start) < sizeof(spec) - 8))
+                f++;
+            spec_len = f - start;
+            memcpy(spec, start, spec_len);
+
+            for (;;)
+            {
+                if (*f == 'h')
+                    length = (length == -1) ? -2 : -1;
+                else if (*f == 'l')
+                    length++;
+                else if ((*f == 'j') || (*f == 'z') || (*f == 't') || (*f == 'L') || (*f == 'q'))
+                    length = 2;
+                else
+                    break;
+                f++;
+            }
+
+            char conv = *f;
+            if (conv == '\0')
+                break;
+            f++;
 
-            if ((write_index - read_index) > LOG_BUF_COUNT)
+            if (arg_index >= r->arg_count)
             {
-                missed_log_event_cnt++;
-                return;
+                // Fewer arguments were passed than the format uses
+                int n = snprintf(msg + pos, msg_size - pos, "?");
+                pos += (n > 0) ? n : 0;
+                continue;
             }
-            index = InterlockedExchangeAdd(&write_index, 1);
-            va_start(arglist, fmt);
-            vsprintf_s(log_buf[index % LOG_BUF_COUNT].msg, sizeof(log_buf[0].msg), fmt, arglist);  // Write to log_buf using write_index
-            va_end(arglist);
-            log_buf[index % LOG_BUF_COUNT].level = level;
-            log_buf[index % LOG_BUF_COUNT].time_stamp_ms = 0;
-
-            post_log_event();
+
+            int64_t i = r->args[arg_index].value.i;
+            uint8_t type = r->args[arg_index].type;
+            int n = 0;
+
+            if (type == log_arg::LOG_ARG_DOUBLE)
+                i = (int64_t)r->args[arg_index].value.d;
+
+            switch (conv)
+            {
+                case 'd':
+                case 'i':
+                    if (length == -2)
+                        i = (signed char)i;
+                    else if (length == -1)
+                        i = (short)i;
+                    else if (length == 0)
+                        i = (int)i;
+                    spec[spec_len] = 'l';
+                    spec[spec_len + 1] = 'l';
+                    spec[spec_len + 2] = conv;
+                    spec[spec_len + 3] = '\0';
+                    n = snprintf(msg + pos, msg_size - pos, spec, (long long)i);
+                    break;
+
+                case 'u':
+                case 'x':
+                case 'X':
+                case 'o':
+                {
+                    uint64_t u = (uint64_t)i;
+
+                    if (length == -2)
+                        u = (unsigned char)u;
+                    else if (length == -1)
+                        u = (unsigned short)u;
+                    else if ((length == 0) || ((length == 1) && (sizeof(long) == 4)))
+                        u = (unsigned int)u;
+                    spec[spec_len] = 'l';
+                    spec[spec_len + 1] = 'l';
+                    spec[spec_len + 2] = conv;
+                    spec[spec_len + 3] = '\0';
+                    n = snprintf(msg + pos, msg_size - pos, spec, (unsigned long long)u);
+                    break;
+                }
+
+                case 'c':
+                    spec[spec_len] = 'c';
+                    spec[spec_len + 1] = '\0';
+                    n = snprintf(msg + pos, msg_size - pos, spec, (int)i);
+                    break;
+
+                case 'f':
+                case 'F':
+                case 'e':
+                case 'E':
+                case 'g':
+                case 'G':
+                case 'a':
+                case 'A':
+                {
+                    double d = (type == log_arg::LOG_ARG_DOUBLE) ? r->args[arg_index].value.d : (double)i;
+
+                    spec[spec_len] = conv;
+                    spec[spec_len + 1] = '\0';
+                    n = snprintf(msg + pos, msg_size - pos, spec, d);
+                    break;
+                }
+
+                case 's':
+                    spec[spec_len] = 's';
+                    spec[spec_len + 1] = '\0';
+                    n = snprintf(msg + pos, msg_size - pos, spec,
+                                 (type == log_arg::LOG_ARG_STRING) ? &r->str_buf[r->args[arg_index].value.str_offset] : "?");
+                    break;
+
+                case 'p':
+                    spec[spec_len] = 'p';
+                    spec[spec_len + 1] = '\0';
+                    n = snprintf(msg + pos, msg_size - pos, spec, r->args[arg_index].value.p);
+                    break;
+
+                default:
+                    n = snprintf(msg + pos, msg_size - pos, "?");
+                    break;
+            }
+
+            arg_index++;
+            if (n > 0)
+                pos += ((size_t)n < msg_size - pos) ? n : msg_size - pos - 1;
         }
+
+        msg[pos] = '\0';
+    }
+
+    void log::dispatch_log_records()
+    {
+        struct log_record *r;
+        struct log_arg args[LOG_MAX_ARGS];
+        char msg[LOG_MSG_SIZE];
+
+        do
+        {
+            void (*log_callback)(void *, int32_t, const char *, int32_t);
+            void *log_user_obj;
+            void (*record_callback)(void *, int32_t, const char *, const struct log_arg *, uint32_t, int32_t);
+            void *record_obj;
+
+            {
+                std::lock_guard<std::mutex> guard(callback_lock);
+                log_callback = callback_func;
+                log_user_obj = user_obj;
+                record_callback = record_callback_func;
+                record_obj = record_user_obj;
+            }
+
+            while ((r = log_ring->front()) != NULL)
+            {
+                if (record_callback)
+                {
+                    for (uint16_t i = 0; i < r->arg_count; i++)
+                    {
+                        args[i].type = (log_arg::log_arg_type)r->args[i].type;
+                        if (args[i].type == log_arg::LOG_ARG_STRING)
+                            args[i].value.s = &r->str_buf[r->args[i].value.str_offset];
+                        else if (args[i].type == log_arg::LOG_ARG_POINTER)
+                            args[i].value.p = r->args[i].value.p;
+                        else
+                            args[i].value.u = r->args[i].value.u;
+                    }
+                    record_callback(record_obj, r->level, r->fmt, args, r->arg_count, r->time_stamp_ms);
+                }
+
+                // Nobody wants the text, so do not format it
+                if (log_callback != default_log)
+                {
+                    format_record(r, msg, sizeof(msg));
+                    log_callback(log_user_obj, r->level, msg, r->time_stamp_ms);
+                }
+
+                log_ring->pop();
+            }
+        } while (!log_ring->arm_doorbell());
     }
 
     void log::set_log_callback(void (*new_log_callback) (void *, int32_t, const char *, int32_t), void *p)
     {
-        callback_func = new_log_callback;
+        std::lock_guard<std::mutex> guard(callback_lock);
+        callback_func = new_log_callback ? new_log_callback : default_log;
         user_obj = p;
     }
 
+    void log::set_log_record_callback(void (*new_record_callback) (void *, int32_t, const char *, const struct log_arg *, uint32_t, int32_t), void *p)
+    {
+        std::lock_guard<std::mutex> guard(callback_lock);
+        record_callback_func = new_record_callback;
+        record_user_obj = p;
+    }
+
     uint32_t log::missed_log_event_count()
     {
         return missed_log_event_cnt;
@@ -30,7 +30,12 @@
 #pragma once
 
 #include <stdint.h>
+#include <atomic>
+#include <chrono>
+#include <mutex>
 #include "build.h"
+#include "controller.h"
+#include "mpsc_ring.h"
 
 namespace avdecc_lib
 {
@@ -38,25 +43,54 @@ namespace avdecc_lib
     {
     protected:
         int32_t log_level; // The base log level for messages to be logged
-        uint32_t read_index;
-        uint32_t write_index;
         void (*callback_func)(void *, int32_t, const char *, int32_t);
         void *user_obj;
-        uint32_t missed_log_event_cnt; // The number of missed log that exceeds the log buffer count.
+        void (*record_callback_func)(void *, int32_t, const char *, const struct log_arg *, uint32_t, int32_t);
+        void *record_user_obj;
+        std::mutex callback_lock; // Keeps each callback and its user object consistent for the log thread
+        std::atomic<uint32_t> missed_log_event_cnt; // The number of missed log that exceeds the log buffer count.
+        std::chrono::steady_clock::time_point start_time; // Origin of the log message time stamps
 
         enum
         {
-            LOG_BUF_COUNT = 32
+            LOG_BUF_COUNT = 256,
+            LOG_MSG_SIZE = 256, // Maximum length of a formatted log message
+            LOG_MAX_ARGS = 8,
+            LOG_STR_BUF_SIZE = 256 // Space for copies of string arguments, as long as a whole formatted message
         };
 
-        struct log_data
+        /**
+         * A log message as posted by the engine, formatted on the log thread.
+         */
+        struct log_record
         {
             int32_t level;
-            char msg[256];
             int32_t time_stamp_ms;
+            const char *fmt;
+            uint16_t arg_count;
+            uint16_t str_len;
+            struct
+            {
+                uint8_t type; // log_arg::log_arg_type
+                union
+                {
+                    int64_t i;
+                    uint64_t u;
+                    double d;
+                    uint16_t str_offset; // Offset of the string copy in str_buf
+                    const void *p;
+                } value;
+            } args[LOG_MAX_ARGS];
+            char str_buf[LOG_STR_BUF_SIZE];
         };
 
-        struct log_data log_buf[LOG_BUF_COUNT];
+        mpsc_ring<struct log_record> *log_ring;
+
+        /**
+         * Call the log callbacks for every queued log record until the ring is drained. Called by the
+         * log thread every time post_log_event() wakes it up.
+         */
+        void dispatch_log_records();
 
     public:
         log();
@@ -69,9 +103,30 @@ namespace avdecc_lib
         void set_log_level(int32_t new_log_level);
 
         /**
-         * AVDECC LIB modules call this function for logging purposes.
+         * AVDECC LIB modules call this function for logging purposes. fmt must be a string literal. Only
+         * the format and the raw arguments are recorded here, the message is formatted on the log thread.
          */
-        void post_log_msg(int32_t log_level, const char *fmt,...);
+        template <typename... Args>
+        void post_log_msg(int32_t level, const char *fmt, Args... args)
+        {
+            if (level <= log_level)
+            {
+                struct log_record *r = log_ring->reserve();
+
+                if (!r)
+                {
+                    missed_log_event_cnt++;
+                    return;
+                }
+
+                begin_record(r, level, fmt);
+                int expand[] = {0, (add_arg(r, args), 0)...};
+                (void)expand;
+
+                if (log_ring->commit(r))
+                    post_log_event();
+            }
+        }
 
         /**
          * Release sempahore so that log callback function is called.
@@ -83,10 +138,35 @@ namespace avdecc_lib
          */
         void set_log_callback(void (*new_log_callback) (void *, int32_t, const char *, int32_t), void *);
 
+        /**
+         * Change the log record callback function, which receives unformatted log messages.
+         */
+        void set_log_record_callback(void (*new_record_callback) (void *, int32_t, const char *, const struct log_arg *, uint32_t, int32_t), void *);
+
         /**
          * Get the number of missed logs that exceeds the log buffer count.
          */
         virtual uint32_t missed_log_event_count();
+
+    private:
+        void begin_record(struct log_record *r, int32_t level, const char *fmt);
+
+        void add_arg(struct log_record *r, int v) { add_int_arg(r, v); }
+        void add_arg(struct log_record *r, long v) { add_int_arg(r, v); }
+        void add_arg(struct log_record *r, long long v) { add_int_arg(r, v); }
+        void add_arg(struct log_record *r, unsigned int v) { add_uint_arg(r, v); }
+        void add_arg(struct log_record *r, unsigned long v) { add_uint_arg(r, v); }
+        void add_arg(struct log_record *r, unsigned long long v) { add_uint_arg(r, v); }
+        void add_arg(struct log_record *r, double v);
+        void add_arg(struct log_record *r, const char *v);
+        void add_arg(struct log_record *r, const void *v);
+
+        void add_int_arg(struct log_record *r, int64_t v);
+        void add_uint_arg(struct log_record *r, uint64_t v);
+
+        /**
+         * Format a log record the way vsnprintf would have formatted the original arguments.
+         */
+        void format_record(const struct log_record *r, char *msg, size_t msg_size);
     };
 }
-
@@ -36,11 +36,13 @@
 #include "system_tx_queue.h"
 #include "acmp_controller_state_machine.h"
 #include "aecp_controller_state_machine.h"
+#include "memory_transfer_queue.h"
 #include "memory_object_descriptor_imp.h"
 
 namespace avdecc_lib
 {
     #define MEMORY_OBJECT_NUM_STRINGS 6
+    #define MEMORY_OBJECT_TRANSFER_WINDOW 8
     const char *memory_object_type_str[] =
     {
         "FIRMWARE_IMAGE",
@@ -167,6 +169,107 @@ namespace avdecc_lib
         return 0;
     }
 
+    int STDCALL memory_object_descriptor_imp::upload(void *notification_id, const uint8_t *data, size_t length, uint16_t window)
+    {
+        if (length == 0)
+        {
+            log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "Upload to memory object %d has no data", descriptor_index());
+            return -1;
+        }
+
+        return queue_upload(notification_id, std::make_shared<buffer_transfer_source>(data, length), window);
+    }
+
+    int STDCALL memory_object_descriptor_imp::upload_image(void *notification_id, memory_object_image *image, uint16_t window)
+    {
+        return queue_upload(notification_id, static_cast<memory_object_image_imp *>(image)->source(), window);
+    }
+
+    int memory_object_descriptor_imp::queue_upload(void *notification_id, const std::shared_ptr<transfer_source> &source, uint16_t window)
+    {
+        if ((memory_object_desc.maximum_length != 0) && (source->length() > memory_object_desc.maximum_length))
+        {
+            log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "Upload of %llu bytes does not fit memory object %d", source->length(), descriptor_index());
+            return -1;
+        }
+
+        struct memory_transfer *transfer = new memory_transfer();
+        transfer->notification_id = notification_id;
+        transfer->end_station = base_end_station_imp_ref;
+        transfer->desc_index = descriptor_index();
+        transfer->mode = JDKSAVDECC_AECP_AA_MODE_WRITE;
+        transfer->address = memory_object_desc.start_address;
+        transfer->length = source->length();
+        transfer->window = (window > 0) ? window : MEMORY_OBJECT_TRANSFER_WINDOW;
+        transfer->source = source;
+        transfer->verify_crc = false;
+        transfer->expected_crc = 0;
+
+        // The transfer goes through the transmit queue as a single frame holding the transfer pointer
+        system_queue_tx(notification_id, CMD_TRANSFER_WITH_NOTIFICATION, (uint8_t *)&transfer, sizeof(transfer));
+
+        return 0;
+    }
+
+    int STDCALL memory_object_descriptor_imp::download(void *notification_id, uint8_t *buffer, uint64_t length, const uint32_t *crc32, uint16_t window)
+    {
+        length = download_length(length);
+        if (length == 0)
+        {
+            return -1;
+        }
+
+        return queue_download(notification_id, std::make_shared<buffer_transfer_sink>(buffer, length), length, crc32, window);
+    }
+
+    int STDCALL memory_object_descriptor_imp::download_to_file(void *notification_id, const char *path, uint64_t length, const uint32_t *crc32, uint16_t window)
+    {
+        std::shared_ptr<file_transfer_sink> sink = std::make_shared<file_transfer_sink>();
+
+        length = download_length(length);
+        if ((length == 0) || (sink->open(path) < 0))
+        {
+            return -1;
+        }
+
+        return queue_download(notification_id, sink, length, crc32, window);
+    }
+
+    uint64_t memory_object_descriptor_imp::download_length(uint64_t length)
+    {
+        if (length == 0)
+        {
+            length = memory_object_desc.length;
+        }
+
+        if ((length == 0) || ((memory_object_desc.maximum_length != 0) && (length > memory_object_desc.maximum_length)))
+        {
+            log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "Download of %llu bytes does not fit memory object %d", length, descriptor_index());
+            return 0;
+        }
+
+        return length;
+    }
+
+    int memory_object_descriptor_imp::queue_download(void *notification_id, const std::shared_ptr<transfer_sink> &sink, uint64_t length, const uint32_t *crc32, uint16_t window)
+    {
+        struct memory_transfer *transfer = new memory_transfer();
+        transfer->notification_id = notification_id;
+        transfer->end_station = base_end_station_imp_ref;
+        transfer->desc_index = descriptor_index();
+        transfer->mode = JDKSAVDECC_AECP_AA_MODE_READ;
+        transfer->address = memory_object_desc.start_address;
+        transfer->length = length;
+        transfer->window = (window > 0) ? window : MEMORY_OBJECT_TRANSFER_WINDOW;
+        transfer->sink = sink;
+        transfer->verify_crc = (crc32 != NULL);
+        transfer->expected_crc = crc32 ? *crc32 : 0;
+
+        system_queue_tx(notification_id, CMD_TRANSFER_WITH_NOTIFICATION, (uint8_t *)&transfer, sizeof(transfer));
+
+        return 0;
+    }
+
     int memory_object_descriptor_imp::proc_start_operation_resp(void *&notification_id,
                                                                 const uint8_t *frame,
                                                                 size_t frame_len,
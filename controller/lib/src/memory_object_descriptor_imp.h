@@ -31,6 +31,7 @@
 
 #include "descriptor_base_imp.h"
 #include "memory_object_descriptor.h"
+#include "memory_object_image_imp.h"
 
 namespace avdecc_lib
 {
@@ -56,10 +57,28 @@ namespace avdecc_lib
         uint64_t STDCALL length();
         const char * STDCALL memory_object_type_to_str();
         int STDCALL start_operation_cmd(void *notification_id, uint16_t operation_type);
+        int STDCALL upload(void *notification_id, const uint8_t *data, size_t length, uint16_t window);
+        int STDCALL upload_image(void *notification_id, memory_object_image *image, uint16_t window);
+        int STDCALL download(void *notification_id, uint8_t *buffer, uint64_t length, const uint32_t *crc32, uint16_t window);
+        int STDCALL download_to_file(void *notification_id, const char *path, uint64_t length, const uint32_t *crc32, uint16_t window);
         int proc_start_operation_resp(void *&notification_id, const uint8_t *frame, size_t frame_len, int &status, uint16_t &operation_id, uint16_t &operation_type);
         int proc_operation_status_resp(void *&notification_id, const uint8_t *frame, size_t frame_len, int &status, uint16_t &operation_id, bool &is_operation_id_valid);
 
     private:
+        /**
+         * Hand an upload of the image to the system layer.
+         */
+        int queue_upload(void *notification_id, const std::shared_ptr<transfer_source> &source, uint16_t window);
+
+        /**
+         * \return The number of bytes a download reads, 0 if length is not valid for the memory object.
+         */
+        uint64_t download_length(uint64_t length);
+
+        /**
+         * Hand a download into the sink to the system layer.
+         */
+        int queue_download(void *notification_id, const std::shared_ptr<transfer_sink> &sink, uint64_t length, const uint32_t *crc32, uint16_t window);
     };
 }
 
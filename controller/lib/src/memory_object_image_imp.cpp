@@ -0,0 +1,274 @@
+/*
+ * Licensed under the MIT License (MIT)
+ *
+ * Copyright (c) 2014 AudioScience Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * memory_object_image_imp.cpp
+ *
+ * Memory object image implementation
+ */
+
+#include <cstring>
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#if defined __linux__ || defined __MACH__
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+#include "enumeration.h"
+#include "log_imp.h"
+#include "util.h"
+#include "memory_object_image_imp.h"
+
+namespace avdecc_lib
+{
+    uint64_t buffer_transfer_source::length() const
+    {
+        return image.size();
+    }
+
+    int buffer_transfer_source::read(uint64_t offset, uint8_t *buf, size_t len)
+    {
+        if (offset + len > image.size())
+        {
+            return -1;
+        }
+
+        memcpy(buf, &image[0] + offset, len);
+        return 0;
+    }
+
+    mapped_file_transfer_source::mapped_file_transfer_source()
+    {
+        map_base = NULL;
+        map_size = 0;
+    }
+
+#if defined __linux__ || defined __MACH__
+    mapped_file_transfer_source::~mapped_file_transfer_source()
+    {
+        if (map_base)
+        {
+            munmap(map_base, map_size);
+        }
+    }
+
+    int mapped_file_transfer_source::open(const char *path)
+    {
+        struct stat st;
+        int fd = ::open(path, O_RDONLY);
+
+        if (fd < 0)
+        {
+            log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "Unable to open memory object image %s, errno %d", path, errno);
+            return -1;
+        }
+
+        if ((fstat(fd, &st) < 0) || (st.st_size == 0))
+        {
+            log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "Memory object image %s is empty", path);
+            ::close(fd);
+            return -1;
+        }
+
+        void *p = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd); // The mapping keeps the file open
+        if (p == MAP_FAILED)
+        {
+            log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "Unable to map memory object image %s, errno %d", path, errno);
+            return -1;
+        }
+
+        map_base = (uint8_t *)p;
+        map_size = (size_t)st.st_size;
+
+        // Uploads read the image front to back
+        madvise(map_base, map_size, MADV_SEQUENTIAL);
+
+        return 0;
+    }
+#else
+    mapped_file_transfer_source::~mapped_file_transfer_source() {}
+
+    int mapped_file_transfer_source::open(const char *path)
+    {
+        std::ifstream is(path, std::ios::in | std::ios::binary);
+
+        if (!is.is_open())
+        {
+            log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "Unable to open memory object image %s", path);
+            return -1;
+        }
+
+        // Files are not mapped on this platform, read the whole image instead
+        image.assign(std::istreambuf_iterator<char>(is), std::istreambuf_iterator<char>());
+        if (image.empty())
+        {
+            log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "Memory object image %s is empty", path);
+            return -1;
+        }
+
+        map_base = &image[0];
+        map_size = image.size();
+
+        return 0;
+    }
+#endif
+
+    uint64_t mapped_file_transfer_source::length() const
+    {
+        return map_size;
+    }
+
+    int mapped_file_transfer_source::read(uint64_t offset, uint8_t *buf, size_t len)
+    {
+        if (offset + len > map_size)
+        {
+            return -1;
+        }
+
+        memcpy(buf, map_base + offset, len);
+        return 0;
+    }
+
+    uint64_t callback_transfer_source::length() const
+    {
+        return image_length;
+    }
+
+    int callback_transfer_source::read(uint64_t offset, uint8_t *buf, size_t len)
+    {
+        if (offset + len > image_length)
+        {
+            return -1;
+        }
+
+        return (read_callback(user_obj, offset, buf, len) < 0) ? -1 : 0;
+    }
+
+    int buffer_transfer_sink::write(uint64_t offset, const uint8_t *data, size_t len)
+    {
+        if (offset + len > buffer_length)
+        {
+            return -1;
+        }
+
+        memcpy(buffer + offset, data, len);
+        return 0;
+    }
+
+    int buffer_transfer_sink::crc32(uint64_t length, uint32_t &crc)
+    {
+        if (length > buffer_length)
+        {
+            return -1;
+        }
+
+        crc = utility::crc32(0, buffer, (size_t)length);
+        return 0;
+    }
+
+    int file_transfer_sink::open(const char *path)
+    {
+        file.open(path, std::ios::in | std::ios::out | std::ios::binary | std::ios::trunc);
+
+        if (!file.is_open())
+        {
+            log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "Unable to create memory object download file %s", path);
+            return -1;
+        }
+
+        return 0;
+    }
+
+    int file_transfer_sink::write(uint64_t offset, const uint8_t *data, size_t len)
+    {
+        file.seekp((std::streamoff)offset);
+        file.write((const char *)data, len);
+
+        return file.good() ? 0 : -1;
+    }
+
+    int file_transfer_sink::crc32(uint64_t length, uint32_t &crc)
+    {
+        uint8_t block[4096];
+
+        crc = 0;
+        file.flush();
+        file.seekg(0);
+
+        while (length > 0)
+        {
+            size_t len = (size_t)std::min<uint64_t>(length, sizeof(block));
+
+            if (!file.read((char *)block, len))
+            {
+                return -1;
+            }
+
+            crc = utility::crc32(crc, block, len);
+            length -= len;
+        }
+
+        return 0;
+    }
+
+    memory_object_image_imp::~memory_object_image_imp() {}
+
+    uint64_t STDCALL memory_object_image_imp::length()
+    {
+        return image_source->length();
+    }
+
+    void STDCALL memory_object_image_imp::release()
+    {
+        delete this;
+    }
+
+    memory_object_image * STDCALL map_memory_object_image(const char *path)
+    {
+        std::shared_ptr<mapped_file_transfer_source> source = std::make_shared<mapped_file_transfer_source>();
+
+        if (source->open(path) < 0)
+        {
+            return NULL;
+        }
+
+        return new memory_object_image_imp(source);
+    }
+
+    memory_object_image * STDCALL create_memory_object_image(uint64_t length,
+            int (*read_callback)(void *user_obj, uint64_t offset, uint8_t *buf, size_t len),
+            void *user_obj)
+    {
+        if ((length == 0) || !read_callback)
+        {
+            return NULL;
+        }
+
+        return new memory_object_image_imp(std::make_shared<callback_transfer_source>(length, read_callback, user_obj));
+    }
+}
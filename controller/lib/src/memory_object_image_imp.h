@@ -0,0 +1,198 @@
+/*
+ * Licensed under the MIT License (MIT)
+ *
+ * Copyright (c) 2014 AudioScience Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * memory_object_image_imp.h
+ *
+ * Memory object image implementation, and the sources and destinations of the bytes of memory object transfers.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <memory>
+#include <vector>
+#include <fstream>
+#include "memory_object_image.h"
+
+namespace avdecc_lib
+{
+    /**
+     * The image written by a memory object upload, shared by all the uploads of the same image.
+     * Only read on the engine thread.
+     */
+    class transfer_source
+    {
+    public:
+        virtual ~transfer_source() {}
+
+        /**
+         * \return The length of the image in bytes.
+         */
+        virtual uint64_t length() const = 0;
+
+        /**
+         * Copy len bytes of the image starting at offset into buf, the data of a command frame.
+         *
+         * \return 0 on success, -1 if the bytes cannot be read.
+         */
+        virtual int read(uint64_t offset, uint8_t *buf, size_t len) = 0;
+    };
+
+    /**
+     * An image copied into memory.
+     */
+    class buffer_transfer_source : public transfer_source
+    {
+    public:
+        buffer_transfer_source(const uint8_t *data, size_t length) : image(data, data + length) {}
+
+        uint64_t length() const;
+        int read(uint64_t offset, uint8_t *buf, size_t len);
+
+    private:
+        std::vector<uint8_t> image;
+    };
+
+    /**
+     * An image read straight from the pages of a mapped file.
+     */
+    class mapped_file_transfer_source : public transfer_source
+    {
+    public:
+        mapped_file_transfer_source();
+        ~mapped_file_transfer_source();
+
+        /**
+         * Map the file. \return 0 on success, -1 if the file cannot be opened, is empty or cannot be mapped.
+         */
+        int open(const char *path);
+
+        uint64_t length() const;
+        int read(uint64_t offset, uint8_t *buf, size_t len);
+
+    private:
+        uint8_t *map_base;
+        size_t map_size;
+        std::vector<uint8_t> image; // The file contents where files cannot be mapped
+    };
+
+    /**
+     * An image supplied by an application callback.
+     */
+    class callback_transfer_source : public transfer_source
+    {
+    public:
+        callback_transfer_source(uint64_t length,
+                                 int (*read_callback)(void *user_obj, uint64_t offset, uint8_t *buf, size_t len),
+                                 void *user_obj) : image_length(length), read_callback(read_callback), user_obj(user_obj) {}
+
+        uint64_t length() const;
+        int read(uint64_t offset, uint8_t *buf, size_t len);
+
+    private:
+        uint64_t image_length;
+        int (*read_callback)(void *user_obj, uint64_t offset, uint8_t *buf, size_t len);
+        void *user_obj;
+    };
+
+    /**
+     * Where the bytes read by a memory object download are stored. Responses arrive in any order, so
+     * each chunk is written at its own offset. Only written on the engine thread.
+     */
+    class transfer_sink
+    {
+    public:
+        virtual ~transfer_sink() {}
+
+        /**
+         * Store len bytes read from offset.
+         *
+         * \return 0 on success, -1 if the bytes cannot be stored.
+         */
+        virtual int write(uint64_t offset, const uint8_t *data, size_t len) = 0;
+
+        /**
+         * Compute the CRC-32 of the first length bytes stored.
+         *
+         * \return 0 on success, -1 if the bytes cannot be read back.
+         */
+        virtual int crc32(uint64_t length, uint32_t &crc) = 0;
+    };
+
+    /**
+     * A download into a buffer owned by the application.
+     */
+    class buffer_transfer_sink : public transfer_sink
+    {
+    public:
+        buffer_transfer_sink(uint8_t *buffer, uint64_t length) : buffer(buffer), buffer_length(length) {}
+
+        int write(uint64_t offset, const uint8_t *data, size_t len);
+        int crc32(uint64_t length, uint32_t &crc);
+
+    private:
+        uint8_t *buffer;
+        uint64_t buffer_length;
+    };
+
+    /**
+     * A download into a file.
+     */
+    class file_transfer_sink : public transfer_sink
+    {
+    public:
+        /**
+         * Create or truncate the file. \return 0 on success, -1 if the file cannot be created.
+         */
+        int open(const char *path);
+
+        int write(uint64_t offset, const uint8_t *data, size_t len);
+        int crc32(uint64_t length, uint32_t &crc);
+
+    private:
+        std::fstream file;
+    };
+
+    class memory_object_image_imp final : public memory_object_image
+    {
+    public:
+        memory_object_image_imp(const std::shared_ptr<transfer_source> &source) : image_source(source) {}
+        ~memory_object_image_imp();
+
+        uint64_t STDCALL length();
+        void STDCALL release();
+
+        /**
+         * \return The source of the image, kept by each upload until it ends.
+         */
+        const std::shared_ptr<transfer_source> &source() const
+        {
+            return image_source;
+        }
+
+    private:
+        std::shared_ptr<transfer_source> image_source;
+    };
+}
@@ -0,0 +1,361 @@
+/*
+ * Licensed under the MIT License (MIT)
+ *
+ * Copyright (c) 2014 AudioScience Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * memory_transfer_queue.cpp
+ *
+ * Memory object transfer queue implementation
+ */
+
+#include <algorithm>
+#include "net_interface_imp.h"
+#include "enumeration.h"
+#include "notification_imp.h"
+#include "log_imp.h"
+#include "end_station_imp.h"
+#include "aecp_controller_state_machine.h"
+#include "controller_imp.h"
+#include "memory_transfer_queue.h"
+
+#define AECP_MAX_CONTROL_DATA_LEN 524 // Largest AECPDU control_data_length allowed by 1722.1
+#define MEMORY_TRANSFER_CHUNK_LEN (AECP_MAX_CONTROL_DATA_LEN + JDKSAVDECC_COMMON_CONTROL_HEADER_LEN - \
+                                   JDKSAVDECC_AECPDU_AA_LEN - JDKSAVDECC_AECPDU_AA_TLV_LEN) // Data bytes in one TLV
+#define MEMORY_TRANSFER_MAX_RETRIES 3
+
+namespace avdecc_lib
+{
+    static inline const char *transfer_name(const struct memory_transfer *transfer)
+    {
+        return (transfer->mode == JDKSAVDECC_AECP_AA_MODE_READ) ? "Download" : "Upload";
+    }
+
+    memory_transfer_queue::memory_transfer_queue() {}
+
+    memory_transfer_queue::~memory_transfer_queue()
+    {
+        for (size_t i = 0; i < transfers.size(); i++)
+            delete transfers[i];
+    }
+
+    void memory_transfer_queue::add(struct memory_transfer *transfer)
+    {
+        transfer->start_time = std::chrono::steady_clock::now();
+        transfer->retry_count = 0;
+        transfer->chunk_count = (uint32_t)((transfer->length + MEMORY_TRANSFER_CHUNK_LEN - 1) / MEMORY_TRANSFER_CHUNK_LEN);
+        transfer->next_chunk = 0;
+        transfer->done_count = 0;
+        transfer->inflight = 0;
+        transfer->reported_percent = 0;
+        transfer->status = AEM_STATUS_SUCCESS;
+        transfers.push_back(transfer);
+
+        log_imp_ref->post_log_msg(LOGGING_LEVEL_DEBUG, "%s of %llu bytes with 0x%llx memory object %d in %u chunks",
+                                  transfer_name(transfer), transfer->length, transfer->end_station->entity_id(),
+                                  transfer->desc_index, transfer->chunk_count);
+
+        // A transfer that fails here is ended by the next tick, which completes its notification id with tick_status
+        fill(transfer);
+    }
+
+    bool memory_transfer_queue::has_notification_id(void *notification_id) const
+    {
+        for (size_t i = 0; i < transfers.size(); i++)
+        {
+            if (transfers[i]->notification_id == notification_id)
+                return true;
+        }
+
+        return false;
+    }
+
+    void memory_transfer_queue::rx_event(const uint8_t *frame, size_t frame_len, void *&notification_id, int &status)
+    {
+        if (outstanding.empty())
+            return;
+
+        if ((jdksavdecc_common_control_header_get_subtype(frame, ETHER_HDR_SIZE) != JDKSAVDECC_SUBTYPE_AECP) ||
+            (jdksavdecc_common_control_header_get_control_data(frame, ETHER_HDR_SIZE) != JDKSAVDECC_AECP_MESSAGE_TYPE_ADDRESS_ACCESS_RESPONSE))
+            return;
+
+        uint16_t seq_id = jdksavdecc_aecpdu_common_get_sequence_id(frame, ETHER_HDR_SIZE);
+        auto it = outstanding.find(seq_id);
+
+        // A response to a command that is still inflight is not ours, the AECP state machine removes ours first
+        if ((it == outstanding.end()) || aecp_controller_state_machine_ref->is_inflight_seq_id(seq_id))
+            return;
+
+        struct memory_transfer *transfer = it->second.transfer;
+        uint32_t chunk = it->second.send.chunk;
+        int resp_status = jdksavdecc_common_control_header_get_status(frame, ETHER_HDR_SIZE);
+
+        outstanding.erase(it);
+        transfer->inflight--;
+
+        if ((resp_status == AEM_STATUS_SUCCESS) && (transfer->mode == JDKSAVDECC_AECP_AA_MODE_READ))
+            resp_status = store_chunk(transfer, chunk, frame, frame_len);
+
+        if (resp_status == AEM_STATUS_SUCCESS)
+        {
+            transfer->done_count++;
+            if (transfer->done_count == transfer->chunk_count)
+            {
+                notification_id = transfer->notification_id;
+                status = verify(transfer);
+                finish(transfer, status);
+                return;
+            }
+
+            report_progress(transfer);
+            fill(transfer);
+        }
+        else
+        {
+            transfer->status = resp_status;
+        }
+
+        if (transfer->status != AEM_STATUS_SUCCESS)
+        {
+            notification_id = transfer->notification_id;
+            status = transfer->status;
+            finish(transfer, transfer->status);
+        }
+    }
+
+    void memory_transfer_queue::tick_event()
+    {
+        tick_ended.clear();
+
+        for (auto it = outstanding.begin(); it != outstanding.end();)
+        {
+            if (aecp_controller_state_machine_ref->is_inflight_seq_id(it->first))
+            {
+                ++it;
+                continue;
+            }
+
+            // The AECP state machine has given up on the command, resend just this chunk
+            struct memory_transfer *transfer = it->second.transfer;
+            struct memory_transfer::chunk_send send = it->second.send;
+
+            it = outstanding.erase(it);
+            transfer->inflight--;
+
+            if (++send.retries > MEMORY_TRANSFER_MAX_RETRIES)
+            {
+                log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "%s with 0x%llx failed, chunk %u timed out %d times",
+                                          transfer_name(transfer), transfer->end_station->entity_id(), send.chunk, send.retries);
+                transfer->status = AVDECC_LIB_STATUS_TICK_TIMEOUT;
+            }
+            else
+            {
+                transfer->retry_count++;
+                transfer->resend.push_back(send);
+            }
+        }
+
+        for (size_t i = 0; i < transfers.size();)
+        {
+            struct memory_transfer *transfer = transfers[i];
+
+            if (transfer->status == AEM_STATUS_SUCCESS)
+                fill(transfer);
+
+            if (transfer->status != AEM_STATUS_SUCCESS)
+            {
+                tick_ended[transfer->notification_id] = transfer->status;
+                finish(transfer, transfer->status);
+            }
+            else
+            {
+                i++;
+            }
+        }
+    }
+
+    bool memory_transfer_queue::tick_status(void *notification_id, int &status) const
+    {
+        auto it = tick_ended.find(notification_id);
+
+        if (it == tick_ended.end())
+            return false;
+
+        status = it->second;
+        return true;
+    }
+
+    void memory_transfer_queue::fill(struct memory_transfer *transfer)
+    {
+        while ((transfer->status == AEM_STATUS_SUCCESS) && (transfer->inflight < transfer->window))
+        {
+            struct memory_transfer::chunk_send send;
+
+            if (!transfer->resend.empty())
+            {
+                send = transfer->resend.front();
+                transfer->resend.pop_front();
+            }
+            else if (transfer->next_chunk < transfer->chunk_count)
+            {
+                send.chunk = transfer->next_chunk++;
+                send.retries = 0;
+            }
+            else
+            {
+                break;
+            }
+
+            if (send_chunk(transfer, send) < 0)
+                transfer->status = AVDECC_LIB_STATUS_INVALID;
+        }
+    }
+
+    int memory_transfer_queue::send_chunk(struct memory_transfer *transfer, struct memory_transfer::chunk_send send)
+    {
+        struct jdksavdecc_frame cmd_frame;
+        uint64_t offset = (uint64_t)send.chunk * MEMORY_TRANSFER_CHUNK_LEN;
+        size_t len = (size_t)std::min<uint64_t>(MEMORY_TRANSFER_CHUNK_LEN, transfer->length - offset);
+
+        if (transfer->end_station->aecp_aa_frame_init(&cmd_frame, transfer->mode, len, transfer->address + offset, NULL) < 0)
+            return -1;
+
+        // The image is read straight into the TLV data of the frame
+        if ((transfer->mode == JDKSAVDECC_AECP_AA_MODE_WRITE) &&
+            (transfer->source->read(offset, &cmd_frame.payload[ETHER_HDR_SIZE + JDKSAVDECC_AECPDU_AA_LEN + JDKSAVDECC_AECPDU_AA_TLV_LEN], len) < 0))
+        {
+            log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "Upload image read error at offset %llu", offset);
+            return -1;
+        }
+
+        controller_imp_ref->tx_packet_event(NULL, CMD_WITHOUT_NOTIFICATION, cmd_frame.payload, cmd_frame.length);
+
+        // The AECP state machine fills in the sequence id of the frame
+        uint16_t seq_id = jdksavdecc_aecpdu_common_get_sequence_id(cmd_frame.payload, ETHER_HDR_SIZE);
+        struct outstanding_chunk chunk;
+        chunk.transfer = transfer;
+        chunk.send = send;
+        outstanding[seq_id] = chunk;
+        transfer->inflight++;
+
+        return 0;
+    }
+
+    void memory_transfer_queue::report_progress(struct memory_transfer *transfer)
+    {
+        uint16_t percent = (uint16_t)((uint64_t)transfer->done_count * 1000 / transfer->chunk_count);
+
+        if (percent / 10 == transfer->reported_percent / 10)
+            return;
+
+        transfer->reported_percent = percent;
+        notification_imp_ref->post_notification_msg(MEMORY_OBJECT_TRANSFER_PROGRESS,
+                                                    transfer->end_station->entity_id(),
+                                                    JDKSAVDECC_AEM_COMMAND_OPERATION_STATUS,
+                                                    JDKSAVDECC_DESCRIPTOR_MEMORY_OBJECT,
+                                                    transfer->desc_index,
+                                                    percent,
+                                                    transfer->notification_id);
+    }
+
+    int memory_transfer_queue::store_chunk(struct memory_transfer *transfer, uint32_t chunk, const uint8_t *frame, size_t frame_len)
+    {
+        const size_t data_offset = ETHER_HDR_SIZE + JDKSAVDECC_AECPDU_AA_LEN + JDKSAVDECC_AECPDU_AA_TLV_LEN;
+        uint64_t offset = (uint64_t)chunk * MEMORY_TRANSFER_CHUNK_LEN;
+        size_t len = (size_t)std::min<uint64_t>(MEMORY_TRANSFER_CHUNK_LEN, transfer->length - offset);
+        uint16_t mode_length = jdksavdecc_aecp_aa_tlv_get_mode_length(frame, ETHER_HDR_SIZE + JDKSAVDECC_AECPDU_AA_LEN);
+
+        if ((jdksavdecc_aecp_aa_get_tlv_count(frame, ETHER_HDR_SIZE) != 1) ||
+            ((size_t)(mode_length & 0xFFF) != len) ||
+            (frame_len < data_offset + len))
+        {
+            log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "Download from 0x%llx got a malformed READ response for chunk %u",
+                                      transfer->end_station->entity_id(), chunk);
+            return AVDECC_LIB_STATUS_INVALID;
+        }
+
+        if (transfer->sink->write(offset, frame + data_offset, len) < 0)
+        {
+            log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "Download write error at offset %llu", offset);
+            return AVDECC_LIB_STATUS_INVALID;
+        }
+
+        return AEM_STATUS_SUCCESS;
+    }
+
+    int memory_transfer_queue::verify(struct memory_transfer *transfer)
+    {
+        uint32_t crc;
+
+        if ((transfer->mode != JDKSAVDECC_AECP_AA_MODE_READ) || !transfer->verify_crc)
+            return AEM_STATUS_SUCCESS;
+
+        if (transfer->sink->crc32(transfer->length, crc) < 0)
+        {
+            log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "Unable to read back the download for its CRC-32");
+            return AVDECC_LIB_STATUS_INVALID;
+        }
+
+        if (crc != transfer->expected_crc)
+        {
+            log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "Download from 0x%llx memory object %d has CRC-32 0x%08x, expected 0x%08x",
+                                      transfer->end_station->entity_id(), transfer->desc_index, crc, transfer->expected_crc);
+            return AVDECC_LIB_STATUS_CRC_MISMATCH;
+        }
+
+        return AEM_STATUS_SUCCESS;
+    }
+
+    void memory_transfer_queue::finish(struct memory_transfer *transfer, int status)
+    {
+        // Responses to the chunks still inflight no longer belong to a transfer
+        for (auto it = outstanding.begin(); it != outstanding.end();)
+        {
+            if (it->second.transfer == transfer)
+                it = outstanding.erase(it);
+            else
+                ++it;
+        }
+
+        transfers.erase(std::find(transfers.begin(), transfers.end(), transfer));
+
+        notification_imp_ref->post_notification_msg(MEMORY_OBJECT_TRANSFER_COMPLETED,
+                                                    transfer->end_station->entity_id(),
+                                                    JDKSAVDECC_AEM_COMMAND_OPERATION_STATUS,
+                                                    JDKSAVDECC_DESCRIPTOR_MEMORY_OBJECT,
+                                                    transfer->desc_index,
+                                                    status,
+                                                    transfer->notification_id);
+
+        uint64_t elapsed_ms = (uint64_t)std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() -
+                                                                                              transfer->start_time).count();
+        uint64_t done_bytes = std::min<uint64_t>((uint64_t)transfer->done_count * MEMORY_TRANSFER_CHUNK_LEN, transfer->length);
+
+        log_imp_ref->post_log_msg((status == AEM_STATUS_SUCCESS) ? LOGGING_LEVEL_NOTICE : LOGGING_LEVEL_ERROR,
+                                  "%s with 0x%llx memory object %d ended with status %d after %u of %u chunks, "
+                                  "%llu bytes in %llu ms (%llu kB/s), %u chunks resent",
+                                  transfer_name(transfer), transfer->end_station->entity_id(), transfer->desc_index, status,
+                                  transfer->done_count, transfer->chunk_count, done_bytes, elapsed_ms,
+                                  done_bytes / std::max<uint64_t>(elapsed_ms, 1), transfer->retry_count);
+
+        delete transfer;
+    }
+}
@@ -0,0 +1,157 @@
+/*
+ * Licensed under the MIT License (MIT)
+ *
+ * Copyright (c) 2014 AudioScience Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * memory_transfer_queue.h
+ *
+ * Memory object uploads and downloads, with a window of AECP Address Access commands inflight.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <deque>
+#include <memory>
+#include <vector>
+#include <unordered_map>
+#include <chrono>
+#include "memory_object_image_imp.h"
+
+namespace avdecc_lib
+{
+    class end_station_imp;
+
+    /**
+     * A memory object upload submitted with memory_object_descriptor::upload or upload_image, or a download
+     * submitted with download or download_to_file, handed to the system layer as a single queued frame.
+     */
+    struct memory_transfer
+    {
+        struct chunk_send
+        {
+            uint32_t chunk;
+            uint8_t retries; // Number of times the chunk has timed out
+        };
+
+        void *notification_id;
+        end_station_imp *end_station;
+        uint16_t desc_index; // The MEMORY_OBJECT descriptor transferred
+        unsigned mode; // JDKSAVDECC_AECP_AA_MODE_WRITE for uploads, JDKSAVDECC_AECP_AA_MODE_READ for downloads
+        uint64_t address; // Address of the first byte of the image
+        uint64_t length; // Length of the image in bytes
+        uint16_t window; // Maximum number of commands inflight
+        std::shared_ptr<transfer_source> source; // Where an upload reads the image from
+        std::shared_ptr<transfer_sink> sink; // Where a download stores the image
+        bool verify_crc; // Whether a download is checked against expected_crc
+        uint32_t expected_crc;
+
+        std::chrono::steady_clock::time_point start_time;
+        uint32_t retry_count; // Chunks resent after a timeout
+        uint32_t chunk_count;
+        uint32_t next_chunk; // First chunk not sent yet
+        uint32_t done_count; // Chunks acknowledged
+        uint16_t inflight;
+        uint16_t reported_percent; // Last percent_complete notified, in tenths of a percent
+        int status; // Why the transfer failed, AEM_STATUS_SUCCESS while it is running
+        std::deque<struct chunk_send> resend; // Chunks to send again after a timeout
+    };
+
+    class memory_transfer_queue
+    {
+    public:
+        memory_transfer_queue();
+
+        ~memory_transfer_queue();
+
+        /**
+         * Take ownership of the transfer and send the first window of commands.
+         */
+        void add(struct memory_transfer *transfer);
+
+        /**
+         * \return True if a transfer with the notification id has not finished.
+         */
+        bool has_notification_id(void *notification_id) const;
+
+        /**
+         * Account for a received ADDRESS_ACCESS response, storing the data of a download. If it finishes
+         * a transfer, notification_id and status are set to those of the transfer.
+         */
+        void rx_event(const uint8_t *frame, size_t frame_len, void *&notification_id, int &status);
+
+        /**
+         * Resend the chunks of commands that have timed out and end transfers that have failed.
+         */
+        void tick_event();
+
+        /**
+         * \return True if a transfer with the notification id was ended by the last tick_event, with status
+         *         set to the status it ended with.
+         */
+        bool tick_status(void *notification_id, int &status) const;
+
+    private:
+        struct outstanding_chunk
+        {
+            struct memory_transfer *transfer;
+            struct memory_transfer::chunk_send send;
+        };
+
+        std::vector<struct memory_transfer *> transfers;
+        std::unordered_map<uint16_t, struct outstanding_chunk> outstanding; // Chunks inflight, by AECP sequence id
+        std::unordered_map<void *, int> tick_ended; // Status of the transfers ended by the last tick_event, by notification id
+
+        /**
+         * Send chunks of the transfer while it has free slots in its window.
+         */
+        void fill(struct memory_transfer *transfer);
+
+        /**
+         * Send one chunk. \return 0 on success, -1 if the transfer has failed.
+         */
+        int send_chunk(struct memory_transfer *transfer, struct memory_transfer::chunk_send send);
+
+        /**
+         * Notify the percent complete of the transfer if it has moved on by at least one percent.
+         */
+        void report_progress(struct memory_transfer *transfer);
+
+        /**
+         * Store the data of a READ response for a chunk of a download.
+         *
+         * \return AEM_STATUS_SUCCESS, or the status the download fails with.
+         */
+        int store_chunk(struct memory_transfer *transfer, uint32_t chunk, const uint8_t *frame, size_t frame_len);
+
+        /**
+         * \return The status of a transfer that has all its chunks, after checking the CRC-32 of a download.
+         */
+        int verify(struct memory_transfer *transfer);
+
+        /**
+         * Notify the end of the transfer and delete it.
+         */
+        void finish(struct memory_transfer *transfer, int status);
+    };
+}
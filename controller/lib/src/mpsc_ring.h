@@ -0,0 +1,236 @@
+/*
+ * Licensed under the MIT License (MIT)
+ *
+ * Copyright (c) 2014 AudioScience Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * mpsc_ring.h
+ *
+ * Bounded lock-free multiple producer, single consumer ring of fixed size slots.
+ *
+ * Producers claim a slot with reserve(), fill it in place and publish it with commit().
+ * The consumer walks published slots with front() and pop().  The ring also carries a
+ * doorbell flag so that the consumer only needs to be woken when the ring goes from
+ * empty to non-empty: the consumer arms the doorbell once it has drained the ring and
+ * the first producer to commit afterwards is told to ring it.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <atomic>
+
+namespace avdecc_lib
+{
+    template <typename T>
+    class mpsc_ring
+    {
+    public:
+        enum mpsc_ring_consts
+        {
+            CACHE_LINE_SIZE = 64
+        };
+
+        /**
+         * Constructor for the ring.  The slot count is rounded up to a power of two.
+         */
+        mpsc_ring(size_t count) : slot_mem(NULL), slots(NULL), mask(0), enqueue_pos(0), dequeue_pos(0), doorbell_armed(true)
+        {
+            size_t slot_count = 2;
+
+            while (slot_count < count)
+                slot_count <<= 1;
+
+            mask = slot_count - 1;
+
+            /* Slots are aligned on a cache line so that adjacent producers do not share one */
+            slot_mem = new uint8_t[slot_count * sizeof(struct slot) + CACHE_LINE_SIZE];
+            slots = reinterpret_cast<struct slot *>((reinterpret_cast<uintptr_t>(slot_mem) + CACHE_LINE_SIZE - 1) &
+                                                    ~(static_cast<uintptr_t>(CACHE_LINE_SIZE) - 1));
+
+            for (size_t i = 0; i < slot_count; i++)
+            {
+                new (&slots[i]) struct slot();
+                slots[i].seq.store(i, std::memory_order_relaxed);
+            }
+        }
+
+        ~mpsc_ring()
+        {
+            for (size_t i = 0; i <= mask; i++)
+                slots[i].~slot();
+
+            delete[] slot_mem;
+        }
+
+        /**
+         * \return The number of slots in the ring.
+         */
+        inline size_t capacity() const
+        {
+            return mask + 1;
+        }
+
+        /**
+         * Claim the next free slot for writing.  May be called from any thread.
+         *
+         * \return A pointer to the slot data or NULL if the ring is full.
+         */
+        T * reserve()
+        {
+            size_t pos = enqueue_pos.load(std::memory_order_relaxed);
+
+            for (;;)
+            {
+                struct slot *s = &slots[pos & mask];
+                size_t seq = s->seq.load(std::memory_order_acquire);
+                intptr_t diff = (intptr_t)seq - (intptr_t)pos;
+
+                if (diff == 0)
+                {
+                    if (enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    {
+                        s->pos = pos;
+                        return &s->data;
+                    }
+                }
+                else if (diff < 0)
+                {
+                    return NULL;
+                }
+                else
+                {
+                    pos = enqueue_pos.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+        /**
+         * Publish a slot previously returned by reserve().
+         *
+         * \return True if the consumer had armed the doorbell and needs to be woken up.
+         */
+        bool commit(T *data)
+        {
+            struct slot *s = slot_from_data(data);
+
+            s->seq.store(s->pos + 1, std::memory_order_release);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+
+            return doorbell_armed.load(std::memory_order_relaxed) &&
+                   doorbell_armed.exchange(false, std::memory_order_acq_rel);
+        }
+
+        /**
+         * Consumer only.
+         *
+         * \return The oldest published slot or NULL if there is none.
+         */
+        T * front()
+        {
+            struct slot *s = &slots[dequeue_pos & mask];
+
+            if (s->seq.load(std::memory_order_acquire) != dequeue_pos + 1)
+                return NULL;
+
+            return &s->data;
+        }
+
+        /**
+         * Consumer only.  Release the slot returned by front() back to the producers.
+         */
+        void pop()
+        {
+            struct slot *s = &slots[dequeue_pos & mask];
+
+            s->seq.store(dequeue_pos + mask + 1, std::memory_order_release);
+            dequeue_pos++;
+        }
+
+        /**
+         * Consumer only.  Arm the doorbell after draining the ring.
+         *
+         * \return True if the ring is still empty and the consumer may sleep until the doorbell is
+         *         rung, false if slots were published meanwhile and the consumer should keep draining.
+         */
+        bool arm_doorbell()
+        {
+            doorbell_armed.store(true, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+
+            if (front() == NULL)
+                return true;
+
+            /* A producer slipped in before the doorbell was armed, so it will not ring it */
+            doorbell_armed.store(false, std::memory_order_relaxed);
+            return false;
+        }
+
+        /**
+         * \return True if the consumer is waiting on the doorbell.
+         */
+        inline bool is_doorbell_armed() const
+        {
+            return doorbell_armed.load(std::memory_order_relaxed);
+        }
+
+    private:
+        struct slot_header
+        {
+            std::atomic<size_t> seq;
+            size_t pos;
+        };
+
+        struct slot_body
+        {
+            struct slot_header hdr;
+            T data;
+        };
+
+        struct slot
+        {
+            std::atomic<size_t> seq;
+            size_t pos;
+            T data;
+            uint8_t pad[CACHE_LINE_SIZE - sizeof(struct slot_body) % CACHE_LINE_SIZE];
+        };
+
+        static inline struct slot * slot_from_data(T *data)
+        {
+            return reinterpret_cast<struct slot *>(reinterpret_cast<uint8_t *>(data) - offsetof(struct slot, data));
+        }
+
+        uint8_t *slot_mem;
+        struct slot *slots;
+        size_t mask;
+
+        /* Producer, consumer and doorbell state each live on their own cache line */
+        uint8_t pad0[CACHE_LINE_SIZE];
+        std::atomic<size_t> enqueue_pos;
+        uint8_t pad1[CACHE_LINE_SIZE - sizeof(std::atomic<size_t>)];
+        size_t dequeue_pos;
+        uint8_t pad2[CACHE_LINE_SIZE - sizeof(size_t)];
+        std::atomic<bool> doorbell_armed;
+        uint8_t pad3[CACHE_LINE_SIZE - sizeof(std::atomic<bool>)];
+    };
+}
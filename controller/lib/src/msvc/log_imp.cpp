@@ -78,16 +78,7 @@ namespace avdecc_lib
 
             if (dwEvent == (WAIT_OBJECT_0 + LOG_EVENT))
             {
-                if((write_index - read_index) > 0)
-                {
-                    callback_func(user_obj,
-                                  log_buf[read_index % LOG_BUF_COUNT].level,
-                                  log_buf[read_index % LOG_BUF_COUNT].msg,
-                                  log_buf[read_index % LOG_BUF_COUNT].time_stamp_ms
-                                 ); // Call callback function
-
-                    read_index++;
-                }
+                dispatch_log_records();
             }
             else
             {
@@ -77,19 +77,7 @@ namespace avdecc_lib
 
             if(dwEvent == (WAIT_OBJECT_0 + NOTIFICATION_EVENT))
             {
-                if((write_index - read_index) > 0)
-                {
-                    notification_callback(user_obj,
-                                          notification_buf[read_index % NOTIFICATION_BUF_COUNT].notification_type,
-                                          notification_buf[read_index % NOTIFICATION_BUF_COUNT].entity_id,
-                                          notification_buf[read_index % NOTIFICATION_BUF_COUNT].cmd_type,
-                                          notification_buf[read_index % NOTIFICATION_BUF_COUNT].desc_type,
-                                          notification_buf[read_index % NOTIFICATION_BUF_COUNT].desc_index,
-                                          notification_buf[read_index % NOTIFICATION_BUF_COUNT].cmd_status,
-                                          notification_buf[read_index % NOTIFICATION_BUF_COUNT].notification_id
-                                         ); // Call callback function
-                    read_index++;
-                }
+                dispatch_notifications();
             }
             else
             {
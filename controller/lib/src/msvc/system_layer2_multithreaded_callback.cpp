@@ -32,6 +32,7 @@
 #include "enumeration.h"
 #include "notification_imp.h"
 #include "log_imp.h"
+#include "net_interface_set.h"
 #include "end_station_imp.h"
 #include "controller_imp.h"
 #include "system_message_queue.h"
@@ -65,7 +66,7 @@ namespace avdecc_lib
 
     system_layer2_multithreaded_callback::system_layer2_multithreaded_callback(net_interface *netif, controller *controller_obj)
     {
-        wait_mgr = new cmd_wait_mgr();
+        completions = new cmd_completion_table();
 
         netif_obj_in_system = netif;
         controller_obj_in_system = dynamic_cast<controller_imp *>(controller_obj);
@@ -81,6 +82,7 @@ namespace avdecc_lib
     {
         delete poll_rx.rx_queue;
         delete poll_tx.tx_queue;
+        delete completions;
     }
 
     void STDCALL system_layer2_multithreaded_callback::destroy()
@@ -106,36 +108,42 @@ namespace avdecc_lib
         memcpy(thread_data.frame, frame, frame_len);
         thread_data.notification_id = notification_id;
         thread_data.notification_flag = notification_flag;
+        // Mark the command as sent before the poll thread can see it, so that its response cannot be missed
+        cmd_completion_imp *primed = completions->cmd_queued(notification_id, notification_flag);
+
         poll_tx.tx_queue->queue_push(&thread_data);
 
-        /**
-         * Check for conditions that cause wait for completion.
-         */
-        if ( wait_mgr->primed_state() &&
-             wait_mgr->match_id(notification_id) &&
-             (notification_flag == CMD_WITH_NOTIFICATION))
-        {
-            int status = 0;
-
-            status = wait_mgr->set_active_state();
-            assert(status == 0);
-            WaitForSingleObject(waiting_sem, INFINITE);
-            resp_status_for_cmd = wait_mgr->get_completion_status();
-            status = wait_mgr->set_idle_state();
-            assert(status == 0);
-        }
+        // Block until the command completes if the calling thread primed it with set_wait_for_next_cmd
+        if (primed)
+            completions->wait_for_primed(primed);
         return 0;
     }
 
     int STDCALL system_layer2_multithreaded_callback::set_wait_for_next_cmd(void * id)
     {
-        wait_mgr->set_primed_state(id);
+        completions->set_wait_for_next_cmd(id);
         return 0;
     }
 
     int STDCALL system_layer2_multithreaded_callback::get_last_resp_status()
     {
-        return resp_status_for_cmd;
+        return completions->get_last_resp_status();
+    }
+
+    cmd_completion * STDCALL system_layer2_multithreaded_callback::create_cmd_completion(void *notification_id)
+    {
+        return completions->create(notification_id);
+    }
+
+    int STDCALL system_layer2_multithreaded_callback::set_engine_shard_count(uint32_t count)
+    {
+        if (count != 1)
+        {
+            log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "Only one engine shard is supported on this platform");
+            return -1;
+        }
+
+        return 0;
     }
 
     DWORD WINAPI system_layer2_multithreaded_callback::proc_wpcap_thread(LPVOID lpParam)
@@ -207,6 +215,12 @@ namespace avdecc_lib
 
     int STDCALL system_layer2_multithreaded_callback::process_start()
     {
+        if (net_interface_set_ref->count() > 1)
+        {
+            log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "Only the first network interface is received on");
+        }
+
+        notification_imp_ref->fix_capacity();
         if (init_wpcap_thread() < 0 || init_poll_thread() < 0)
         {
             log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "init_polling error");
@@ -243,8 +257,6 @@ namespace avdecc_lib
 
         poll_events_array[KILL_ALL] = CreateEvent(NULL, FALSE, FALSE, NULL);
 
-        waiting_sem = CreateSemaphore(NULL, 0, 32767, NULL);
-
         return 0;
     }
 
@@ -299,19 +311,17 @@ namespace avdecc_lib
                             thread_data.frame_len,
                             rx_status,
                             operation_id,
-                            is_operation_id_valid);
+                            is_operation_id_valid,
+                            0);
 
                     if (
-                        wait_mgr->active_state() &&
                         is_notification_id_valid &&
-                        wait_mgr->match_id(thread_data.notification_id) &&
-                        !controller_obj_in_system->is_inflight_cmd_with_notification_id(wait_mgr->get_notify_id()) &&
-                        !controller_obj_in_system->is_active_operation_with_notification_id(wait_mgr->get_notify_id())
+                        completions->has_active() &&
+                        !controller_obj_in_system->is_inflight_cmd_with_notification_id(thread_data.notification_id) &&
+                        !controller_obj_in_system->is_active_operation_with_notification_id(thread_data.notification_id)
                     )
                     {
-                        int status = wait_mgr->set_completion_status(rx_status);
-                        assert(status == 0);
-                        ReleaseSemaphore(waiting_sem, 1, NULL);
+                        completions->complete(thread_data.notification_id, rx_status);
                     }
                     delete[] thread_data.frame;
                 }
@@ -334,29 +344,32 @@ namespace avdecc_lib
 
         if (tick_timer.timeout()) // Check tick timeout
         {
-            bool notification_id_incomplete = false;
-
-            if (wait_mgr->active_state())
+            // Commands with completions that are inflight before the timer tick update and no longer
+            // inflight after it have been timed out, so complete them.
+            tick_active_ids.clear();
+            if (completions->has_active())
             {
-                if (controller_obj_in_system->is_inflight_cmd_with_notification_id(wait_mgr->get_notify_id()) ||
-                    controller_obj_in_system->is_active_operation_with_notification_id(wait_mgr->get_notify_id()))
-                    notification_id_incomplete = true;
+                size_t inflight_count = 0;
+
+                completions->get_active_ids(tick_active_ids);
+                for (size_t i = 0; i < tick_active_ids.size(); i++)
+                {
+                    if (controller_obj_in_system->is_inflight_cmd_with_notification_id(tick_active_ids[i]) ||
+                        controller_obj_in_system->is_active_operation_with_notification_id(tick_active_ids[i]))
+                        tick_active_ids[inflight_count++] = tick_active_ids[i];
+                }
+                tick_active_ids.resize(inflight_count);
             }
 
-            // If waiting on a command to complete and the command was "inflight" prior to calling the
-            // timer tick update (ie notification_id_incomplete == true) AND after calling the timer tick
-            // update the command is no longer "inflight", timeout processing has removed it, so signal the
-            // waiting app thread.
             controller_obj_in_system->time_tick_event();
 
-            bool is_timeout_for_waiting_notify_id = wait_mgr->active_state() && notification_id_incomplete &&
-                                                    !controller_obj_in_system->is_inflight_cmd_with_notification_id(wait_mgr->get_notify_id()) &&
-                                                    !controller_obj_in_system->is_active_operation_with_notification_id(wait_mgr->get_notify_id());
-            if (is_timeout_for_waiting_notify_id)
+            for (size_t i = 0; i < tick_active_ids.size(); i++)
             {
-                int status = wait_mgr->set_completion_status(AVDECC_LIB_STATUS_TICK_TIMEOUT);
-                assert(status == 0);
-                ReleaseSemaphore(waiting_sem, 1, NULL);
+                if (!controller_obj_in_system->is_inflight_cmd_with_notification_id(tick_active_ids[i]) &&
+                    !controller_obj_in_system->is_active_operation_with_notification_id(tick_active_ids[i]))
+                {
+                    completions->complete(tick_active_ids[i], controller_obj_in_system->tick_completion_status(tick_active_ids[i]));
+                }
             }
 
             tick_timer.start(NETIF_READ_TIMEOUT_MS);
@@ -31,7 +31,8 @@
 
 #include "system.h"
 #include "timer.h"
-#include "cmd_wait_mgr.h"
+#include <vector>
+#include "cmd_completion_imp.h"
 
 namespace avdecc_lib
 {
@@ -75,10 +76,9 @@ namespace avdecc_lib
         struct msg_poll poll_tx;
         struct thread_creation poll_thread;
         HANDLE poll_events_array[NUM_OF_EVENTS];
-        HANDLE waiting_sem;
 
-        cmd_wait_mgr *wait_mgr;
-        int resp_status_for_cmd;
+        cmd_completion_table *completions; // Commands application threads are waiting on
+        std::vector<void *> tick_active_ids; // Commands with completions inflight before a timer tick
         timer tick_timer; // A tick timer that is always running
 
     public:
@@ -109,6 +109,16 @@ namespace avdecc_lib
          */
         int STDCALL get_last_resp_status();
 
+        /**
+         * Create a completion token for the next command sent with the notification id.
+         */
+        cmd_completion * STDCALL create_cmd_completion(void *notification_id);
+
+        /**
+         * Only one engine shard is supported on this platform.
+         */
+        int STDCALL set_engine_shard_count(uint32_t count);
+
         /**
          * Start point of the system process, which calls the thread initialization function.
          */
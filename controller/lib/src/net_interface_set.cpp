@@ -0,0 +1,186 @@
+/*
+ * Licensed under the MIT License (MIT)
+ *
+ * Copyright (c) 2014 AudioScience Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * net_interface_set.cpp
+ *
+ * Network interface set implementation
+ */
+
+#include "net_interface_imp.h"
+#include "enumeration.h"
+#include "log_imp.h"
+#include "util.h"
+#include "timer_wheel.h"
+#include "jdksavdecc.h"
+#include "net_interface_set.h"
+
+namespace avdecc_lib
+{
+    net_interface_set *net_interface_set_ref = new net_interface_set();
+
+    net_interface_set::net_interface_set() {}
+
+    net_interface_set::~net_interface_set() {}
+
+    int net_interface_set::add(net_interface_imp *netif)
+    {
+        for (size_t i = 0; i < netifs.size(); i++)
+        {
+            if (netifs[i]->mac_addr() == netif->mac_addr())
+            {
+                log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "Network interface %s is already in use",
+                                          utility::end_station_mac_to_string(netif->mac_addr()));
+                return -1;
+            }
+        }
+
+        netifs.push_back(netif);
+        return (int)(netifs.size() - 1);
+    }
+
+    bool net_interface_set::is_local_mac(size_t netif_index, uint64_t mac) const
+    {
+        return netifs[netif_index]->mac_addr() == mac;
+    }
+
+    bool net_interface_set::adp_event(uint64_t entity_id, size_t netif_index, uint32_t valid_time_ms)
+    {
+        uint32_t now = timer_wheel_ref->now();
+        std::lock_guard<std::mutex> guard(affinity_lock);
+        auto it = affinities.find(entity_id);
+
+        if (it == affinities.end())
+        {
+            struct entity_affinity affinity = {netif_index, now};
+            affinities[entity_id] = affinity;
+            return true;
+        }
+
+        if (it->second.netif_index == netif_index)
+        {
+            it->second.last_seen = now;
+            return false;
+        }
+
+        // Still advertising on its own interface, the other network only carries a redundant copy
+        if ((uint32_t)(now - it->second.last_seen) <= valid_time_ms)
+            return false;
+
+        log_imp_ref->post_log_msg(LOGGING_LEVEL_NOTICE, "Entity 0x%llx moved from network interface %d to %d",
+                                  entity_id, (int)it->second.netif_index, (int)netif_index);
+        it->second.netif_index = netif_index;
+        it->second.last_seen = now;
+        return true;
+    }
+
+    int net_interface_set::entity_net_interface(uint64_t entity_id) const
+    {
+        std::lock_guard<std::mutex> guard(affinity_lock);
+        auto it = affinities.find(entity_id);
+
+        return (it == affinities.end()) ? -1 : (int)it->second.netif_index;
+    }
+
+    void net_interface_set::remove_entity(uint64_t entity_id)
+    {
+        std::lock_guard<std::mutex> guard(affinity_lock);
+        affinities.erase(entity_id);
+    }
+
+    void net_interface_set::clear()
+    {
+        std::lock_guard<std::mutex> guard(affinity_lock);
+        affinities.clear();
+        netifs.clear();
+    }
+
+    uint64_t net_interface_set::target_entity_id(const uint8_t *frame, uint16_t mem_buf_len) const
+    {
+        struct jdksavdecc_eui64 entity_id;
+
+        if (mem_buf_len < ETHER_HDR_SIZE + JDKSAVDECC_COMMON_CONTROL_HEADER_LEN)
+            return 0;
+
+        switch (jdksavdecc_common_control_header_get_subtype(frame, ETHER_HDR_SIZE))
+        {
+            case JDKSAVDECC_SUBTYPE_AECP:
+                entity_id = jdksavdecc_common_control_header_get_stream_id(frame, ETHER_HDR_SIZE);
+                break;
+
+            case JDKSAVDECC_SUBTYPE_ACMP:
+            {
+                if (mem_buf_len < ETHER_HDR_SIZE + JDKSAVDECC_ACMPDU_LEN)
+                    return 0;
+
+                uint32_t msg_type = jdksavdecc_common_control_header_get_control_data(frame, ETHER_HDR_SIZE);
+                if ((msg_type == JDKSAVDECC_ACMP_MESSAGE_TYPE_GET_TX_STATE_COMMAND) ||
+                    (msg_type == JDKSAVDECC_ACMP_MESSAGE_TYPE_GET_TX_CONNECTION_COMMAND))
+                {
+                    entity_id = jdksavdecc_acmpdu_get_talker_entity_id(frame, ETHER_HDR_SIZE);
+                }
+                else
+                {
+                    entity_id = jdksavdecc_acmpdu_get_listener_entity_id(frame, ETHER_HDR_SIZE);
+                }
+                break;
+            }
+
+            default:
+                return 0;
+        }
+
+        return jdksavdecc_eui64_convert_to_uint64(&entity_id);
+    }
+
+    int net_interface_set::send_frame(uint8_t *frame, uint16_t mem_buf_len)
+    {
+        if (netifs.size() == 1)
+            return send_on(0, frame, mem_buf_len);
+
+        uint64_t entity_id = target_entity_id(frame, mem_buf_len);
+        if (entity_id != 0)
+        {
+            int netif_index = entity_net_interface(entity_id);
+            if (netif_index >= 0)
+                return send_on((size_t)netif_index, frame, mem_buf_len);
+        }
+
+        int send_frame_returned = -1;
+        for (size_t i = 0; i < netifs.size(); i++)
+        {
+            if (send_on(i, frame, mem_buf_len) >= 0)
+                send_frame_returned = mem_buf_len;
+        }
+
+        return send_frame_returned;
+    }
+
+    int net_interface_set::send_on(size_t netif_index, uint8_t *frame, uint16_t mem_buf_len)
+    {
+        // The frame is built with the source address of the first interface
+        utility::convert_uint64_to_eui48(netifs[netif_index]->mac_addr(), frame + DEST_MAC_SIZE);
+
+        return netifs[netif_index]->send_frame(frame, mem_buf_len);
+    }
+}
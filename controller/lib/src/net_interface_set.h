@@ -0,0 +1,128 @@
+/*
+ * Licensed under the MIT License (MIT)
+ *
+ * Copyright (c) 2014 AudioScience Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * net_interface_set.h
+ *
+ * The network interfaces served by the controller, and the interface each End Station is reached on.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+#include <mutex>
+#include <unordered_map>
+
+namespace avdecc_lib
+{
+    class net_interface_imp;
+
+    class net_interface_set
+    {
+    public:
+        net_interface_set();
+
+        ~net_interface_set();
+
+        /**
+         * Add an interface. The first one added is the one the controller was created with, which the
+         * Controller Entity ID is derived from.
+         *
+         * \return The index of the interface, or -1 if an interface with the same MAC address has been added.
+         */
+        int add(net_interface_imp *netif);
+
+        /**
+         * \return The number of interfaces.
+         */
+        inline size_t count() const
+        {
+            return netifs.size();
+        }
+
+        inline net_interface_imp *at(size_t netif_index) const
+        {
+            return netifs[netif_index];
+        }
+
+        /**
+         * \return True if the MAC address is the one of the interface.
+         */
+        bool is_local_mac(size_t netif_index, uint64_t mac) const;
+
+        /**
+         * Account for an ADP ENTITY_AVAILABLE received on an interface. An entity stays on the interface it
+         * was first seen on while it keeps advertising there, and moves to another interface once it has
+         * not been seen on its own for its valid time.
+         *
+         * \return True if the entity is new or has moved to this interface.
+         */
+        bool adp_event(uint64_t entity_id, size_t netif_index, uint32_t valid_time_ms);
+
+        /**
+         * \return The index of the interface the entity is reached on, or -1 if it has not been seen.
+         */
+        int entity_net_interface(uint64_t entity_id) const;
+
+        /**
+         * Forget the interface of an entity that has departed or timed out.
+         */
+        void remove_entity(uint64_t entity_id);
+
+        /**
+         * Remove every interface and entity, for when the controller they were added by is destroyed.
+         */
+        void clear();
+
+        /**
+         * Send a frame on the interface of the entity it is addressed to, or on every interface for
+         * ADP and entities that have not been seen. The source MAC address of the frame is set to the
+         * one of each interface it is sent on.
+         *
+         * \return The frame length on success or -1 on failure.
+         */
+        int send_frame(uint8_t *frame, uint16_t mem_buf_len);
+
+    private:
+        struct entity_affinity
+        {
+            size_t netif_index;
+            uint32_t last_seen; // Timer wheel tick of the last ADP from the entity on netif_index
+        };
+
+        std::vector<net_interface_imp *> netifs;
+        std::unordered_map<uint64_t, struct entity_affinity> affinities; // By Entity ID
+        mutable std::mutex affinity_lock; // Guards affinities, which every engine shard updates and sends with
+
+        /**
+         * \return The Entity ID a frame is addressed to, 0 for ADP and frames not addressed to an entity.
+         */
+        uint64_t target_entity_id(const uint8_t *frame, uint16_t mem_buf_len) const;
+
+        int send_on(size_t netif_index, uint8_t *frame, uint16_t mem_buf_len);
+    };
+
+    extern net_interface_set *net_interface_set_ref;
+}
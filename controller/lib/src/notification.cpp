@@ -39,48 +39,144 @@ namespace avdecc_lib
     notification::notification()
     {
         notifications = NO_MATCH_FOUND;
-        read_index = 0;
-        write_index = 0;
         notification_callback = default_notification;
         user_obj = NULL;
+        batch_callback = NULL;
+        batch_user_obj = NULL;
         missed_notification_event_cnt = 0;
+        is_capacity_fixed = false;
+        notification_ring = new mpsc_ring<struct notification_msg>(NOTIFICATION_BUF_COUNT);
     }
 
-    notification::~notification() {}
+    notification::~notification()
+    {
+        delete notification_ring;
+    }
 
     void notification::post_notification_msg(int32_t notification_type, uint64_t entity_id, uint16_t cmd_type, uint16_t desc_type, uint16_t desc_index, uint32_t cmd_status, void *notification_id)
     {
-        uint32_t index;
-
-        if((write_index - read_index) > NOTIFICATION_BUF_COUNT)
-        {
-            missed_notification_event_cnt++;
-            return;
-        }
+        struct notification_msg *msg;
 
         if(notification_type == NO_MATCH_FOUND || notification_type == END_STATION_CONNECTED ||
            notification_type == END_STATION_DISCONNECTED || notification_type == COMMAND_TIMEOUT ||
-           notification_type == RESPONSE_RECEIVED || notification_type == END_STATION_READ_COMPLETED)
+           notification_type == RESPONSE_RECEIVED || notification_type == END_STATION_READ_COMPLETED ||
+           notification_type == UNSOLICITED_RESPONSE_RECEIVED || notification_type == MEMORY_OBJECT_TRANSFER_PROGRESS ||
+           notification_type == MEMORY_OBJECT_TRANSFER_COMPLETED)
         {
-            index = InterlockedExchangeAdd(&write_index, 1);
-            notification_buf[index % NOTIFICATION_BUF_COUNT].notification_type = notification_type;
-            notification_buf[index % NOTIFICATION_BUF_COUNT].entity_id = entity_id;
-            notification_buf[index % NOTIFICATION_BUF_COUNT].cmd_type = cmd_type;
-            notification_buf[index % NOTIFICATION_BUF_COUNT].desc_type = desc_type;
-            notification_buf[index % NOTIFICATION_BUF_COUNT].desc_index = desc_index;
-            notification_buf[index % NOTIFICATION_BUF_COUNT].cmd_status = cmd_status;
-            notification_buf[index % NOTIFICATION_BUF_COUNT].notification_id = notification_id;
-
-            post_notification_event();
+            msg = notification_ring->reserve();
+            if(!msg)
+            {
+                missed_notification_event_cnt++;
+                return;
+            }
+
+            msg->notification_type = notification_type;
+            msg->entity_id = entity_id;
+            msg->cmd_type = cmd_type;
+            msg->desc_type = desc_type;
+            msg->desc_index = desc_index;
+            msg->cmd_status = cmd_status;
+            msg->notification_id = notification_id;
+
+            if(notification_ring->commit(msg))
+            {
+                post_notification_event();
+            }
         }
     }
 
+    void notification::dispatch_notifications()
+    {
+        struct notification_msg batch[NOTIFICATION_BATCH_COUNT];
+        struct notification_msg *msg;
+        uint32_t count;
+
+        do
+        {
+            for(;;)
+            {
+                void (*callback) (void *, int32_t, uint64_t, uint16_t, uint16_t, uint16_t, uint32_t, void *);
+                void *callback_user_obj;
+                void (*batch_cb) (void *, const struct notification_msg *, uint32_t);
+                void *batch_cb_user_obj;
+
+                count = 0;
+                while((count < NOTIFICATION_BATCH_COUNT) && ((msg = notification_ring->front()) != NULL))
+                {
+                    batch[count++] = *msg;
+                    notification_ring->pop();
+                }
+
+                if(count == 0)
+                {
+                    break;
+                }
+
+                {
+                    std::lock_guard<std::mutex> guard(callback_lock);
+                    callback = notification_callback;
+                    callback_user_obj = user_obj;
+                    batch_cb = batch_callback;
+                    batch_cb_user_obj = batch_user_obj;
+                }
+
+                if(batch_cb)
+                {
+                    batch_cb(batch_cb_user_obj, batch, count);
+                }
+                else
+                {
+                    for(uint32_t i = 0; i < count; i++)
+                    {
+                        callback(callback_user_obj,
+                                 batch[i].notification_type,
+                                 batch[i].entity_id,
+                                 batch[i].cmd_type,
+                                 batch[i].desc_type,
+                                 batch[i].desc_index,
+                                 batch[i].cmd_status,
+                                 batch[i].notification_id);
+                    }
+                }
+            }
+        } while(!notification_ring->arm_doorbell());
+    }
+
     void notification::set_notification_callback(void (*new_notification_callback) (void *, int32_t, uint64_t, uint16_t, uint16_t, uint16_t, uint32_t, void *), void *p)
     {
+        std::lock_guard<std::mutex> guard(callback_lock);
         notification_callback = new_notification_callback;
         user_obj = p;
     }
 
+    void notification::set_notification_batch_callback(void (*new_batch_callback) (void *, const struct notification_msg *, uint32_t), void *p)
+    {
+        std::lock_guard<std::mutex> guard(callback_lock);
+        batch_callback = new_batch_callback;
+        batch_user_obj = p;
+    }
+
+    int notification::set_notification_capacity(uint32_t count)
+    {
+        mpsc_ring<struct notification_msg> *old_ring = notification_ring;
+
+        // The engine threads post without a lock, so the ring may only be swapped before they run
+        if((count == 0) || is_capacity_fixed)
+        {
+            return -1;
+        }
+
+        notification_ring = new mpsc_ring<struct notification_msg>(count);
+        delete old_ring;
+
+        return 0;
+    }
+
+    void notification::fix_capacity()
+    {
+        is_capacity_fixed = true;
+    }
+
     uint32_t notification::missed_notification_event_count()
     {
         return missed_notification_event_cnt;
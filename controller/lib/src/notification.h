@@ -32,6 +32,10 @@
 
 
 #include <stdint.h>
+#include <atomic>
+#include <mutex>
+#include "controller.h"
+#include "mpsc_ring.h"
 
 namespace avdecc_lib
 {
@@ -40,7 +44,7 @@ namespace avdecc_lib
     public:
         notification();
 
-        ~notification();
+        virtual ~notification();
 
         /**
          * AVDECC LIB modules call this function to generate a notification message.
@@ -52,6 +56,23 @@ namespace avdecc_lib
          */
         void set_notification_callback(void (*new_notification_callback) (void *, int32_t, uint64_t, uint16_t, uint16_t, uint16_t, uint32_t, void *), void *);
 
+        /**
+         * Deliver notifications in batches through a callback taking an array of notification messages
+         * instead of one at a time. A NULL callback restores per notification delivery.
+         */
+        void set_notification_batch_callback(void (*new_batch_callback) (void *, const struct notification_msg *, uint32_t), void *);
+
+        /**
+         * Replace the notification ring with one of a different capacity. Only possible before the
+         * system layer is started, while nothing posts notifications.
+         */
+        int set_notification_capacity(uint32_t count);
+
+        /**
+         * Called by the system layer as it starts, after which the capacity can no longer be changed.
+         */
+        void fix_capacity();
+
         /**
          * Get the number of missed notifications that exceeds the notification buffer count.
          */
@@ -59,32 +80,31 @@ namespace avdecc_lib
 
 	protected:
         int32_t notifications;
-        uint32_t read_index;
-        uint32_t write_index;
         void (*notification_callback) (void *, int32_t, uint64_t, uint16_t, uint16_t, uint16_t, uint32_t, void *);
         void *user_obj;
-        uint32_t missed_notification_event_cnt;
+        void (*batch_callback) (void *, const struct notification_msg *, uint32_t);
+        void *batch_user_obj;
+        std::mutex callback_lock; // Keeps each callback and its user object consistent for the notification thread
+        std::atomic<uint32_t> missed_notification_event_cnt;
+        std::atomic<bool> is_capacity_fixed;
 
         enum
         {
-            NOTIFICATION_BUF_COUNT = 32
+            NOTIFICATION_BUF_COUNT = 1024,
+            NOTIFICATION_BATCH_COUNT = 64 // Maximum number of notifications handed to the callbacks per pass
         };
 
-        struct notification_data
-        {
-            int32_t notification_type;
-            uint64_t entity_id;
-            uint16_t cmd_type;
-            uint16_t desc_type;
-            uint16_t desc_index;
-            uint32_t cmd_status;
-            void *notification_id;
-        };
+        mpsc_ring<struct notification_msg> *notification_ring;
 
-        struct notification_data notification_buf[NOTIFICATION_BUF_COUNT];
+        /**
+         * Call the notification callbacks until the ring is drained. Called by the notification
+         * thread every time post_notification_event() wakes it up.
+         */
+        void dispatch_notifications();
 
         /**
-         * Release sempahore so that notification callback function is called.
+         * Release sempahore so that notification callback function is called. Called only when the
+         * ring goes from empty to non-empty, so one wakeup covers a whole batch of notifications.
          */
         virtual void post_notification_event() = 0;
 
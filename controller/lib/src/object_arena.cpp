@@ -0,0 +1,150 @@
+/*
+ * Licensed under the MIT License (MIT)
+ *
+ * Copyright (c) 2014 AudioScience Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * object_arena.cpp
+ *
+ * Object arena implementation
+ */
+
+#include <string.h>
+#include "object_arena.h"
+
+namespace avdecc_lib
+{
+    object_arena::object_arena() : block_used(BLOCK_SIZE), used_total(0), cleanups(NULL) {}
+
+    object_arena::~object_arena()
+    {
+        release();
+    }
+
+    void *object_arena::allocate(size_t len, size_t align)
+    {
+        uint8_t *p;
+        size_t start = (block_used + align - 1) & ~(align - 1);
+
+        for (size_t i = 0; i < free_list.size(); i++)
+        {
+            if ((free_list[i].len == len) && (((uintptr_t)free_list[i].p & (align - 1)) == 0))
+            {
+                p = static_cast<uint8_t *>(free_list[i].p);
+                free_list[i] = free_list.back();
+                free_list.pop_back();
+                return p;
+            }
+        }
+
+        if (len > BLOCK_SIZE / 4)
+        {
+            // Too large to share a block, keep it in its own block ahead of the current one
+            block large = {new uint8_t[len], len};
+
+            p = large.p;
+            blocks.insert(blocks.empty() ? blocks.end() : blocks.end() - 1, large);
+        }
+        else
+        {
+            if (start + len > BLOCK_SIZE)
+            {
+                block next = {new uint8_t[BLOCK_SIZE], BLOCK_SIZE};
+
+                blocks.push_back(next);
+                start = 0;
+            }
+
+            p = blocks.back().p + start;
+            block_used = start + len;
+        }
+
+        used_total += len;
+        return p;
+    }
+
+    uint8_t *object_arena::store(const uint8_t *desc, size_t desc_len)
+    {
+        uint8_t *p = static_cast<uint8_t *>(allocate(desc_len, 8)); // Keep payloads 8 byte aligned
+
+        memcpy(p, desc, desc_len);
+        return p;
+    }
+
+    void object_arena::unstore(const uint8_t *desc, size_t desc_len)
+    {
+        for (size_t i = 0; i < blocks.size(); i++)
+        {
+            if ((desc >= blocks[i].p) && (desc + desc_len <= blocks[i].p + blocks[i].len))
+            {
+                reclaim(const_cast<uint8_t *>(desc), desc_len);
+                return;
+            }
+        }
+    }
+
+    void object_arena::reclaim(void *p, size_t len)
+    {
+        free_space space = {p, len};
+
+        free_list.push_back(space);
+    }
+
+    void object_arena::destroy(void *obj)
+    {
+        cleanup **link = &cleanups;
+
+        while (*link && ((*link)->obj != obj))
+        {
+            link = &(*link)->next;
+        }
+
+        if (*link)
+        {
+            cleanup *c = *link;
+
+            *link = c->next;
+            c->destroy(c->obj);
+            reclaim(obj, c->len);
+            reclaim(c, sizeof(cleanup));
+        }
+    }
+
+    void object_arena::release()
+    {
+        while (cleanups)
+        {
+            cleanup *c = cleanups;
+            cleanups = c->next;
+            c->destroy(c->obj);
+        }
+
+        for (size_t i = 0; i < blocks.size(); i++)
+        {
+            delete[] blocks[i].p;
+        }
+
+        blocks.clear();
+        free_list.clear();
+        block_used = BLOCK_SIZE;
+        used_total = 0;
+    }
+}
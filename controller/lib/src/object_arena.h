@@ -0,0 +1,149 @@
+/*
+ * Licensed under the MIT License (MIT)
+ *
+ * Copyright (c) 2014 AudioScience Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * object_arena.h
+ *
+ * Arena owning the descriptor tree and raw descriptor payloads of an End Station.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace avdecc_lib
+{
+    /**
+     * Objects and raw READ_DESCRIPTOR payloads packed into large blocks. Everything allocated from the
+     * arena stays in place until release(), which runs the destructors of the objects, newest first,
+     * and frees the blocks in one go. Only a descriptor that is read again destroys its old object and
+     * payload early, and the space is reused by the next allocation of the same size.
+     */
+    class object_arena
+    {
+    public:
+        object_arena();
+
+        ~object_arena();
+
+        /**
+         * Construct an object in the arena. The object is destroyed by release() and must not be deleted.
+         */
+        template <class T, class... Args>
+        T *create(Args&&... args)
+        {
+            void *p = allocate(sizeof(T), alignof(T));
+            T *obj = new (p) T(std::forward<Args>(args)...);
+
+            // Registered once constructed, so an object whose constructor throws is never destroyed
+            cleanup *c = static_cast<cleanup *>(allocate(sizeof(cleanup), alignof(cleanup)));
+            c->destroy = &destroy_object<T>;
+            c->obj = obj;
+            c->len = sizeof(T);
+            c->next = cleanups;
+            cleanups = c;
+
+            return obj;
+        }
+
+        /**
+         * Copy a descriptor payload into the arena.
+         *
+         * \return The stored copy, valid until the arena is released.
+         */
+        uint8_t *store(const uint8_t *desc, size_t desc_len);
+
+        /**
+         * Give back the space of a payload copied by store(). A payload held elsewhere is left alone.
+         */
+        void unstore(const uint8_t *desc, size_t desc_len);
+
+        /**
+         * Destroy an object made by create() before the arena is released.
+         *
+         * \param obj The object, as a pointer to the type it was created with.
+         */
+        void destroy(void *obj);
+
+        /**
+         * Destroy every object and free every block at once.
+         */
+        void release();
+
+        /**
+         * \return The number of bytes allocated from the arena.
+         */
+        inline size_t size() const
+        {
+            return used_total;
+        }
+
+    private:
+        enum
+        {
+            BLOCK_SIZE = 16384
+        };
+
+        struct cleanup
+        {
+            void (*destroy)(void *obj);
+            void *obj;
+            size_t len; // Size of the object, for reusing its space once destroyed
+            cleanup *next;
+        };
+
+        struct block
+        {
+            uint8_t *p;
+            size_t len;
+        };
+
+        struct free_space
+        {
+            void *p;
+            size_t len;
+        };
+
+        template <class T>
+        static void destroy_object(void *obj)
+        {
+            static_cast<T *>(obj)->~T();
+        }
+
+        void *allocate(size_t len, size_t align);
+        void reclaim(void *p, size_t len); ///< Keep the space for the next allocation of the same size
+
+        std::vector<block> blocks;
+        size_t block_used; // Bytes used in the last block
+        size_t used_total;
+        cleanup *cleanups; // Objects to destroy on release, newest first
+        std::vector<free_space> free_list; // Space of objects destroyed before release
+
+        object_arena(const object_arena &);
+        object_arena &operator=(const object_arena &);
+    };
+}
@@ -38,12 +38,13 @@ namespace avdecc_lib
 
     log_imp::log_imp()
     {
+        dispatch_stop = false;
         logging_thread_init(); // Start log thread
     }
 
     log_imp::~log_imp()
     {
-        /* posting to sem without data causes the thread to terminate */
+        dispatch_stop = true;
         post_log_event();
         sem_unlink("/log_waiting_sem");
     }
@@ -90,19 +91,12 @@ namespace avdecc_lib
                 perror("sem_wait");
             }
 
-            if((write_index - read_index) > 0)
-            {
-                callback_func(user_obj,
-                              log_buf[read_index % LOG_BUF_COUNT].level,
-                              log_buf[read_index % LOG_BUF_COUNT].msg,
-                              log_buf[read_index % LOG_BUF_COUNT].time_stamp_ms
-                             );
-                read_index++;
-            }
-            else
+            if (dispatch_stop)
             {
                 break;
             }
+
+            dispatch_log_records();
         }
 
         return 0;
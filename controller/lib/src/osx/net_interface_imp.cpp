@@ -208,7 +208,7 @@ namespace avdecc_lib
         char mac_str[20];
         snprintf(mac_str, (size_t)20, "%02x:%02x:%02x:%02x:%02x:%02x", *ptr, *(ptr+1), *(ptr+2),
                  *(ptr+3), *(ptr+4), *(ptr+5));
-        log_imp_ref->post_log_msg(LOGGING_LEVEL_DEBUG, mac_str);
+        log_imp_ref->post_log_msg(LOGGING_LEVEL_DEBUG, "%s", mac_str);
 
         uint16_t ether_type[1];
         ether_type[0] = JDKSAVDECC_AVTP_ETHERTYPE;
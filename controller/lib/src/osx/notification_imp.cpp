@@ -44,11 +44,13 @@ namespace avdecc_lib
 
     notification_imp::notification_imp()
     {
+        dispatch_stop = false;
         notification_thread_init(); // Start notification thread
     }
 
     notification_imp::~notification_imp()
     {
+        dispatch_stop = true;
         post_notification_event();
         sem_unlink("/notify_waiting_sem");
     }
@@ -84,29 +86,16 @@ namespace avdecc_lib
 
     void * notification_imp::dispatch_callbacks(void)
     {
-        int status;
-
         while (true)
         {
-            status = sem_wait(notify_waiting);
+            sem_wait(notify_waiting);
 
-            if((write_index - read_index) > 0)
-            {
-                notification_callback(user_obj,
-                                      notification_buf[read_index % NOTIFICATION_BUF_COUNT].notification_type,
-                                      notification_buf[read_index % NOTIFICATION_BUF_COUNT].entity_id,
-                                      notification_buf[read_index % NOTIFICATION_BUF_COUNT].cmd_type,
-                                      notification_buf[read_index % NOTIFICATION_BUF_COUNT].desc_type,
-                                      notification_buf[read_index % NOTIFICATION_BUF_COUNT].desc_index,
-                                      notification_buf[read_index % NOTIFICATION_BUF_COUNT].cmd_status,
-                                      notification_buf[read_index % NOTIFICATION_BUF_COUNT].notification_id
-                                     );
-                read_index++;
-            }
-            else
+            if (dispatch_stop)
             {
                 break;
             }
+
+            dispatch_notifications();
         }
 
         return 0;
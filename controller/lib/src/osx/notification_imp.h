@@ -39,6 +39,7 @@ namespace avdecc_lib
     {
     private:
         pthread_t h_thread;
+        volatile bool dispatch_stop; // Set by the destructor to end the dispatch thread
         sem_t *notify_waiting;
 
     public:
@@ -52,6 +52,7 @@
 #include <vector>
 
 #include "net_interface_imp.h"
+#include "net_interface_set.h"
 #include "enumeration.h"
 #include "notification_imp.h"
 #include "log_imp.h"
@@ -98,13 +99,11 @@ namespace avdecc_lib
         controller_ref_in_system = dynamic_cast<controller_imp *>(controller_obj);
         pipe(tx_pipe);
 
-        wait_mgr = new cmd_wait_mgr();
+        completions = new cmd_completion_table();
 
-        sem_unlink("/waiting_sem");
         sem_unlink("/shutdown_sem");
 
-        if (((waiting_sem = sem_open("/waiting_sem", O_CREAT | O_EXCL, 0644, 0)) == SEM_FAILED) ||
-            ((shutdown_sem = sem_open("/shutdown_sem", O_CREAT | O_EXCL, 0644, 0)) == SEM_FAILED))
+        if ((shutdown_sem = sem_open("/shutdown_sem", O_CREAT | O_EXCL, 0644, 0)) == SEM_FAILED)
         {
             perror("sem_open");
             exit(-1);
@@ -113,7 +112,7 @@ namespace avdecc_lib
 
     system_layer2_multithreaded_callback::~system_layer2_multithreaded_callback()
     {
-        sem_unlink("/waiting_sem");
+        delete completions;
         sem_unlink("/shutdown_sem");
     }
 
@@ -152,40 +151,43 @@ namespace avdecc_lib
         memcpy(t.frame, frame, mem_buf_len);
         t.notification_id = notification_id;
         t.notification_flag = notification_flag;
-        write(tx_pipe[PIPE_WR], &t, sizeof(t));
+        // Mark the command as sent before the poll thread can see it, so that its response cannot be missed
+        cmd_completion_imp *primed = completions->cmd_queued(notification_id, notification_flag);
 
-        /**
-         * Check for conditions that cause wait for completion.
-         */
-        if ( wait_mgr->primed_state() &&
-             wait_mgr->match_id(notification_id) &&
-             (notification_flag == CMD_WITH_NOTIFICATION))
-        {
-            int status = 0;
+        write(tx_pipe[PIPE_WR], &t, sizeof(t));
 
-            status = wait_mgr->set_active_state();
-            assert(status == 0);
-            if (sem_wait(waiting_sem) != 0)
-            {
-                perror("sem_wait");
-            }
-            resp_status_for_cmd = wait_mgr->get_completion_status();
-            status = wait_mgr->set_idle_state();
-            assert(status == 0);
-        }
+        // Block until the command completes if the calling thread primed it with set_wait_for_next_cmd
+        if (primed)
+            completions->wait_for_primed(primed);
 
         return 0;
     }
 
     int STDCALL system_layer2_multithreaded_callback::set_wait_for_next_cmd(void * id)
     {
-        wait_mgr->set_primed_state(id);
+        completions->set_wait_for_next_cmd(id);
         return 0;
     }
 
     int STDCALL system_layer2_multithreaded_callback::get_last_resp_status()
     {
-        return resp_status_for_cmd;
+        return completions->get_last_resp_status();
+    }
+
+    cmd_completion * STDCALL system_layer2_multithreaded_callback::create_cmd_completion(void *notification_id)
+    {
+        return completions->create(notification_id);
+    }
+
+    int STDCALL system_layer2_multithreaded_callback::set_engine_shard_count(uint32_t count)
+    {
+        if (count != 1)
+        {
+            log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "Only one engine shard is supported on this platform");
+            return -1;
+        }
+
+        return 0;
     }
 
     int system_layer2_multithreaded_callback::fn_timer_cb(struct kevent *priv)
@@ -204,30 +206,32 @@ namespace avdecc_lib
 
     int system_layer2_multithreaded_callback::fn_timer(struct kevent *priv)
     {
-        bool notification_id_incomplete = false;
-
-        if (wait_mgr->active_state())
+        // Commands with completions that are inflight before the timer tick update and no longer
+        // inflight after it have been timed out, so complete them.
+        tick_active_ids.clear();
+        if (completions->has_active())
         {
-            if (controller_ref_in_system->is_inflight_cmd_with_notification_id(wait_mgr->get_notify_id()) ||
-                controller_ref_in_system->is_active_operation_with_notification_id(wait_mgr->get_notify_id()))
-                notification_id_incomplete = true;
-        }
+            size_t inflight_count = 0;
 
-        // If waiting on a command to complete and the command was "inflight" prior to calling the
-        // timer tick update (ie notification_id_incomplete == true) AND after calling the timer tick
-        // update the command is no longer "inflight", timeout processing has removed it, so signal the
-        // waiting app thread.
+            completions->get_active_ids(tick_active_ids);
+            for (size_t i = 0; i < tick_active_ids.size(); i++)
+            {
+                if (controller_ref_in_system->is_inflight_cmd_with_notification_id(tick_active_ids[i]) ||
+                    controller_ref_in_system->is_active_operation_with_notification_id(tick_active_ids[i]))
+                    tick_active_ids[inflight_count++] = tick_active_ids[i];
+            }
+            tick_active_ids.resize(inflight_count);
+        }
 
         controller_ref_in_system->time_tick_event();
 
-        bool is_timeout_for_waiting_notify_id = wait_mgr->active_state() && notification_id_incomplete &&
-                                                !controller_ref_in_system->is_inflight_cmd_with_notification_id(wait_mgr->get_notify_id()) &&
-                                                !controller_ref_in_system->is_active_operation_with_notification_id(wait_mgr->get_notify_id());
-        if (is_timeout_for_waiting_notify_id)
+        for (size_t i = 0; i < tick_active_ids.size(); i++)
         {
-            int status = wait_mgr->set_completion_status(AVDECC_LIB_STATUS_TICK_TIMEOUT);
-            assert(status == 0);
-            sem_post(waiting_sem);
+            if (!controller_ref_in_system->is_inflight_cmd_with_notification_id(tick_active_ids[i]) &&
+                !controller_ref_in_system->is_active_operation_with_notification_id(tick_active_ids[i]))
+            {
+                completions->complete(tick_active_ids[i], controller_ref_in_system->tick_completion_status(tick_active_ids[i]));
+            }
         }
 
         return 0;
@@ -276,19 +280,17 @@ namespace avdecc_lib
                                                       length,
                                                       rx_status,
                                                       operation_id,
-                                                      is_operation_id_valid);
+                                                      is_operation_id_valid,
+                                                      0);
 
             if (
-                wait_mgr->active_state() &&
                 is_notification_id_valid &&
-                wait_mgr->match_id(notification_id) &&
-                !controller_ref_in_system->is_inflight_cmd_with_notification_id(wait_mgr->get_notify_id()) &&
-                !controller_ref_in_system->is_active_operation_with_notification_id(wait_mgr->get_notify_id())
+                completions->has_active() &&
+                !controller_ref_in_system->is_inflight_cmd_with_notification_id(notification_id) &&
+                !controller_ref_in_system->is_active_operation_with_notification_id(notification_id)
             )
             {
-                int status = wait_mgr->set_completion_status(rx_status);
-                assert(status == 0);
-                sem_post(waiting_sem);
+                completions->complete(notification_id, rx_status);
             }
         }
         return 0;
@@ -365,6 +367,12 @@ namespace avdecc_lib
     {
         int rc;
 
+        if (net_interface_set_ref->count() > 1)
+        {
+            log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "Only the first network interface is received on");
+        }
+
+        notification_imp_ref->fix_capacity();
         rc = pthread_create(&h_thread, NULL, &system_layer2_multithreaded_callback::thread_fn, (void *)this);
         if (rc)
         {
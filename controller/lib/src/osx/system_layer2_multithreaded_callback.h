@@ -31,7 +31,8 @@
 
 #include "avdecc_lib_os.h"
 #include "system.h"
-#include "cmd_wait_mgr.h"
+#include <vector>
+#include "cmd_completion_imp.h"
 
 namespace avdecc_lib
 {
@@ -71,6 +72,16 @@ namespace avdecc_lib
          */
         int STDCALL get_last_resp_status();
 
+        /**
+         * Create a completion token for the next command sent with the notification id.
+         */
+        cmd_completion * STDCALL create_cmd_completion(void *notification_id);
+
+        /**
+         * Only one engine shard is supported on this platform.
+         */
+        int STDCALL set_engine_shard_count(uint32_t count);
+
         /**
          * Start point of the system process, which calls the thread initialization function.
          */
@@ -108,7 +119,6 @@ namespace avdecc_lib
         int tx_pipe[2];
         //int tick_timer;
 
-        sem_t *waiting_sem;
         sem_t *shutdown_sem;
 
         /*
@@ -118,8 +128,8 @@ namespace avdecc_lib
         Timer tick - from timer
         */
 
-        cmd_wait_mgr *wait_mgr;
-        int resp_status_for_cmd;
+        cmd_completion_table *completions; // Commands application threads are waiting on
+        std::vector<void *> tick_active_ids; // Commands with completions inflight before a timer tick
         int prep_evt_desc(int fd, handler_fn fn, struct epoll_priv *priv, struct epoll_event *ev);
         static int fn_timer_cb(struct kevent *priv);
         static int fn_netif_cb(struct kevent *priv);
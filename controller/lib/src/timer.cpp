@@ -92,12 +92,25 @@ namespace avdecc_lib
 
         return (uint32_t)((time_stamp * 1000/freq.QuadPart) & 0xfffffff);
     }
+
+    avdecc_lib_os::aTimestamp timer::clk_convert_from_ms(uint32_t ms)
+    {
+        LARGE_INTEGER freq;
+        QueryPerformanceFrequency(&freq);
+
+        return (avdecc_lib_os::aTimestamp)ms * freq.QuadPart / 1000;
+    }
 #elif defined __linux__ || defined __MACH__
     uint32_t timer::clk_convert_to_ms(avdecc_lib_os::aTimestamp time_stamp)
     {
         return time_stamp;
 
     }
+
+    avdecc_lib_os::aTimestamp timer::clk_convert_from_ms(uint32_t ms)
+    {
+        return ms;
+    }
 #endif
 
     void timer::start(int duration_ms)
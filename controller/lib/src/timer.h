@@ -52,6 +52,8 @@ namespace avdecc_lib
 
         uint32_t clk_convert_to_ms(avdecc_lib_os::aTimestamp timestamp);
 
+        avdecc_lib_os::aTimestamp clk_convert_from_ms(uint32_t ms);
+
         void start(int duration_ms);
 
         void stop();
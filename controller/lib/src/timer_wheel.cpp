@@ -0,0 +1,233 @@
+/*
+ * Licensed under the MIT License (MIT)
+ *
+ * Copyright (c) 2014 AudioScience Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * timer_wheel.cpp
+ *
+ * Hierarchical timing wheel implementation
+ */
+
+#include "timer_wheel.h"
+
+namespace avdecc_lib
+{
+    timer_wheel_entry::timer_wheel_entry() : prev(this), next(this), wheel(NULL), expires(0), handler(NULL), context(NULL) {}
+
+    timer_wheel_entry::timer_wheel_entry(const timer_wheel_entry &other) : prev(this), next(this), wheel(NULL), expires(0), handler(NULL), context(NULL) {}
+
+    timer_wheel_entry::~timer_wheel_entry()
+    {
+        cancel();
+    }
+
+    timer_wheel_entry & timer_wheel_entry::operator=(const timer_wheel_entry &other)
+    {
+        cancel();
+        return *this;
+    }
+
+    void timer_wheel_entry::cancel()
+    {
+        if (wheel)
+            wheel->cancel(this);
+    }
+
+    timer_wheel::timer_wheel()
+    {
+        current_tick = 0;
+        pending = 0;
+        last_clock = clock.clk_monotonic();
+    }
+
+    timer_wheel::~timer_wheel() {}
+
+    uint32_t timer_wheel::now()
+    {
+        return current_tick + clock.clk_convert_to_ms(clock.clk_monotonic() - last_clock);
+    }
+
+    void timer_wheel::add(timer_wheel_entry *entry)
+    {
+        int32_t delta = (int32_t)(entry->expires - current_tick);
+        timer_wheel_entry *head;
+        int level = 0;
+
+        if (delta < 0)
+        {
+            entry->expires = current_tick; // Already due, run on the next tick
+            delta = 0;
+        }
+        else if (delta > MAX_TIMEOUT_MS)
+        {
+            entry->expires = current_tick + MAX_TIMEOUT_MS;
+            delta = MAX_TIMEOUT_MS;
+        }
+
+        while ((level < LEVEL_COUNT - 1) && (delta >= (1 << (LEVEL_BITS * (level + 1)))))
+            level++;
+
+        head = &slots[level][(entry->expires >> (LEVEL_BITS * level)) & LEVEL_MASK];
+
+        entry->prev = head->prev;
+        entry->next = head;
+        head->prev->next = entry;
+        head->prev = entry;
+    }
+
+    void timer_wheel::schedule(timer_wheel_entry *entry, uint32_t timeout_ms, timer_wheel_entry::handler_fn handler, void *context)
+    {
+        if (entry->wheel)
+            cancel(entry);
+
+        entry->expires = now() + timeout_ms;
+        entry->handler = handler;
+        entry->context = context;
+        entry->wheel = this;
+        pending++;
+
+        add(entry);
+    }
+
+    void timer_wheel::cancel(timer_wheel_entry *entry)
+    {
+        if (entry->wheel != this)
+            return;
+
+        entry->prev->next = entry->next;
+        entry->next->prev = entry->prev;
+        entry->prev = entry;
+        entry->next = entry;
+        entry->wheel = NULL;
+        pending--;
+    }
+
+    void timer_wheel::cascade(int level)
+    {
+        timer_wheel_entry *head = &slots[level][(current_tick >> (LEVEL_BITS * level)) & LEVEL_MASK];
+        timer_wheel_entry *entry = head->next;
+
+        head->prev = head;
+        head->next = head;
+
+        while (entry != head)
+        {
+            timer_wheel_entry *next = entry->next;
+            add(entry);
+            entry = next;
+        }
+    }
+
+    void timer_wheel::run()
+    {
+        avdecc_lib_os::aTimestamp current_clock = clock.clk_monotonic();
+        uint32_t elapsed_ms = clock.clk_convert_to_ms(current_clock - last_clock);
+        uint32_t target_tick;
+
+        // Only whole milliseconds are consumed, the remainder carries over to the next run
+        last_clock += clock.clk_convert_from_ms(elapsed_ms);
+        target_tick = current_tick + elapsed_ms;
+
+        while ((int32_t)(target_tick - current_tick) >= 0)
+        {
+            timer_wheel_entry expired;
+            timer_wheel_entry *head;
+            uint32_t index = current_tick & LEVEL_MASK;
+
+            if (pending == 0)
+            {
+                current_tick = target_tick + 1;
+                break;
+            }
+
+            /* Pull the entries of the next slot of each higher level down when a lower level wraps */
+            for (int level = 1; (level < LEVEL_COUNT) && (((current_tick >> (LEVEL_BITS * (level - 1))) & LEVEL_MASK) == 0); level++)
+                cascade(level);
+
+            head = &slots[0][index];
+            current_tick++;
+
+            if (head->next == head)
+                continue;
+
+            /* Move the expired entries onto a local list so that handlers can schedule and cancel freely */
+            expired.next = head->next;
+            expired.prev = head->prev;
+            expired.next->prev = &expired;
+            expired.prev->next = &expired;
+            head->next = head;
+            head->prev = head;
+
+            while (expired.next != &expired)
+            {
+                timer_wheel_entry *entry = expired.next;
+
+                cancel(entry);
+                entry->handler(entry->context);
+            }
+        }
+    }
+
+    bool timer_wheel::next_expiry(uint32_t &expiry_tick)
+    {
+        bool found = false;
+
+        if (pending == 0)
+            return false;
+
+        /* Entries on the first level expire exactly at the tick of their slot */
+        for (uint32_t i = 0; i < LEVEL_SIZE; i++)
+        {
+            timer_wheel_entry *head = &slots[0][(current_tick + i) & LEVEL_MASK];
+
+            if (head->next != head)
+            {
+                expiry_tick = current_tick + i;
+                return true;
+            }
+        }
+
+        /* Higher level slots are due when they are cascaded */
+        for (int level = 1; level < LEVEL_COUNT; level++)
+        {
+            int shift = LEVEL_BITS * level;
+            uint32_t level_tick = current_tick >> shift;
+
+            for (uint32_t d = 1; d <= LEVEL_SIZE; d++)
+            {
+                timer_wheel_entry *head = &slots[level][(level_tick + d) & LEVEL_MASK];
+
+                if (head->next != head)
+                {
+                    uint32_t cascade_tick = (level_tick + d) << shift;
+
+                    if (!found || (int32_t)(cascade_tick - expiry_tick) < 0)
+                        expiry_tick = cascade_tick;
+                    found = true;
+                    break;
+                }
+            }
+        }
+
+        return found;
+    }
+}
@@ -0,0 +1,149 @@
+/*
+ * Licensed under the MIT License (MIT)
+ *
+ * Copyright (c) 2014 AudioScience Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * timer_wheel.h
+ *
+ * Hierarchical timing wheel used by the engine thread for all protocol timeouts.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+#include "avdecc_lib_os.h"
+#include "timer.h"
+
+namespace avdecc_lib
+{
+    class timer_wheel;
+
+    /**
+     * A timer that is embedded in the object it times out. The entry must stay at the same
+     * address while it is scheduled. Copying an entry yields an entry that is not scheduled.
+     */
+    class timer_wheel_entry
+    {
+    public:
+        typedef void (*handler_fn)(void *context);
+
+        timer_wheel_entry();
+
+        timer_wheel_entry(const timer_wheel_entry &other);
+
+        ~timer_wheel_entry();
+
+        timer_wheel_entry & operator=(const timer_wheel_entry &other);
+
+        /**
+         * \return True if the entry is scheduled and its handler has not been called yet.
+         */
+        inline bool is_pending() const
+        {
+            return wheel != NULL;
+        }
+
+        /**
+         * Remove the entry from the wheel without calling its handler.
+         */
+        void cancel();
+
+    private:
+        friend class timer_wheel;
+
+        timer_wheel_entry *prev;
+        timer_wheel_entry *next;
+        timer_wheel *wheel; // The wheel the entry is scheduled on, NULL when idle
+        uint32_t expires; // Wheel tick at which the entry expires
+        handler_fn handler;
+        void *context;
+    };
+
+    class timer_wheel
+    {
+    public:
+        timer_wheel();
+
+        ~timer_wheel();
+
+        /**
+         * Schedule or reschedule an entry. The handler is called with the context from run() once
+         * timeout_ms milliseconds have elapsed, with the entry already removed from the wheel.
+         */
+        void schedule(timer_wheel_entry *entry, uint32_t timeout_ms, timer_wheel_entry::handler_fn handler, void *context);
+
+        /**
+         * Remove a scheduled entry without calling its handler.
+         */
+        void cancel(timer_wheel_entry *entry);
+
+        /**
+         * Advance the wheel to the current time and call the handlers of all expired entries.
+         * The cost is proportional to the number of expired entries, not to the number scheduled.
+         */
+        void run();
+
+        /**
+         * \return The current time in wheel ticks (milliseconds).
+         */
+        uint32_t now();
+
+        /**
+         * Find the tick by which run() needs to be called next. This is the exact expiry of the
+         * earliest entry when it is within the first level of the wheel, otherwise the tick at
+         * which its slot is cascaded down, which is never later than the entry expiry.
+         *
+         * \return False if nothing is scheduled.
+         */
+        bool next_expiry(uint32_t &expiry_tick);
+
+        /**
+         * \return The number of scheduled entries.
+         */
+        inline size_t pending_count() const
+        {
+            return pending;
+        }
+
+    private:
+        enum timer_wheel_consts
+        {
+            LEVEL_BITS = 6,
+            LEVEL_SIZE = 1 << LEVEL_BITS,
+            LEVEL_MASK = LEVEL_SIZE - 1,
+            LEVEL_COUNT = 4,
+            MAX_TIMEOUT_MS = (1 << (LEVEL_BITS * LEVEL_COUNT)) - 1 // About 4.6 hours
+        };
+
+        timer_wheel_entry slots[LEVEL_COUNT][LEVEL_SIZE]; // List heads, each slot is a circular list
+        uint32_t current_tick; // The next tick to be processed
+        avdecc_lib_os::aTimestamp last_clock;
+        timer clock;
+        size_t pending;
+
+        void add(timer_wheel_entry *entry);
+        void cascade(int level);
+    };
+
+    extern thread_local timer_wheel *timer_wheel_ref; // The timer wheel of the engine shard of the calling thread
+}
@@ -224,7 +224,10 @@ namespace avdecc_lib
             "END_STATION_DISCONNECTED",
             "COMMAND_TIMEOUT",
             "RESPONSE_RECEIVED",
-            "END_STATION_READ_COMPLETED"
+            "END_STATION_READ_COMPLETED",
+            "UNSOLICITED_RESPONSE_RECEIVED",
+            "MEMORY_OBJECT_TRANSFER_PROGRESS",
+            "MEMORY_OBJECT_TRANSFER_COMPLETED"
         };
 
         const char *logging_level_names[] =
@@ -344,6 +347,10 @@ namespace avdecc_lib
             {
                 return "AVDECC_LIB_STATUS_TICK_TIMEOUT";
             }
+            else if(aem_cmd_status_value == avdecc_lib::AVDECC_LIB_STATUS_CRC_MISMATCH)
+            {
+                return "AVDECC_LIB_STATUS_CRC_MISMATCH";
+            }
 
             return "UNKNOWN";
         }
@@ -487,5 +494,33 @@ namespace avdecc_lib
             }
         }
 
+        uint32_t STDCALL crc32(uint32_t crc, const uint8_t *data, size_t len)
+        {
+            static const struct crc32_table
+            {
+                uint32_t entries[256];
+
+                crc32_table()
+                {
+                    for(uint32_t i = 0; i < 256; i++)
+                    {
+                        uint32_t c = i;
+                        for(int k = 0; k < 8; k++)
+                        {
+                            c = (c & 1) ? (0xEDB88320 ^ (c >> 1)) : (c >> 1);
+                        }
+                        entries[i] = c;
+                    }
+                }
+            } table;
+
+            crc = ~crc;
+            for(size_t i = 0; i < len; i++)
+            {
+                crc = table.entries[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+            }
+
+            return ~crc;
+        }
     }
 }
\ No newline at end of file